@@ -0,0 +1,154 @@
+//
+//  File: Aad.cpp
+//  Project: ExactPricingModels
+//  Objective: Tape-based adjoint algorithmic differentiation (reverse mode)
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "Aad.hpp"
+#include "cmath"
+
+#include <stdexcept>
+
+static thread_local AadTape* active_tape = nullptr; // Tape recording the calling thread's operations
+
+AadTape::~AadTape() {
+    /*
+     Destructor
+     */
+    Deactivate();
+}
+
+AadTape* AadTape::Active() {
+    return active_tape;
+}
+
+void AadTape::Activate() {
+    /*
+     Make this tape the calling thread's active tape, remembering the one it replaces so that a
+     valuation can record on its own tape while a caller's tape is active
+     */
+    if (active_tape == this) return;
+    m_previous = active_tape;
+    active_tape = this;
+}
+
+void AadTape::Deactivate() {
+    /*
+     Restore the tape that was active before Activate. Tapes are deactivated in the reverse
+     order of activation; a tape that is not the active one is left alone
+     */
+    if (active_tape != this) return;
+    active_tape = m_previous;
+    m_previous = nullptr;
+}
+
+void AadTape::Clear() {
+    m_nodes.clear();
+}
+
+void AadTape::Reserve(size_t nodes) {
+    m_nodes.reserve(nodes);
+    m_adjoints.reserve(nodes);
+}
+
+void AadTape::Reverse(size_t output, double seed) {
+    /*
+     Reverse sweep: every node passes its adjoint times its partials on to its arguments,
+     from the output back to the first node. Nodes recorded after the output are ignored
+     input:
+        tape index of the output, adjoint of the output (1 for a gradient, a position size for a weighted sum)
+     */
+
+    m_adjoints.assign(m_nodes.size(), 0.0);
+
+    if (output == AAD_CONSTANT) return;
+
+    m_adjoints[output] = seed;
+
+    for (size_t index = output + 1; index-- > 0;) {
+
+        double adjoint = m_adjoints[index];
+
+        if (adjoint == 0) continue;
+
+        const Node& node = m_nodes[index];
+
+        if (node.argument[0] != AAD_CONSTANT) m_adjoints[node.argument[0]] += adjoint * node.partial[0];
+        if (node.argument[1] != AAD_CONSTANT) m_adjoints[node.argument[1]] += adjoint * node.partial[1];
+    }
+}
+
+AadNumber AadNumber::Input(double value) {
+    /*
+     Independent variable: a node without arguments on the active tape
+     */
+
+    AadTape* tape = AadTape::Active();
+
+    if (!tape) throw std::logic_error("AadNumber::Input: no active tape on this thread");
+
+    return AadNumber(value, tape->Record(AAD_CONSTANT, 0.0));
+}
+
+AadNumber& AadNumber::operator += (const AadNumber& other) {
+    return *this = *this + other;
+}
+
+AadNumber& AadNumber::operator -= (const AadNumber& other) {
+    return *this = *this - other;
+}
+
+AadNumber& AadNumber::operator *= (const AadNumber& other) {
+    return *this = *this * other;
+}
+
+AadNumber& AadNumber::operator /= (const AadNumber& other) {
+    return *this = *this / other;
+}
+
+AadNumber Unary(const AadNumber& x, double value, double partial) {
+    /*
+     Result of a function of one number. Constants stay off the tape
+     */
+
+    if (x.Index() == AAD_CONSTANT) return AadNumber(value);
+
+    return AadNumber(value, AadTape::Active()->Record(x.Index(), partial));
+}
+
+AadNumber Binary(const AadNumber& x, const AadNumber& y, double value, double x_partial, double y_partial) {
+    /*
+     Result of a function of two numbers. Constant arguments are dropped from the node
+     */
+
+    if (x.Index() == AAD_CONSTANT) return Unary(y, value, y_partial);
+
+    if (y.Index() == AAD_CONSTANT) return Unary(x, value, x_partial);
+
+    return AadNumber(value, AadTape::Active()->Record(x.Index(), x_partial, y.Index(), y_partial));
+}
+
+AadNumber exp(const AadNumber& x) {
+    double value = std::exp(x.Value());
+    return Unary(x, value, value);
+}
+
+AadNumber log(const AadNumber& x) {
+    return Unary(x, std::log(x.Value()), 1.0 / x.Value());
+}
+
+AadNumber sqrt(const AadNumber& x) {
+    double value = std::sqrt(x.Value());
+    return Unary(x, value, 0.5 / value);
+}
+
+AadNumber NormalCdf(const AadNumber& x) {
+    return Unary(x, NormalCdf(x.Value()), NormalPdf(x.Value()));
+}
+
+AadNumber NormalPdf(const AadNumber& x) {
+    double value = NormalPdf(x.Value());
+    return Unary(x, value, -x.Value() * value);
+}
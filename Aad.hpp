@@ -0,0 +1,194 @@
+//
+//  File: Aad.hpp
+//  Project: ExactPricingModels
+//  Objective: Tape-based adjoint algorithmic differentiation (reverse mode)
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef Aad_hpp
+#define Aad_hpp
+
+#include <stdio.h>
+#include <stddef.h>
+#include <vector>
+
+#include "NormalMath.hpp"
+
+const size_t AAD_CONSTANT = static_cast<size_t>(-1); // Tape index of a value that does not depend on any input
+
+class AadTape {
+    /*
+     Records every operation on AadNumber values as a node holding the partial derivatives with
+     respect to its (at most two) arguments. Reverse() then propagates adjoints from an output back
+     to every node in one sweep, so the gradient of a scalar with respect to all of its inputs costs
+     a small constant multiple of the forward evaluation. Numbers record on the active tape of
+     their thread; Clear() keeps the capacity so a tape reused per valuation does not allocate
+     */
+
+    struct Node {
+        size_t argument[2]; // Tape indices of the arguments, AAD_CONSTANT when unused
+        double partial[2]; // d(node)/d(argument)
+    };
+
+    // Attributes
+    std::vector<Node> m_nodes; // Operations in evaluation order
+    std::vector<double> m_adjoints; // d(output)/d(node), filled by Reverse
+    AadTape* m_previous = nullptr; // Tape active on the thread before Activate, restored by Deactivate
+
+public:
+    /* CANONICAL HEADER START */
+    AadTape(){} // Default constructor
+
+    AadTape(const AadTape& other_tape) = delete; // Not copyable
+
+    virtual ~AadTape(); // Destructor. Deactivates the tape if it is active, restoring the previous one
+
+    AadTape& operator = (const AadTape& other_tape) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Size() const {
+        return m_nodes.size();
+    }
+
+    double Adjoint(size_t index) const {
+        // d(output)/d(node) after Reverse, 0 for constants
+        return index == AAD_CONSTANT ? 0 : m_adjoints[index];
+    }
+
+    static AadTape* Active(); // Tape of the calling thread, nullptr if none
+
+    /* GETTERS END */
+
+    void Activate(); // Record the calling thread's operations on this tape until Deactivate. Tapes nest: the active one is saved
+
+    void Deactivate(); // Stop recording on this tape and make the tape active before Activate current again
+
+    void Clear(); // Forget every node, keeping the memory
+
+    void Reserve(size_t nodes); // Preallocate nodes
+
+    size_t Record(size_t argument, double partial) {
+        // Unary operation
+        m_nodes.push_back({{argument, AAD_CONSTANT}, {partial, 0}});
+        return m_nodes.size() - 1;
+    }
+
+    size_t Record(size_t first, double first_partial, size_t second, double second_partial) {
+        // Binary operation
+        m_nodes.push_back({{first, second}, {first_partial, second_partial}});
+        return m_nodes.size() - 1;
+    }
+
+    void Reverse(size_t output, double seed = 1.0); // Adjoints of every node, with d(output)/d(output) = seed
+
+};
+
+class AadNumber {
+    /*
+     A double that records the operations applied to it on the active tape. Inputs are created
+     with Input(); numbers built from a plain double are constants and record nothing
+     */
+
+    // Attributes
+    double m_value = 0; // Value
+    size_t m_index = AAD_CONSTANT; // Node on the active tape
+
+public:
+    /* CANONICAL HEADER START */
+    AadNumber(){} // Default constructor, constant 0
+
+    AadNumber(double value) : m_value(value) {} // Constant
+
+    AadNumber(double value, size_t index) : m_value(value), m_index(index) {} // Value of a tape node
+    /* CANONICAL HEADER END */
+
+    static AadNumber Input(double value); // New independent variable on the active tape
+
+    /* GETTERS START */
+
+    double Value() const {
+        return m_value;
+    }
+
+    size_t Index() const {
+        return m_index;
+    }
+
+    double Adjoint() const {
+        // d(output)/d(this) after AadTape::Reverse
+        return AadTape::Active()->Adjoint(m_index);
+    }
+
+    /* GETTERS END */
+
+    AadNumber& operator += (const AadNumber& other);
+    AadNumber& operator -= (const AadNumber& other);
+    AadNumber& operator *= (const AadNumber& other);
+    AadNumber& operator /= (const AadNumber& other);
+
+};
+
+/* OPERATORS START */
+
+AadNumber Unary(const AadNumber& x, double value, double partial); // Node with one argument, skipped for constants
+
+AadNumber Binary(const AadNumber& x, const AadNumber& y, double value, double x_partial, double y_partial); // Node with two arguments, reduced to one when either is constant
+
+inline AadNumber operator + (const AadNumber& x, const AadNumber& y) {
+    return Binary(x, y, x.Value() + y.Value(), 1.0, 1.0);
+}
+
+inline AadNumber operator - (const AadNumber& x, const AadNumber& y) {
+    return Binary(x, y, x.Value() - y.Value(), 1.0, -1.0);
+}
+
+inline AadNumber operator * (const AadNumber& x, const AadNumber& y) {
+    return Binary(x, y, x.Value() * y.Value(), y.Value(), x.Value());
+}
+
+inline AadNumber operator / (const AadNumber& x, const AadNumber& y) {
+    double inverse = 1.0 / y.Value();
+    double value = x.Value() * inverse;
+    return Binary(x, y, value, inverse, -value * inverse);
+}
+
+inline AadNumber operator - (const AadNumber& x) {
+    return Unary(x, -x.Value(), -1.0);
+}
+
+inline bool operator < (const AadNumber& x, const AadNumber& y) {
+    return x.Value() < y.Value();
+}
+
+inline bool operator > (const AadNumber& x, const AadNumber& y) {
+    return x.Value() > y.Value();
+}
+
+inline bool operator <= (const AadNumber& x, const AadNumber& y) {
+    return x.Value() <= y.Value();
+}
+
+inline bool operator >= (const AadNumber& x, const AadNumber& y) {
+    return x.Value() >= y.Value();
+}
+
+/* OPERATORS END */
+
+/* FUNCTIONS START */
+
+AadNumber exp(const AadNumber& x); // e^x
+
+AadNumber log(const AadNumber& x); // Natural logarithm
+
+AadNumber sqrt(const AadNumber& x); // Square root
+
+AadNumber NormalCdf(const AadNumber& x); // N(x), derivative n(x)
+
+AadNumber NormalPdf(const AadNumber& x); // n(x), derivative -x*n(x)
+
+/* FUNCTIONS END */
+
+#endif /* Aad_hpp */
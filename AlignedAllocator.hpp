@@ -0,0 +1,56 @@
+//
+//  File: AlignedAllocator.hpp
+//  Project: ExactPricingModels
+//  Objective: Cache-line aligned allocator for contiguous pricing columns
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef AlignedAllocator_hpp
+#define AlignedAllocator_hpp
+
+#include <stdio.h>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+const size_t COLUMN_ALIGNMENT = 64; // Cache line / AVX-512 register width in bytes
+
+template <class T>
+class AlignedAllocator {
+
+public:
+    typedef T value_type;
+
+    AlignedAllocator() noexcept {} // Default constructor
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {} // Rebind constructor
+
+    T* allocate(size_t n) {
+        /*
+         Allocate n elements on a COLUMN_ALIGNMENT boundary
+         */
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(COLUMN_ALIGNMENT)));
+    }
+
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(COLUMN_ALIGNMENT));
+    }
+
+    template <class U>
+    bool operator == (const AlignedAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    template <class U>
+    bool operator != (const AlignedAllocator<U>&) const noexcept {
+        return false;
+    }
+
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>; // Contiguous aligned column
+
+#endif /* AlignedAllocator_hpp */
@@ -0,0 +1,273 @@
+//
+//  File: ArbitrageScanner.cpp
+//  Project: ExactPricingModels
+//  Objective: Put-call parity and static arbitrage checks over whole option chains
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ArbitrageScanner.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <stdexcept>
+
+size_t OptionChain::AddExpiry(size_t underlying, double underlying_price, double time_to_maturity,
+                              double riskfree_rate, double cost_of_carry) {
+    /*
+     Start an expiry. Expiries of an underlying must be added together, by increasing maturity
+     input:
+        underlying index, its price, time to maturity, risk-free rate and cost of carry
+     output:
+        index of the expiry
+     */
+
+    if (!(underlying_price > 0) || !(time_to_maturity > 0)) {
+        throw std::invalid_argument("OptionChain::AddExpiry: underlying price and time to maturity must be positive");
+    }
+
+    if (!expiries.empty() && expiries.back().underlying != underlying) {
+        for (const ChainExpiry& other: expiries) {
+            if (other.underlying == underlying) {
+                throw std::invalid_argument("OptionChain::AddExpiry: expiries of an underlying must be added together");
+            }
+        }
+    }
+
+    if (!expiries.empty() && expiries.back().underlying == underlying && !(time_to_maturity > expiries.back().T)) {
+        throw std::invalid_argument("OptionChain::AddExpiry: expiries of an underlying must be increasing");
+    }
+
+    ChainExpiry expiry;
+    expiry.underlying = underlying;
+    expiry.S = underlying_price;
+    expiry.T = time_to_maturity;
+    expiry.r = riskfree_rate;
+    expiry.b = cost_of_carry;
+    expiry.begin = expiry.end = Size();
+
+    expiries.push_back(expiry);
+
+    return expiries.size() - 1;
+}
+
+void OptionChain::AddQuote(double strike_price, double call_price, double put_price) {
+    /*
+     Append a row to the last expiry
+     input:
+        strike, above the previous strike of the expiry, call and put prices
+     */
+
+    if (expiries.empty()) {
+        throw std::invalid_argument("OptionChain::AddQuote: add an expiry first");
+    }
+
+    ChainExpiry& expiry = expiries.back();
+
+    if (expiry.end > expiry.begin && !(strike_price > K[expiry.end - 1])) {
+        throw std::invalid_argument("OptionChain::AddQuote: strikes of an expiry must be increasing");
+    }
+
+    K.push_back(strike_price);
+    call.push_back(call_price);
+    put.push_back(put_price);
+
+    expiry.end++;
+}
+
+void OptionChain::Clear() {
+    expiries.clear();
+    K.clear();
+    call.clear();
+    put.clear();
+}
+
+vector<ArbitrageViolation> ArbitrageScanner::Scan(const OptionChain& chain) {
+    /*
+     Scan a chain
+     input:
+        option chain
+     output:
+        violations of the selected checks
+     */
+
+    vector<ArbitrageViolation> violations;
+
+    Scan(chain, violations);
+
+    return violations;
+}
+
+void ArbitrageScanner::Scan(const OptionChain& chain, vector<ArbitrageViolation>& violations) {
+    /*
+     Scan a chain into a caller-provided vector. Each expiry's checks are followed by the
+     calendar check against the previous expiry of the same underlying
+     input:
+        option chain
+        output vector, cleared first
+     */
+
+    violations.clear();
+
+    for (size_t index = 0; index < chain.expiries.size(); index++) {
+
+        const ChainExpiry& expiry = chain.expiries[index];
+
+        ScanExpiry(chain, expiry, violations);
+
+        if ((m_checks & CALENDAR_CHECK) && index > 0 && chain.expiries[index - 1].underlying == expiry.underlying) {
+            ScanCalendar(chain, chain.expiries[index - 1], expiry, violations);
+        }
+    }
+}
+
+void ArbitrageScanner::ScanExpiry(const OptionChain& chain, const ChainExpiry& expiry, vector<ArbitrageViolation>& violations) {
+    /*
+     Parity, bounds, monotonicity and convexity of one expiry. Every residual is positive when
+     the relation is broken:
+        parity        |C - P - (A - DK)|
+        bounds        max(max(A - DK, 0) - C, C - A), and for puts max(max(DK - A, 0) - P, P - DK)
+        monotonicity  max(C2 - C1, C1 - C2 - D (K2 - K1)), and for puts max(P1 - P2, P2 - P1 - D (K2 - K1))
+        convexity     C2 - (w C1 + (1 - w) C3), w = (K3 - K2) / (K3 - K1), same for puts
+     input:
+        option chain, expiry
+        output vector
+     */
+
+    size_t n = expiry.end - expiry.begin;
+
+    if (n == 0) return;
+
+    if (m_residual.size() < n) m_residual.resize(n);
+
+    double D = exp(- expiry.r * expiry.T);
+    double A = expiry.S * exp( (expiry.b - expiry.r) * expiry.T );
+
+    const double* __restrict K = chain.K.data() + expiry.begin;
+    const double* __restrict C = chain.call.data() + expiry.begin;
+    const double* __restrict P = chain.put.data() + expiry.begin;
+    double* __restrict residual = m_residual.data();
+
+    if (m_checks & PARITY_CHECK) {
+        for (size_t index = 0; index < n; index++) residual[index] = fabs(C[index] - P[index] - (A - D * K[index]));
+        Emit(PARITY_CHECK, CALL, expiry.begin, 0, n, violations);
+    }
+
+    if (m_checks & BOUNDS_CHECK) {
+        for (size_t index = 0; index < n; index++) {
+            double forward = A - D * K[index];
+            residual[index] = std::max(std::max(forward, 0.0) - C[index], C[index] - A);
+        }
+        Emit(BOUNDS_CHECK, CALL, expiry.begin, 0, n, violations);
+
+        for (size_t index = 0; index < n; index++) {
+            double strike = D * K[index];
+            residual[index] = std::max(std::max(strike - A, 0.0) - P[index], P[index] - strike);
+        }
+        Emit(BOUNDS_CHECK, PUT, expiry.begin, 0, n, violations);
+    }
+
+    if ((m_checks & MONOTONICITY_CHECK) && n > 1) {
+        for (size_t index = 0; index + 1 < n; index++) {
+            double spread = C[index] - C[index + 1];
+            residual[index] = std::max(- spread, spread - D * (K[index + 1] - K[index]));
+        }
+        Emit(MONOTONICITY_CHECK, CALL, expiry.begin, 1, n - 1, violations);
+
+        for (size_t index = 0; index + 1 < n; index++) {
+            double spread = P[index + 1] - P[index];
+            residual[index] = std::max(- spread, spread - D * (K[index + 1] - K[index]));
+        }
+        Emit(MONOTONICITY_CHECK, PUT, expiry.begin, 1, n - 1, violations);
+    }
+
+    if ((m_checks & CONVEXITY_CHECK) && n > 2) {
+        for (size_t index = 0; index + 2 < n; index++) {
+            double w = (K[index + 2] - K[index + 1]) / (K[index + 2] - K[index]);
+            residual[index] = C[index + 1] - (w * C[index] + (1.0 - w) * C[index + 2]);
+        }
+        Emit(CONVEXITY_CHECK, CALL, expiry.begin, 2, n - 2, violations);
+
+        for (size_t index = 0; index + 2 < n; index++) {
+            double w = (K[index + 2] - K[index + 1]) / (K[index + 2] - K[index]);
+            residual[index] = P[index + 1] - (w * P[index] + (1.0 - w) * P[index + 2]);
+        }
+        Emit(CONVEXITY_CHECK, PUT, expiry.begin, 2, n - 2, violations);
+    }
+}
+
+void ArbitrageScanner::ScanCalendar(const OptionChain& chain, const ChainExpiry& early, const ChainExpiry& late,
+                                    vector<ArbitrageViolation>& violations) const {
+    /*
+     Calendar check between consecutive expiries of an underlying. Both slices are walked by
+     increasing moneyness k = K / F with F = S e^(bT); a row of the early expiry inside the late
+     expiry's strike range is compared with the late normalized call interpolated at its k
+     input:
+        option chain, earlier and later expiries of one underlying
+        output vector
+     */
+
+    if (early.end == early.begin || late.end - late.begin < 2) return;
+
+    double early_forward = early.S * exp(early.b * early.T);
+    double late_forward = late.S * exp(late.b * late.T);
+    double early_scale = early.S * exp( (early.b - early.r) * early.T );
+    double late_scale = late.S * exp( (late.b - late.r) * late.T );
+
+    const double* K = chain.K.data();
+    const double* C = chain.call.data();
+
+    size_t j = late.begin;
+
+    for (size_t row = early.begin; row < early.end; row++) {
+
+        double k = K[row] / early_forward;
+
+        while (j + 2 < late.end && K[j + 1] / late_forward <= k) j++;
+
+        double k1 = K[j] / late_forward;
+        double k2 = K[j + 1] / late_forward;
+
+        if (k < k1 || k > k2) continue;
+
+        double w = (k2 - k) / (k2 - k1);
+        double late_call = (w * C[j] + (1.0 - w) * C[j + 1]) / late_scale;
+
+        double amount = late_scale * (C[row] / early_scale - late_call);
+
+        if (amount > m_tolerance) {
+            ArbitrageViolation violation;
+            violation.check = CALENDAR_CHECK;
+            violation.call_or_put = CALL;
+            violation.row = row;
+            violation.other_row = j;
+            violation.amount = amount;
+            violations.push_back(violation);
+        }
+    }
+}
+
+void ArbitrageScanner::Emit(enum ArbitrageCheck check, enum CallOrPut call_or_put, size_t first_row, size_t span, size_t count,
+                            vector<ArbitrageViolation>& violations) const {
+    /*
+     Append every residual above the tolerance. Violations are rare, so the branch is almost
+     always not taken
+     input:
+        check and side, row of residual 0, rows spanned beyond the first, number of residuals
+        output vector
+     */
+
+    const double* residual = m_residual.data();
+
+    for (size_t index = 0; index < count; index++) {
+        if (residual[index] > m_tolerance) {
+            ArbitrageViolation violation;
+            violation.check = check;
+            violation.call_or_put = call_or_put;
+            violation.row = first_row + index;
+            violation.other_row = first_row + index + span;
+            violation.amount = residual[index];
+            violations.push_back(violation);
+        }
+    }
+}
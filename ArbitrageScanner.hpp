@@ -0,0 +1,135 @@
+//
+//  File: ArbitrageScanner.hpp
+//  Project: ExactPricingModels
+//  Objective: Put-call parity and static arbitrage checks over whole option chains
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ArbitrageScanner_hpp
+#define ArbitrageScanner_hpp
+
+#include <stdio.h>
+#include "AlignedAllocator.hpp"
+#include "Option.hpp"
+
+enum ArbitrageCheck{
+    PARITY_CHECK = 1 << 0, // C - P = S e^((b-r)T) - K e^(-rT)
+    BOUNDS_CHECK = 1 << 1, // max(A - DK, 0) <= C <= A and max(DK - A, 0) <= P <= DK, A = S e^((b-r)T), D = e^(-rT)
+    MONOTONICITY_CHECK = 1 << 2, // Vertical spreads between adjacent strikes worth between 0 and D (K2 - K1)
+    CONVEXITY_CHECK = 1 << 3, // Butterflies over three adjacent strikes worth at least 0
+    CALENDAR_CHECK = 1 << 4, // Calls at the same forward moneyness K / F worth more, per unit of A, at the later expiry
+    ALL_CHECKS = (1 << 5) - 1
+}; // Static arbitrage relations. Combine with | to select checks
+
+struct ChainExpiry {
+    /*
+     One expiry of a chain: market terms shared by its quotes and the rows holding them
+     */
+    size_t underlying = 0; // Underlying index
+    double S = 0; // Underlying price
+    double T = 0; // Time to maturity
+    double r = 0; // Risk-free rate
+    double b = 0; // Cost of carry, as EuropeanOption::b(), e.g. CostOfCarry(type, r, q, R)
+    size_t begin = 0; // First quote row
+    size_t end = 0; // One past the last quote row
+};
+
+struct OptionChain {
+    /*
+     Matched call and put quotes in columns, grouped by underlying, then by increasing expiry,
+     then by increasing strike. Add keeps that order; quotes may be updated in place every tick
+     */
+    vector<ChainExpiry> expiries; // Expiries in row order
+    AlignedVector<double> K; // Strike of each row
+    AlignedVector<double> call; // Call price of each row
+    AlignedVector<double> put; // Put price of each row
+
+    size_t Size() const {
+        return K.size();
+    }
+
+    size_t AddExpiry(size_t underlying, double underlying_price, double time_to_maturity,
+                     double riskfree_rate, double cost_of_carry); // Start an expiry, returns its index. Throws std::invalid_argument when it breaks the grouping
+
+    void AddQuote(double strike_price, double call_price, double put_price); // Append a row to the last expiry. Throws std::invalid_argument unless the strike exceeds the previous one
+
+    void Clear(); // Remove every expiry and quote
+};
+
+struct ArbitrageViolation {
+    /*
+     One broken relation. Rows index the chain's quote columns
+     */
+    enum ArbitrageCheck check = PARITY_CHECK; // Relation broken
+    enum CallOrPut call_or_put = CALL; // Side quoted (CALL for parity)
+    size_t row = 0; // First row involved
+    size_t other_row = 0; // Last row involved, equal to row for parity and bounds. For calendar, the row of the later expiry just below the same moneyness
+    double amount = 0; // How far the relation is broken, in price units, above the tolerance
+};
+
+class ArbitrageScanner {
+    /*
+     Scans a chain for static arbitrage. Discount factor and forward are computed once per expiry;
+     each check then fills a residual per row (or per adjacent pair or triple) in a plain loop the
+     compiler vectorizes, and a second pass emits only the rows whose residual exceeds the tolerance.
+     The calendar check walks consecutive expiries of an underlying together: the later expiry's
+     normalized call C / (S e^((b-r)T)) is interpolated linearly at the earlier one's K / F. On a
+     convex slice the interpolation is an upper bound, so a reported calendar violation holds
+     without a model. Puts follow from parity and are not checked separately
+     */
+
+    // Attributes
+    double m_tolerance = 1e-8; // Residuals up to this amount are not violations
+    unsigned m_checks = ALL_CHECKS; // Mask of ArbitrageCheck values
+    AlignedVector<double> m_residual; // Scratch, one value per row of the longest expiry. Reused between scans
+
+public:
+    /* CANONICAL HEADER START */
+    ArbitrageScanner(){} // Default constructor
+
+    ArbitrageScanner(double tolerance, unsigned checks = ALL_CHECKS) : m_tolerance(tolerance), m_checks(checks) {} // Parameter constructor
+
+    virtual ~ArbitrageScanner(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    double Tolerance() const {
+        return m_tolerance;
+    }
+
+    unsigned Checks() const {
+        return m_checks;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Tolerance(double tolerance) {
+        this->m_tolerance = tolerance;
+    }
+
+    void Checks(unsigned checks) {
+        this->m_checks = checks;
+    }
+
+    /* SETTERS END */
+
+    vector<ArbitrageViolation> Scan(const OptionChain& chain); // Violations of the selected checks, grouped by expiry
+
+    void Scan(const OptionChain& chain, vector<ArbitrageViolation>& violations); // Same into a caller-provided vector, cleared first, so repeated scans do not allocate
+
+    // Helper functions
+private:
+    void ScanExpiry(const OptionChain& chain, const ChainExpiry& expiry, vector<ArbitrageViolation>& violations); // Parity, bounds, monotonicity and convexity of one expiry
+
+    void ScanCalendar(const OptionChain& chain, const ChainExpiry& early, const ChainExpiry& late, vector<ArbitrageViolation>& violations) const; // Calendar check between consecutive expiries
+
+    void Emit(enum ArbitrageCheck check, enum CallOrPut call_or_put, size_t first_row, size_t span, size_t count,
+              vector<ArbitrageViolation>& violations) const; // Append the rows of m_residual above the tolerance
+
+};
+
+#endif /* ArbitrageScanner_hpp */
@@ -0,0 +1,282 @@
+//
+//  File: BatchPricer.cpp
+//  Project: ExactPricingModels
+//  Objective: Black-Scholes pricing over a whole book of options
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "BatchPricer.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+static const unsigned char STOCK_BLOCK[BATCH_BLOCK] = {}; // Underlying classes of a block when the view has no such column, all STOCK
+
+template <typename Body>
+void BatchPricer::ForEachChunk(size_t size, const Body& body) const {
+    /*
+     Run body over [0, size) in chunks of ChunkSize() contracts, on the pool when there is more than one chunk.
+     body is passed by reference so wrapping it in a ThreadPool::RangeTask does not allocate
+     */
+
+    if (size <= m_chunk_size) {
+        body(0, size);
+        return;
+    }
+
+    Pool().ParallelFor(0, size, m_chunk_size, std::cref(body));
+}
+
+vector<double> BatchPricer::Price(const OptionBatch& batch) const {
+    /*
+     Price every option in the batch
+     input:
+        option batch
+     output:
+        vector with prices, in batch order
+     */
+
+    vector<double> prices(batch.Size());
+
+    Price(batch.View(), prices.data());
+
+    return prices;
+}
+
+void BatchPricer::Price(const OptionBatchView& batch, double* prices) const {
+    /*
+     Price every option in the view. Batches larger than one chunk are spread over the thread pool;
+     every contract is written to its own slot so the output never depends on the thread count
+     input:
+        option batch view
+        output column with at least batch.size elements
+     */
+
+    METRIC_SCOPE(TIMER_BATCH_PRICE, batch.size);
+
+    ForEachChunk(batch.size, [&](size_t begin, size_t end) {
+        PriceBlocks(batch.Slice(begin, end), prices + begin);
+    });
+}
+
+void BatchPricer::PriceBlocks(const OptionBatchView& batch, double* prices) const {
+    /*
+     Price every option in the view. Calls and puts share one branch-free formula,
+     phi * ( S*e^((b-r)T)*N(phi*d1) - K*e^(-rT)*N(phi*d2) ) with phi = +1 (call) or -1 (put).
+     Contracts are processed in blocks: the arithmetic runs in plain loops the compiler vectorizes,
+     the transcendental calls go through the SIMD array kernels of NormalMath. With MIXED_PRECISION
+     N runs in the single precision kernel; its absolute error below 1e-7 bounds the price error
+     by 2e-7 * (S*e^((b-r)T) + K*e^(-rT))
+     input:
+        option batch view
+        output column with at least batch.size elements
+     */
+
+    alignas(COLUMN_ALIGNMENT) double phi[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double x1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double x2[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double e1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double e2[BATCH_BLOCK];
+
+    void (*normal_cdf)(const double*, double*, size_t) = NormalCdf;
+    if (m_precision == MIXED_PRECISION) normal_cdf = NormalCdfMixed;
+
+    for (size_t start = 0; start < batch.size; start += BATCH_BLOCK) {
+
+        size_t n = batch.size - start < BATCH_BLOCK ? batch.size - start : BATCH_BLOCK;
+
+        const double* __restrict S = batch.S + start;
+        const double* __restrict K = batch.K + start;
+        const double* __restrict T = batch.T + start;
+        const double* __restrict r = batch.r + start;
+        const double* __restrict s = batch.s + start;
+        const double* __restrict b = batch.b + start;
+        const unsigned char* __restrict call_or_put = batch.call_or_put + start;
+        double* __restrict out = prices + start;
+
+        for (size_t index = 0; index < n; index++) x1[index] = S[index] / K[index];
+
+        Log(x1, x1, n);
+
+        for (size_t index = 0; index < n; index++) {
+
+            phi[index] = 1.0 - 2.0 * call_or_put[index];
+
+            double temp = s[index] * sqrt(T[index]);
+
+            double d1 = ( x1[index] + (b[index] + (s[index]*s[index] / 2.0) ) * T[index] ) / temp;
+
+            x1[index] = phi[index] * d1;
+            x2[index] = phi[index] * (d1 - temp);
+
+            e1[index] = (b[index] - r[index]) * T[index];
+            e2[index] = - r[index] * T[index];
+        }
+
+        normal_cdf(x1, x1, n);
+        normal_cdf(x2, x2, n);
+        Exp(e1, e1, n);
+        Exp(e2, e2, n);
+
+        for (size_t index = 0; index < n; index++) {
+            out[index] = phi[index] * (S[index]*e1[index]*x1[index] - K[index]*e2[index]*x2[index]);
+        }
+    }
+}
+
+void BatchPricer::PriceAndGreeks(const OptionBatch& batch, unsigned mask, GreeksBatch& greeks) const {
+    /*
+     Price and requested sensitivities of every option in the batch
+     input:
+        option batch, mask of GreekMask values
+        output batch, its requested columns are resized and the others released
+     */
+
+    PriceAndGreeks(batch.View(), mask, greeks.Allocate(batch.Size(), mask));
+}
+
+void BatchPricer::PriceAndGreeks(const OptionBatchView& batch, unsigned mask, const GreeksColumns& greeks) const {
+    /*
+     Price and requested sensitivities into caller-provided columns, chunked over the thread pool
+     input:
+        option batch view, mask of GreekMask values
+        output columns with at least batch.size elements for every requested output
+     */
+
+    METRIC_SCOPE(TIMER_BATCH_GREEKS, batch.size);
+
+    ForEachChunk(batch.size, [&](size_t begin, size_t end) {
+        GreeksColumns slice;
+        slice.price = greeks.price ? greeks.price + begin : nullptr;
+        slice.delta = greeks.delta ? greeks.delta + begin : nullptr;
+        slice.gamma = greeks.gamma ? greeks.gamma + begin : nullptr;
+        slice.vega = greeks.vega ? greeks.vega + begin : nullptr;
+        slice.theta = greeks.theta ? greeks.theta + begin : nullptr;
+        slice.rho = greeks.rho ? greeks.rho + begin : nullptr;
+        slice.carry_rho = greeks.carry_rho ? greeks.carry_rho + begin : nullptr;
+        PriceAndGreeksBlocks(batch.Slice(begin, end), mask, slice);
+    });
+}
+
+void BatchPricer::PriceAndGreeksBlocks(const OptionBatchView& batch, unsigned mask, const GreeksColumns& greeks) const {
+    /*
+     Fused price and sensitivities, see EuropeanOption::PriceAndGreeks. Each block evaluates d1, d2
+     and the discount factors once, and only runs the array kernels a requested output depends on.
+     With MIXED_PRECISION, N and n run in the single precision kernels. Rounding d1 to float
+     scales n's relative error by d1^2, so bounds are relative to each output's scale:
+     |price error| < 2e-7 * (S*e^((b-r)T) + K*e^(-rT)), |delta error| < 2e-7 * e^((b-r)T),
+     |gamma error| < 2e-7 * e^((b-r)T) / (S*s*sqrt(T))
+     input:
+        option batch view, mask of GreekMask values
+        output columns with at least batch.size elements for every requested output
+     */
+
+    bool need_Nd1 = mask & (GREEK_PRICE | GREEK_DELTA | GREEK_THETA | GREEK_RHO | GREEK_CARRY_RHO);
+    bool need_Nd2 = mask & (GREEK_PRICE | GREEK_THETA | GREEK_RHO);
+    bool need_nd1 = mask & (GREEK_GAMMA | GREEK_VEGA | GREEK_THETA);
+
+    alignas(COLUMN_ALIGNMENT) double phi[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double sqrtT[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double d1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double Nd1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double Nd2[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double nd1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double e1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double e2[BATCH_BLOCK];
+
+    void (*normal_cdf)(const double*, double*, size_t) = NormalCdf;
+    void (*normal_pdf)(const double*, double*, size_t) = NormalPdf;
+    if (m_precision == MIXED_PRECISION) {
+        normal_cdf = NormalCdfMixed;
+        normal_pdf = NormalPdfMixed;
+    }
+
+    for (size_t start = 0; start < batch.size; start += BATCH_BLOCK) {
+
+        size_t n = batch.size - start < BATCH_BLOCK ? batch.size - start : BATCH_BLOCK;
+
+        const double* __restrict S = batch.S + start;
+        const double* __restrict K = batch.K + start;
+        const double* __restrict T = batch.T + start;
+        const double* __restrict r = batch.r + start;
+        const double* __restrict s = batch.s + start;
+        const double* __restrict b = batch.b + start;
+        const unsigned char* __restrict call_or_put = batch.call_or_put + start;
+        const unsigned char* __restrict underlying_type = batch.underlying_type ? batch.underlying_type + start : STOCK_BLOCK;
+
+        for (size_t index = 0; index < n; index++) d1[index] = S[index] / K[index];
+
+        Log(d1, d1, n);
+
+        for (size_t index = 0; index < n; index++) {
+
+            phi[index] = 1.0 - 2.0 * call_or_put[index];
+
+            sqrtT[index] = sqrt(T[index]);
+
+            double temp = s[index] * sqrtT[index];
+
+            d1[index] = ( d1[index] + (b[index] + (s[index]*s[index] / 2.0) ) * T[index] ) / temp;
+
+            Nd1[index] = phi[index] * d1[index];
+            Nd2[index] = phi[index] * (d1[index] - temp);
+
+            e1[index] = (b[index] - r[index]) * T[index];
+            e2[index] = - r[index] * T[index];
+        }
+
+        if (need_Nd1) normal_cdf(Nd1, Nd1, n);
+        if (need_Nd2) normal_cdf(Nd2, Nd2, n);
+        if (need_nd1) normal_pdf(d1, nd1, n);
+        Exp(e1, e1, n);
+        if (need_Nd2) Exp(e2, e2, n);
+
+        if (mask & GREEK_PRICE) {
+            double* __restrict out = greeks.price + start;
+            for (size_t index = 0; index < n; index++) {
+                out[index] = phi[index] * (S[index]*e1[index]*Nd1[index] - K[index]*e2[index]*Nd2[index]);
+            }
+        }
+
+        if (mask & GREEK_DELTA) {
+            double* __restrict out = greeks.delta + start;
+            for (size_t index = 0; index < n; index++) out[index] = phi[index] * e1[index] * Nd1[index];
+        }
+
+        if (mask & GREEK_GAMMA) {
+            double* __restrict out = greeks.gamma + start;
+            for (size_t index = 0; index < n; index++) out[index] = (nd1[index] * e1[index]) / (S[index] * s[index] * sqrtT[index]);
+        }
+
+        if (mask & GREEK_VEGA) {
+            double* __restrict out = greeks.vega + start;
+            for (size_t index = 0; index < n; index++) out[index] = S[index] * e1[index] * nd1[index] * sqrtT[index];
+        }
+
+        if (mask & GREEK_THETA) {
+            double* __restrict out = greeks.theta + start;
+            for (size_t index = 0; index < n; index++) {
+                double SebrT = S[index] * e1[index];
+                out[index] = - (SebrT * nd1[index] * s[index]) / (2.0 * sqrtT[index])
+                             - phi[index] * (b[index] - r[index]) * SebrT * Nd1[index]
+                             - phi[index] * r[index] * K[index] * e2[index] * Nd2[index];
+            }
+        }
+
+        if (mask & GREEK_RHO) {
+            double* __restrict out = greeks.rho + start;
+            for (size_t index = 0; index < n; index++) {
+                double SebrT = S[index] * e1[index];
+                double price = phi[index] * (SebrT*Nd1[index] - K[index]*e2[index]*Nd2[index]);
+                double carry_rho = underlying_type[index] == FUTURES ? 0.0 : phi[index] * T[index] * SebrT * Nd1[index];
+                out[index] = - T[index] * price + carry_rho;
+            }
+        }
+
+        if (mask & GREEK_CARRY_RHO) {
+            double* __restrict out = greeks.carry_rho + start;
+            for (size_t index = 0; index < n; index++) out[index] = phi[index] * T[index] * S[index] * e1[index] * Nd1[index];
+        }
+    }
+}
@@ -0,0 +1,89 @@
+//
+//  File: BatchPricer.hpp
+//  Project: ExactPricingModels
+//  Objective: Black-Scholes pricing over a whole book of options
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef BatchPricer_hpp
+#define BatchPricer_hpp
+
+#include <stdio.h>
+#include "OptionBatch.hpp"
+#include "Greeks.hpp"
+#include "ThreadPool.hpp"
+
+const size_t BATCH_BLOCK = 256; // Contracts per block, sized so the block's temporaries stay in L1
+
+const size_t BATCH_CHUNK = 16384; // Default contracts per thread pool task
+
+class BatchPricer {
+
+    // Attributes
+    ThreadPool* m_pool = nullptr; // Pool used for large batches, nullptr for the shared pool
+    size_t m_chunk_size = BATCH_CHUNK; // Contracts per thread pool task
+    enum Precision m_precision = DOUBLE_PRECISION; // Precision of the distribution kernels
+
+public:
+    /* CANONICAL HEADER START */
+    BatchPricer(){} // Default constructor
+
+    BatchPricer(ThreadPool* pool, size_t chunk_size = BATCH_CHUNK, enum Precision precision = DOUBLE_PRECISION)
+        : m_pool(pool), m_chunk_size(chunk_size), m_precision(precision) {} // Parameter constructor
+
+    virtual ~BatchPricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    ThreadPool& Pool() const {
+        return m_pool ? *m_pool : ThreadPool::Instance();
+    }
+
+    size_t ChunkSize() const {
+        return m_chunk_size;
+    }
+
+    enum Precision Precision() const {
+        return m_precision;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        this->m_pool = pool;
+    }
+
+    void ChunkSize(size_t chunk_size) {
+        this->m_chunk_size = chunk_size;
+    }
+
+    void Precision(enum Precision precision) {
+        this->m_precision = precision;
+    }
+
+    /* SETTERS END */
+
+    vector<double> Price(const OptionBatch& batch) const; // Price every option in the batch
+
+    void Price(const OptionBatchView& batch, double* prices) const; // Price every option in the view into a caller-provided column
+
+    void PriceAndGreeks(const OptionBatch& batch, unsigned mask, GreeksBatch& greeks) const; // Price and requested sensitivities of every option
+
+    void PriceAndGreeks(const OptionBatchView& batch, unsigned mask, const GreeksColumns& greeks) const; // Price and requested sensitivities into caller-provided columns
+
+    // Helper functions
+private:
+    template <typename Body>
+    void ForEachChunk(size_t size, const Body& body) const; // Split a batch into chunks on the pool
+
+    void PriceBlocks(const OptionBatchView& batch, double* prices) const; // Single-threaded pricing kernel
+
+    void PriceAndGreeksBlocks(const OptionBatchView& batch, unsigned mask, const GreeksColumns& greeks) const; // Single-threaded fused kernel
+
+};
+
+#endif /* BatchPricer_hpp */
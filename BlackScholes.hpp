@@ -0,0 +1,335 @@
+//
+//  File: BlackScholes.hpp
+//  Project: ExactPricingModels
+//  Objective: Black-Scholes-Merton kernels specialized at compile time on option type
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef BlackScholes_hpp
+#define BlackScholes_hpp
+
+#include <stdio.h>
+#include <type_traits>
+#include "BatchPricer.hpp"
+#include "ConstexprMath.hpp"
+#include "EuropeanOption.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+/*
+ BlackScholes<CALL>, BlackScholes<PUT>. The option type is the constant phi = +1/-1, so the kernels
+ have no runtime branch on it:
+    price = phi * (S*e^((b-r)T)*N(phi*d1) - K*e^(-rT)*N(phi*d2))
+ The underlying asset class only decides the cost of carry b, which every kernel takes as an input
+ (see CostOfCarry), so it is not a template parameter
+ The scalar functions are constexpr: with constant inputs they are evaluated by the compiler
+ (ConstexprMath), otherwise they run on <cmath> and NormalMath. PriceMesh is also templated on the
+ varied Parameter, so each mesh loop only computes the terms that depend on it
+ */
+
+template <enum CallOrPut call_or_put>
+class BlackScholes {
+
+public:
+    static constexpr double phi = call_or_put == CALL ? +1.0 : -1.0; // +1 for a call, -1 for a put
+
+    template <typename Number>
+    static Number Value(const Number& S, const Number& K, const Number& T, const Number& r, const Number& s, const Number& b) {
+        /*
+         Price for any number type providing exp, log, sqrt and NormalCdf, e.g. AadNumber to record
+         the valuation on an adjoint tape
+         input:
+            underlying, strike, maturity, rate, volatility, cost of carry
+         output:
+            price
+         */
+        Number v = s * sqrt(T);
+        Number d1 = ( log(S / K) + (b + (s * s) / 2.0) * T ) / v;
+        Number d2 = d1 - v;
+
+        return phi * (S * exp( (b - r) * T ) * NormalCdf(phi * d1) - K * exp( - r * T ) * NormalCdf(phi * d2));
+    }
+
+    static constexpr double Price(double S, double K, double T, double r, double s, double b) {
+        /*
+         Price
+         input:
+            underlying, strike, maturity, rate, volatility, cost of carry
+         output:
+            price
+         */
+        double v = s * ScalarSqrt(T);
+        double d1 = ( ScalarLog(S/K) + (b + (s*s / 2.0) ) * T ) / v;
+        double d2 = d1 - v;
+
+        return phi * (S * ScalarExp( (b - r) * T ) * ScalarCdf(phi * d1) - K * ScalarExp( - r * T ) * ScalarCdf(phi * d2));
+    }
+
+    static constexpr double Delta(double S, double K, double T, double r, double s, double b) {
+        /*
+         Delta, phi * e^((b-r)T) * N(phi*d1)
+         */
+        double v = s * ScalarSqrt(T);
+        double d1 = ( ScalarLog(S/K) + (b + (s*s / 2.0) ) * T ) / v;
+
+        return phi * ScalarExp( (b - r) * T ) * ScalarCdf(phi * d1);
+    }
+
+    static constexpr double Gamma(double S, double K, double T, double r, double s, double b) {
+        /*
+         Gamma, n(d1) * e^((b-r)T) / (S*s*sqrt(T)), the same for calls and puts
+         */
+        double v = s * ScalarSqrt(T);
+        double d1 = ( ScalarLog(S/K) + (b + (s*s / 2.0) ) * T ) / v;
+
+        return ScalarPdf(d1) * ScalarExp( (b - r) * T ) / (S * v);
+    }
+
+    static double Price(double S, double K, const PricingTerms& terms) {
+        /*
+         Price from cached terms
+         input:
+            underlying, strike, terms computed from them
+         output:
+            price
+         */
+        double d1 = ( terms.log_S - terms.log_K + terms.drift ) / terms.volatility;
+        double d2 = d1 - terms.volatility;
+
+        return phi * (S * terms.carry * NormalCdf(phi * d1) - K * terms.discount * NormalCdf(phi * d2));
+    }
+
+    static double Delta(const PricingTerms& terms) {
+        double d1 = ( terms.log_S - terms.log_K + terms.drift ) / terms.volatility;
+
+        return phi * terms.carry * NormalCdf(phi * d1);
+    }
+
+    static double Gamma(double S, const PricingTerms& terms) {
+        double d1 = ( terms.log_S - terms.log_K + terms.drift ) / terms.volatility;
+
+        return NormalPdf(d1) * terms.carry / (S * terms.volatility);
+    }
+
+    template <enum Parameter parameter>
+    static void PriceMesh(double S, double K, double T, double r, double s, double b, const double* mesh, double* prices, size_t n,
+                          enum Precision precision = DOUBLE_PRECISION) {
+        /*
+         Price along a mesh of one parameter, the others fixed. The terms that do not depend on
+         the parameter are computed once:
+            a = log(S/K), v = s*sqrt(T), m = (b + s*s/2)*T, A = S*e^((b-r)T), B = K*e^(-rT)
+         and the others per point, in blocks of BATCH_BLOCK through the array kernels.
+         d1 and d2 do not depend on the rate, so a RATE mesh reuses N(d1), N(d2).
+         MIXED_PRECISION runs the per point N through the single precision kernel, see BatchPricer
+         input:
+            fixed parameters (the varied one is ignored), mesh, output column, mesh size, precision of N
+         */
+
+        double sqrtT = sqrt(T);
+        double log_S = log(S);
+        double log_K = log(K);
+        double row_a = log(S/K);
+        double row_v = s * sqrtT;
+        double row_m = (b + (s*s / 2.0) ) * T;
+        double ebrT = exp( (b - r) * T );
+        double erT = exp( - r * T );
+        double row_A = S * ebrT;
+        double row_B = K * erT;
+        double row_Nd1 = 0, row_Nd2 = 0;
+
+        if constexpr (parameter == RATE) {
+            row_Nd1 = NormalCdf(phi * (row_a + row_m) / row_v);
+            row_Nd2 = NormalCdf(phi * ((row_a + row_m) / row_v - row_v));
+        }
+
+        alignas(COLUMN_ALIGNMENT) double a[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double v[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double m[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double A[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double B[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double Nd1[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double Nd2[BATCH_BLOCK];
+
+        for (size_t start = 0; start < n; start += BATCH_BLOCK) {
+
+            size_t count = n - start < BATCH_BLOCK ? n - start : BATCH_BLOCK;
+
+            const double* x = mesh + start;
+            double* out = prices + start;
+
+            if constexpr (parameter == UNDERLYING) {
+                Log(x, a, count);
+                for (size_t index = 0; index < count; index++) {
+                    a[index] -= log_K;
+                    v[index] = row_v;
+                    m[index] = row_m;
+                    A[index] = x[index] * ebrT;
+                    B[index] = row_B;
+                }
+            } else if constexpr (parameter == STRIKE) {
+                Log(x, a, count);
+                for (size_t index = 0; index < count; index++) {
+                    a[index] = log_S - a[index];
+                    v[index] = row_v;
+                    m[index] = row_m;
+                    A[index] = row_A;
+                    B[index] = x[index] * erT;
+                }
+            } else if constexpr (parameter == TIME) {
+                for (size_t index = 0; index < count; index++) {
+                    a[index] = row_a;
+                    v[index] = s * sqrt(x[index]);
+                    m[index] = (b + (s*s / 2.0) ) * x[index];
+                    A[index] = (b - r) * x[index];
+                    B[index] = - r * x[index];
+                }
+                Exp(A, A, count);
+                Exp(B, B, count);
+                for (size_t index = 0; index < count; index++) {
+                    A[index] *= S;
+                    B[index] *= K;
+                }
+            } else if constexpr (parameter == RATE) {
+                for (size_t index = 0; index < count; index++) {
+                    A[index] = (b - x[index]) * T;
+                    B[index] = - x[index] * T;
+                }
+                Exp(A, A, count);
+                Exp(B, B, count);
+                for (size_t index = 0; index < count; index++) {
+                    out[index] = phi * (S * A[index] * row_Nd1 - K * B[index] * row_Nd2);
+                }
+                continue;
+            } else if constexpr (parameter == SIGMA) {
+                for (size_t index = 0; index < count; index++) {
+                    a[index] = row_a;
+                    v[index] = x[index] * sqrtT;
+                    m[index] = (b + (x[index]*x[index] / 2.0) ) * T;
+                    A[index] = row_A;
+                    B[index] = row_B;
+                }
+            } else {
+                static_assert(parameter == CARRY, "BlackScholes::PriceMesh: unknown parameter");
+                for (size_t index = 0; index < count; index++) {
+                    a[index] = row_a;
+                    v[index] = row_v;
+                    m[index] = (x[index] + (s*s / 2.0) ) * T;
+                    A[index] = (x[index] - r) * T;
+                    B[index] = row_B;
+                }
+                Exp(A, A, count);
+                for (size_t index = 0; index < count; index++) A[index] *= S;
+            }
+
+            for (size_t index = 0; index < count; index++) {
+                double d1 = (a[index] + m[index]) / v[index];
+                Nd1[index] = phi * d1;
+                Nd2[index] = phi * (d1 - v[index]);
+            }
+
+            if (precision == MIXED_PRECISION) {
+                NormalCdfMixed(Nd1, Nd1, count);
+                NormalCdfMixed(Nd2, Nd2, count);
+            } else {
+                NormalCdf(Nd1, Nd1, count);
+                NormalCdf(Nd2, Nd2, count);
+            }
+
+            for (size_t index = 0; index < count; index++) {
+                out[index] = phi * (A[index]*Nd1[index] - B[index]*Nd2[index]);
+            }
+        }
+    }
+
+    static void DeltaMesh(const PricingTerms& terms, const double* S, double* deltas, size_t n) {
+        /*
+         Delta along a mesh of the underlying, only log(S) varies
+         input:
+            terms of the option, underlying mesh, output column, mesh size
+         */
+        for (size_t start = 0; start < n; start += BATCH_BLOCK) {
+
+            size_t count = n - start < BATCH_BLOCK ? n - start : BATCH_BLOCK;
+
+            double* out = deltas + start;
+
+            Log(S + start, out, count);
+
+            for (size_t index = 0; index < count; index++) {
+                out[index] = phi * ( out[index] - terms.log_K + terms.drift ) / terms.volatility;
+            }
+
+            NormalCdf(out, out, count);
+
+            for (size_t index = 0; index < count; index++) out[index] *= phi * terms.carry;
+        }
+    }
+
+    static void GammaMesh(const PricingTerms& terms, const double* S, double* gammas, size_t n) {
+        /*
+         Gamma along a mesh of the underlying, only log(S) varies
+         input:
+            terms of the option, underlying mesh, output column, mesh size
+         */
+        for (size_t start = 0; start < n; start += BATCH_BLOCK) {
+
+            size_t count = n - start < BATCH_BLOCK ? n - start : BATCH_BLOCK;
+
+            const double* x = S + start;
+            double* out = gammas + start;
+
+            Log(x, out, count);
+
+            for (size_t index = 0; index < count; index++) {
+                out[index] = ( out[index] - terms.log_K + terms.drift ) / terms.volatility;
+            }
+
+            NormalPdf(out, out, count);
+
+            for (size_t index = 0; index < count; index++) {
+                out[index] *= terms.carry / (x[index] * terms.volatility);
+            }
+        }
+    }
+
+    // Helper functions
+private:
+    static constexpr double ScalarExp(double x) {
+        if (std::is_constant_evaluated()) return ConstexprExp(x);
+        return exp(x);
+    }
+
+    static constexpr double ScalarLog(double x) {
+        if (std::is_constant_evaluated()) return ConstexprLog(x);
+        return log(x);
+    }
+
+    static constexpr double ScalarSqrt(double x) {
+        if (std::is_constant_evaluated()) return ConstexprSqrt(x);
+        return sqrt(x);
+    }
+
+    static constexpr double ScalarCdf(double x) {
+        if (std::is_constant_evaluated()) return ConstexprNormalCdf(x);
+        return NormalCdf(x);
+    }
+
+    static constexpr double ScalarPdf(double x) {
+        if (std::is_constant_evaluated()) return ConstexprNormalPdf(x);
+        return NormalPdf(x);
+    }
+
+};
+
+template <typename Body>
+inline auto WithKernel(enum CallOrPut call_or_put, Body&& body) {
+    /*
+     Branch once on the option type, then run body with the matching BlackScholes specialization,
+     e.g. [&](auto kernel) { decltype(kernel)::Price(...); }
+     */
+    if (call_or_put == CALL) return body(BlackScholes<CALL>());
+    return body(BlackScholes<PUT>());
+}
+
+#endif /* BlackScholes_hpp */
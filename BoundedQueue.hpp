@@ -0,0 +1,98 @@
+//
+//  File: BoundedQueue.hpp
+//  Project: ExactPricingModels
+//  Objective: Blocking fixed-capacity queue connecting pipeline stages
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef BoundedQueue_hpp
+#define BoundedQueue_hpp
+
+#include <stdio.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+template <typename T>
+class BoundedQueue {
+
+    // Attributes
+    std::deque<T> m_items; // Queued items, oldest first
+    size_t m_capacity; // Items held before Push blocks
+    bool m_closed = false; // No more items will be accepted
+    std::mutex m_mutex; // Guards the attributes
+    std::condition_variable m_not_full; // Signalled when an item is taken or on close
+    std::condition_variable m_not_empty; // Signalled when an item is added or on close
+
+public:
+    /* CANONICAL HEADER START */
+    BoundedQueue(size_t capacity) : m_capacity(capacity > 0 ? capacity : 1) {} // Parameter constructor
+
+    BoundedQueue(const BoundedQueue& other_queue) = delete; // Not copyable
+
+    virtual ~BoundedQueue(){} // Destructor
+
+    BoundedQueue& operator = (const BoundedQueue& other_queue) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    bool Push(T item) {
+        /*
+         Append an item, waiting while the queue is full. This is the back pressure between stages
+         output:
+            false if the queue was closed, the item is then dropped
+         */
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_not_full.wait(lock, [this]{ return m_closed || m_items.size() < m_capacity; });
+
+        if (m_closed) return false;
+
+        m_items.push_back(std::move(item));
+
+        lock.unlock();
+        m_not_empty.notify_one();
+
+        return true;
+    }
+
+    bool Pop(T& item) {
+        /*
+         Take the oldest item, waiting while the queue is empty
+         output:
+            false once the queue is closed and drained
+         */
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_not_empty.wait(lock, [this]{ return m_closed || !m_items.empty(); });
+
+        if (m_items.empty()) return false;
+
+        item = std::move(m_items.front());
+        m_items.pop_front();
+
+        lock.unlock();
+        m_not_full.notify_one();
+
+        return true;
+    }
+
+    void Close() {
+        /*
+         Stop accepting items and wake every waiting thread. Items already queued can still be popped
+         */
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    size_t Capacity() const {
+        return m_capacity;
+    }
+
+};
+
+#endif /* BoundedQueue_hpp */
@@ -0,0 +1,305 @@
+//
+//  File: BumpPricer.cpp
+//  Project: ExactPricingModels
+//  Objective: Finite-difference sensitivities of a whole book, all bumped scenarios priced in one batch
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "BumpPricer.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+const size_t BUMP_PARAMETERS = CARRY + 1; // Parameters a scenario can shift
+
+struct BumpScenario {
+    /*
+     One bumped copy of the book: the shift of every parameter, in parameter units or in
+     fractions of max(|x|, 1) when relative
+     */
+    double shift[BUMP_PARAMETERS] = {};
+    bool relative = false;
+
+    bool operator == (const BumpScenario& other) const {
+        return relative == other.relative && std::equal(shift, shift + BUMP_PARAMETERS, other.shift);
+    }
+};
+
+struct BumpTerm {
+    size_t scenario; // Index of the scenario
+    double weight; // Weight of its price in the stencil, before dividing by the steps
+};
+
+struct BumpStencil {
+    /*
+     One finite-difference estimate: sum of weight * price over the terms, divided by
+     denominator * scale(parameter) [* scale(second)]
+     */
+    vector<BumpTerm> terms;
+    double denominator = 1;
+    bool second_order = false; // Divided by the scale of two parameters
+};
+
+static size_t FindOrAdd(vector<BumpScenario>& scenarios, BumpScenario scenario) {
+    /*
+     Index of a scenario, added if new. The base scenario is the same whether steps are relative or not
+     */
+
+    if (std::all_of(scenario.shift, scenario.shift + BUMP_PARAMETERS, [](double shift) { return shift == 0; })) {
+        scenario.relative = false;
+    }
+
+    for (size_t index = 0; index < scenarios.size(); index++) {
+        if (scenarios[index] == scenario) return index;
+    }
+
+    scenarios.push_back(scenario);
+    return scenarios.size() - 1;
+}
+
+static BumpStencil Stencil(const Bump& bump, double h, double second_h, vector<BumpScenario>& scenarios) {
+    /*
+     Scenarios and weights of one bump with steps h (and second_h)
+     */
+
+    BumpStencil stencil;
+
+    auto point = [&](double shift, double second_shift, double weight) {
+        BumpScenario scenario;
+        scenario.relative = bump.relative;
+        scenario.shift[bump.parameter] += shift;
+        scenario.shift[bump.second] += second_shift;
+        stencil.terms.push_back({FindOrAdd(scenarios, scenario), weight});
+    };
+
+    switch (bump.scheme) {
+        case FORWARD_DIFFERENCE:
+            point(h, 0, 1);
+            point(0, 0, -1);
+            stencil.denominator = h;
+            break;
+        case CENTRAL_DIFFERENCE:
+            point(h, 0, 1);
+            point(-h, 0, -1);
+            stencil.denominator = 2 * h;
+            break;
+        case SECOND_DIFFERENCE:
+            point(h, 0, 1);
+            point(0, 0, -2);
+            point(-h, 0, 1);
+            stencil.denominator = h * h;
+            stencil.second_order = true;
+            break;
+        case CROSS_DIFFERENCE:
+            point(h, second_h, 1);
+            point(h, -second_h, -1);
+            point(-h, second_h, -1);
+            point(-h, -second_h, 1);
+            stencil.denominator = 4 * h * second_h;
+            stencil.second_order = true;
+            break;
+        default:
+            throw std::invalid_argument("BumpPricer: unknown difference scheme");
+    }
+
+    return stencil;
+}
+
+static void Plan(const vector<Bump>& bumps, bool richardson, vector<BumpScenario>& scenarios, vector<BumpStencil>& stencils) {
+    /*
+     Distinct scenarios and the stencils reading them: one stencil per bump, two (h then h / 2) with Richardson
+     */
+
+    for (const Bump& bump: bumps) {
+
+        if (!(bump.h > 0) || (bump.scheme == CROSS_DIFFERENCE && !(bump.second_h > 0))) {
+            throw std::invalid_argument("BumpPricer: steps must be positive");
+        }
+
+        stencils.push_back(Stencil(bump, bump.h, bump.second_h, scenarios));
+
+        if (richardson) stencils.push_back(Stencil(bump, bump.h / 2, bump.second_h / 2, scenarios));
+    }
+}
+
+static double* Column(OptionBatch& batch, enum Parameter parameter) {
+    switch (parameter) {
+        case UNDERLYING: return batch.S();
+        case STRIKE: return batch.K();
+        case TIME: return batch.T();
+        case RATE: return batch.r();
+        case SIGMA: return batch.s();
+        case CARRY: return batch.b();
+        default: throw std::invalid_argument("BumpPricer: unknown parameter");
+    }
+}
+
+static const double* Column(const OptionBatch& batch, enum Parameter parameter) {
+    return Column(const_cast<OptionBatch&>(batch), parameter);
+}
+
+static double Scale(bool relative, double value) {
+    // Step multiplier of one option
+    return relative ? std::max(std::fabs(value), 1.0) : 1.0;
+}
+
+Bump Bump::Forward(enum Parameter parameter, double h, bool relative) {
+    Bump bump;
+    bump.scheme = FORWARD_DIFFERENCE;
+    bump.parameter = bump.second = parameter;
+    bump.h = h;
+    bump.relative = relative;
+    return bump;
+}
+
+Bump Bump::Central(enum Parameter parameter, double h, bool relative) {
+    Bump bump = Forward(parameter, h, relative);
+    bump.scheme = CENTRAL_DIFFERENCE;
+    return bump;
+}
+
+Bump Bump::Second(enum Parameter parameter, double h, bool relative) {
+    Bump bump = Forward(parameter, h, relative);
+    bump.scheme = SECOND_DIFFERENCE;
+    return bump;
+}
+
+Bump Bump::Cross(enum Parameter parameter, double h, enum Parameter second, double second_h, bool relative) {
+    Bump bump = Forward(parameter, h, relative);
+    bump.scheme = CROSS_DIFFERENCE;
+    bump.second = second;
+    bump.second_h = second_h;
+    return bump;
+}
+
+size_t BumpPricer::Scenarios(const vector<Bump>& bumps) const {
+    /*
+     Number of book copies priced by Compute for these bumps
+     */
+
+    vector<BumpScenario> scenarios;
+    vector<BumpStencil> stencils;
+
+    Plan(bumps, m_richardson, scenarios, stencils);
+
+    return scenarios.size();
+}
+
+vector<double> BumpPricer::Compute(const OptionBatch& book, const vector<Bump>& bumps) {
+    /*
+     Sensitivity of every option to every bump. The distinct scenarios are written one after the
+     other into a single batch (copy the book, shift the bumped columns, recompute the carry cost
+     after a RATE shift, then apply a CARRY shift), priced in one BatchPricer pass, and combined
+     input:
+        book, bumps
+     output:
+        bumps.size() * book.Size() sensitivities, bump-major: result[j * book.Size() + i]
+     */
+
+    vector<BumpScenario> scenarios;
+    vector<BumpStencil> stencils;
+
+    Plan(bumps, m_richardson, scenarios, stencils);
+
+    size_t size = book.Size();
+    vector<double> result(bumps.size() * size);
+
+    if (size == 0 || bumps.empty()) return result;
+
+    m_scenarios.Resize(scenarios.size() * size);
+    m_prices.resize(scenarios.size() * size);
+
+    for (size_t j = 0; j < scenarios.size(); j++) {
+
+        size_t offset = j * size;
+        const BumpScenario& scenario = scenarios[j];
+
+        std::memcpy(m_scenarios.S() + offset, book.S(), size * sizeof(double));
+        std::memcpy(m_scenarios.K() + offset, book.K(), size * sizeof(double));
+        std::memcpy(m_scenarios.T() + offset, book.T(), size * sizeof(double));
+        std::memcpy(m_scenarios.r() + offset, book.r(), size * sizeof(double));
+        std::memcpy(m_scenarios.s() + offset, book.s(), size * sizeof(double));
+        std::memcpy(m_scenarios.b() + offset, book.b(), size * sizeof(double));
+        std::memcpy(m_scenarios.CallOrPut() + offset, book.CallOrPut(), size);
+        std::memcpy(m_scenarios.UnderlyingType() + offset, book.UnderlyingType(), size);
+        std::memcpy(m_scenarios.q() + offset, book.q(), size * sizeof(double));
+        std::memcpy(m_scenarios.R() + offset, book.R(), size * sizeof(double));
+
+        for (size_t p = 0; p < BUMP_PARAMETERS; p++) {
+
+            double shift = scenario.shift[p];
+
+            if (shift == 0 || p == CARRY) continue;
+
+            const double* base = Column(book, static_cast<enum Parameter>(p));
+            double* column = Column(m_scenarios, static_cast<enum Parameter>(p)) + offset;
+
+            for (size_t i = 0; i < size; i++) {
+                column[i] += shift * Scale(scenario.relative, base[i]);
+            }
+        }
+
+        if (scenario.shift[RATE] != 0) {
+
+            // The carry moves with the rate, except on futures, as in ScenarioPricer. Shifting
+            // keeps a cost of carry set apart from the asset class rule
+            const double* r = m_scenarios.r() + offset;
+            double* b = m_scenarios.b() + offset;
+
+            for (size_t i = 0; i < size; i++) {
+                if (book.UnderlyingType()[i] != FUTURES) b[i] += r[i] - book.r()[i];
+            }
+        }
+
+        if (scenario.shift[CARRY] != 0) {
+
+            double* b = m_scenarios.b() + offset;
+
+            for (size_t i = 0; i < size; i++) {
+                b[i] += scenario.shift[CARRY] * Scale(scenario.relative, book.b()[i]);
+            }
+        }
+    }
+
+    m_pricer.Price(m_scenarios.View(), m_prices.data());
+
+    size_t levels = m_richardson ? 2 : 1;
+
+    for (size_t j = 0; j < bumps.size(); j++) {
+
+        const Bump& bump = bumps[j];
+        const double* first = Column(book, bump.parameter);
+        const double* second = Column(book, bump.second);
+        double* out = result.data() + j * size;
+
+        // Richardson weight of the h / 2 estimate: the leading error is O(h) for forward differences, O(h^2) otherwise
+        double factor = bump.scheme == FORWARD_DIFFERENCE ? 2 : 4;
+
+        for (size_t i = 0; i < size; i++) {
+
+            double estimate[2] = {0, 0};
+
+            for (size_t level = 0; level < levels; level++) {
+
+                const BumpStencil& stencil = stencils[j * levels + level];
+
+                double sum = 0;
+
+                for (const BumpTerm& term: stencil.terms) sum += term.weight * m_prices[term.scenario * size + i];
+
+                double denominator = stencil.denominator * Scale(bump.relative, first[i]);
+
+                if (stencil.second_order) denominator *= Scale(bump.relative, second[i]);
+
+                estimate[level] = sum / denominator;
+            }
+
+            out[i] = m_richardson ? (factor * estimate[1] - estimate[0]) / (factor - 1) : estimate[0];
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,91 @@
+//
+//  File: BumpPricer.hpp
+//  Project: ExactPricingModels
+//  Objective: Finite-difference sensitivities of a whole book, all bumped scenarios priced in one batch
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef BumpPricer_hpp
+#define BumpPricer_hpp
+
+#include <stdio.h>
+#include "BatchPricer.hpp"
+
+enum DifferenceScheme{ FORWARD_DIFFERENCE, CENTRAL_DIFFERENCE, SECOND_DIFFERENCE, CROSS_DIFFERENCE }; // Finite-difference stencil
+
+struct Bump {
+    /*
+     One finite-difference sensitivity. A RATE bump shifts the carry cost by the same amount
+     except on futures (b = r, r - q, r - R move with r, 0 does not), like Greeks::rho and
+     ScenarioPricer; a CARRY bump moves b alone
+     */
+    enum DifferenceScheme scheme = CENTRAL_DIFFERENCE; // Stencil
+    enum Parameter parameter = UNDERLYING; // Bumped parameter
+    enum Parameter second = UNDERLYING; // Second parameter of a CROSS_DIFFERENCE
+    double h = 1e-4; // Step of parameter
+    double second_h = 1e-4; // Step of second
+    bool relative = false; // Steps are fractions of max(|x|, 1) instead of absolute
+
+    static Bump Forward(enum Parameter parameter, double h, bool relative = false); // dV/dx, (V(x + h) - V(x)) / h
+
+    static Bump Central(enum Parameter parameter, double h, bool relative = false); // dV/dx, (V(x + h) - V(x - h)) / 2h
+
+    static Bump Second(enum Parameter parameter, double h, bool relative = false); // d2V/dx2, (V(x + h) - 2V(x) + V(x - h)) / h^2
+
+    static Bump Cross(enum Parameter parameter, double h, enum Parameter second, double second_h, bool relative = false); // d2V/dxdy, four corners over 4 h k
+};
+
+class BumpPricer {
+    /*
+     Computes a set of bumped sensitivities for every option of a book. Each distinct bumped
+     scenario (base, x + h, x - h, (x + h, y - k), ...) is a full copy of the book laid out
+     contiguously in one OptionBatch, so all of them are priced by BatchPricer in a single
+     vectorized pass; scenarios shared by several bumps (the base, the +/- h points of a
+     central delta and its gamma) are priced once. With Richardson extrapolation every bump is
+     also taken at h / 2 and the two estimates are combined to cancel the leading error term:
+     (2 D(h/2) - D(h)) for forward differences, (4 D(h/2) - D(h)) / 3 for the others
+     */
+
+    // Attributes
+    BatchPricer m_pricer; // Thread pool and chunk size
+    bool m_richardson = false; // Combine h and h / 2 estimates
+    OptionBatch m_scenarios; // Bumped copies of the book, one after the other. Reused between calls
+    vector<double> m_prices; // Prices of m_scenarios
+
+public:
+    /* CANONICAL HEADER START */
+    BumpPricer(){} // Default constructor
+
+    BumpPricer(bool richardson, ThreadPool* pool = nullptr) : m_pricer(pool), m_richardson(richardson) {} // Parameter constructor
+
+    virtual ~BumpPricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    bool Richardson() const {
+        return m_richardson;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Richardson(bool richardson) {
+        this->m_richardson = richardson;
+    }
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    /* SETTERS END */
+
+    vector<double> Compute(const OptionBatch& book, const vector<Bump>& bumps); // Sensitivity of every option to every bump, bump-major: result[j * book.Size() + i]
+
+    size_t Scenarios(const vector<Bump>& bumps) const; // Number of book copies priced by Compute
+
+};
+
+#endif /* BumpPricer_hpp */
@@ -0,0 +1,385 @@
+//
+//  File: ColumnFile.cpp
+//  Project: ExactPricingModels
+//  Objective: Memory-mapped columnar files for option books and pricing results
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ColumnFile.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char* const GREEK_COLUMNS[] = {"price", "delta", "gamma", "vega", "theta", "rho", "carry_rho"}; // GreekMask bit order
+
+static std::runtime_error SystemError(const std::string& what, const std::string& path) {
+    return std::runtime_error(what + " " + path + ": " + strerror(errno));
+}
+
+static size_t AlignUp(size_t offset) {
+    return (offset + COLUMN_ALIGNMENT - 1) / COLUMN_ALIGNMENT * COLUMN_ALIGNMENT;
+}
+
+static size_t ElementSize(uint32_t type) {
+    return type == FLOAT64_COLUMN ? sizeof(double) : sizeof(unsigned char);
+}
+
+ColumnFile::ColumnFile(ColumnFile&& other_file) :
+m_data(other_file.m_data),
+m_size(other_file.m_size),
+m_writable(other_file.m_writable) {
+    /*
+     Move constructor. The other file is left empty
+     */
+    other_file.m_data = nullptr;
+    other_file.m_size = 0;
+    other_file.m_writable = false;
+}
+
+ColumnFile::~ColumnFile() {
+    Unmap();
+}
+
+ColumnFile& ColumnFile::operator = (ColumnFile&& other_file) {
+    /*
+     Move assignment. Releases the current mapping first
+     */
+
+    if (this == &other_file) return *this;
+
+    Unmap();
+
+    m_data = other_file.m_data;
+    m_size = other_file.m_size;
+    m_writable = other_file.m_writable;
+
+    other_file.m_data = nullptr;
+    other_file.m_size = 0;
+    other_file.m_writable = false;
+
+    return *this;
+}
+
+ColumnFile ColumnFile::Open(const std::string& path, bool writable) {
+    /*
+     Map an existing column file. Beyond the header and directory only the one-byte type and
+     underlying columns are read, to reject values outside CallOrPut and UnderlyingType before a
+     kernel indexes with them; the kernel pages the other columns in on demand
+     input:
+        path, whether columns will be written back
+     output:
+        mapped file. Throws std::runtime_error on I/O errors, std::invalid_argument on a bad layout
+     */
+
+    int descriptor = open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+
+    if (descriptor < 0) throw SystemError("cannot open", path);
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw SystemError("cannot stat", path);
+    }
+
+    size_t size = static_cast<size_t>(status.st_size);
+
+    if (size < sizeof(ColumnFileHeader)) {
+        close(descriptor);
+        throw std::invalid_argument(path + ": not a column file");
+    }
+
+    void* data = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, descriptor, 0);
+
+    close(descriptor);
+
+    if (data == MAP_FAILED) throw SystemError("cannot map", path);
+
+    ColumnFile file;
+    file.m_data = static_cast<unsigned char*>(data);
+    file.m_size = size;
+    file.m_writable = writable;
+
+    const ColumnFileHeader& header = file.Header();
+
+    if (memcmp(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::invalid_argument(path + ": not a column file");
+    }
+
+    if (header.version != COLUMN_FILE_VERSION) {
+        throw std::invalid_argument(path + ": unsupported column file version " + std::to_string(header.version));
+    }
+
+    if (sizeof(ColumnFileHeader) + header.columns * sizeof(ColumnEntry) > size) {
+        throw std::invalid_argument(path + ": truncated column directory");
+    }
+
+    for (size_t index = 0; index < header.columns; index++) {
+
+        const ColumnEntry& entry = file.Entry(index);
+
+        bool known = entry.type == FLOAT64_COLUMN || entry.type == UINT8_COLUMN;
+
+        // rows is checked against the file size before the multiply, so a huge count cannot wrap to a valid size
+        if (!known || entry.offset % COLUMN_ALIGNMENT != 0 || header.rows > size / ElementSize(entry.type) ||
+            entry.bytes != header.rows * ElementSize(entry.type) ||
+            entry.offset > size || entry.bytes > size - entry.offset || memchr(entry.name, 0, sizeof(entry.name)) == nullptr) {
+            throw std::invalid_argument(path + ": corrupt column entry " + std::to_string(index));
+        }
+
+        // Enumeration columns hold one CallOrPut or UnderlyingType value per row
+        unsigned largest;
+
+        if (strcmp(entry.name, "type") == 0) largest = PUT;
+        else if (strcmp(entry.name, "underlying") == 0) largest = CURRENCY;
+        else continue;
+
+        if (entry.type != UINT8_COLUMN) throw std::invalid_argument(path + ": column " + entry.name + " has another type");
+
+        const unsigned char* values = file.m_data + entry.offset;
+
+        for (size_t row = 0; row < header.rows; row++) {
+            if (values[row] > largest) {
+                throw std::invalid_argument(path + ": column " + entry.name + " has out-of-range value " + std::to_string(values[row]) + " at row " + std::to_string(row));
+            }
+        }
+    }
+
+    return file;
+}
+
+ColumnFile ColumnFile::Create(const std::string& path, size_t rows, const vector<ColumnSpec>& columns) {
+    /*
+     Create (or truncate) a column file with zeroed columns and map it for writing. The file is
+     sized up front, so the columns can be filled in place by the batch kernels
+     input:
+        path, elements per column, column names and types
+     output:
+        writable mapped file
+     */
+
+    size_t offset = AlignUp(sizeof(ColumnFileHeader) + columns.size() * sizeof(ColumnEntry));
+
+    vector<ColumnEntry> entries(columns.size());
+
+    for (size_t index = 0; index < columns.size(); index++) {
+
+        if (columns[index].name.empty() || columns[index].name.size() >= sizeof(entries[index].name)) {
+            throw std::invalid_argument("column name must have 1 to 23 characters: " + columns[index].name);
+        }
+
+        ColumnEntry& entry = entries[index];
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, columns[index].name.data(), columns[index].name.size());
+        entry.type = columns[index].type;
+        entry.offset = offset;
+        entry.bytes = rows * ElementSize(entry.type);
+
+        offset = AlignUp(offset + entry.bytes);
+    }
+
+    int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (descriptor < 0) throw SystemError("cannot create", path);
+
+    if (ftruncate(descriptor, static_cast<off_t>(offset)) != 0) {
+        close(descriptor);
+        throw SystemError("cannot size", path);
+    }
+
+    void* data = mmap(nullptr, offset, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+
+    close(descriptor);
+
+    if (data == MAP_FAILED) throw SystemError("cannot map", path);
+
+    ColumnFile file;
+    file.m_data = static_cast<unsigned char*>(data);
+    file.m_size = offset;
+    file.m_writable = true;
+
+    ColumnFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic));
+    header.version = COLUMN_FILE_VERSION;
+    header.columns = static_cast<uint32_t>(columns.size());
+    header.rows = rows;
+
+    memcpy(file.m_data, &header, sizeof(header));
+
+    if (!entries.empty()) memcpy(file.m_data + sizeof(header), entries.data(), entries.size() * sizeof(ColumnEntry));
+
+    return file;
+}
+
+const ColumnEntry& ColumnFile::Entry(size_t index) const {
+    return reinterpret_cast<const ColumnEntry*>(m_data + sizeof(ColumnFileHeader))[index];
+}
+
+bool ColumnFile::Has(const std::string& name) const {
+
+    for (size_t index = 0; index < Columns(); index++) {
+        if (name == Entry(index).name) return true;
+    }
+
+    return false;
+}
+
+const ColumnEntry* ColumnFile::Find(const std::string& name, enum ColumnType type) const {
+    /*
+     Directory entry of a column
+     output:
+        entry, throws std::invalid_argument when the column is missing or has another type
+     */
+
+    for (size_t index = 0; index < Columns(); index++) {
+
+        const ColumnEntry& entry = Entry(index);
+
+        if (name != entry.name) continue;
+
+        if (entry.type != static_cast<uint32_t>(type)) throw std::invalid_argument("column " + name + " has another type");
+
+        return &entry;
+    }
+
+    throw std::invalid_argument("missing column " + name);
+}
+
+const double* ColumnFile::Doubles(const std::string& name) const {
+    return reinterpret_cast<const double*>(m_data + Find(name, FLOAT64_COLUMN)->offset);
+}
+
+double* ColumnFile::Doubles(const std::string& name) {
+    if (!m_writable) throw std::logic_error("column file is mapped read-only");
+    return reinterpret_cast<double*>(m_data + Find(name, FLOAT64_COLUMN)->offset);
+}
+
+const unsigned char* ColumnFile::Bytes(const std::string& name) const {
+    return m_data + Find(name, UINT8_COLUMN)->offset;
+}
+
+unsigned char* ColumnFile::Bytes(const std::string& name) {
+    if (!m_writable) throw std::logic_error("column file is mapped read-only");
+    return m_data + Find(name, UINT8_COLUMN)->offset;
+}
+
+void ColumnFile::Sync() {
+    /*
+     Write dirty pages back to the file. Unmapping also does this, lazily
+     */
+
+    if (m_data && m_writable && msync(m_data, m_size, MS_SYNC) != 0) {
+        throw std::runtime_error(std::string("cannot sync column file: ") + strerror(errno));
+    }
+}
+
+void ColumnFile::Unmap() {
+
+    if (m_data) munmap(m_data, m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_writable = false;
+}
+
+vector<ColumnSpec> BookColumns() {
+    /*
+     One column per Option field
+     */
+    return {
+        {"S", FLOAT64_COLUMN}, {"K", FLOAT64_COLUMN}, {"T", FLOAT64_COLUMN}, {"r", FLOAT64_COLUMN},
+        {"sigma", FLOAT64_COLUMN}, {"b", FLOAT64_COLUMN}, {"type", UINT8_COLUMN}, {"underlying", UINT8_COLUMN},
+        {"q", FLOAT64_COLUMN}, {"R", FLOAT64_COLUMN}
+    };
+}
+
+vector<ColumnSpec> ResultColumns(unsigned mask) {
+    /*
+     One FLOAT64 column per requested output, in GreekMask bit order
+     */
+    vector<ColumnSpec> columns;
+
+    for (unsigned bit = 0; bit < 7; bit++) {
+        if (mask & (1u << bit)) columns.push_back({GREEK_COLUMNS[bit], FLOAT64_COLUMN});
+    }
+
+    return columns;
+}
+
+OptionBatchView BookView(const ColumnFile& file) {
+    /*
+     Pricer view over a mapped book. No data is copied; pages are faulted in as the kernels reach them
+     */
+
+    OptionBatchView view;
+    view.size = file.Rows();
+    view.S = file.Doubles("S");
+    view.K = file.Doubles("K");
+    view.T = file.Doubles("T");
+    view.r = file.Doubles("r");
+    view.s = file.Doubles("sigma");
+    view.b = file.Doubles("b");
+    view.call_or_put = file.Bytes("type");
+    view.underlying_type = file.Bytes("underlying");
+    view.q = file.Doubles("q");
+    view.R = file.Doubles("R");
+
+    return view;
+}
+
+GreeksColumns ResultView(ColumnFile& file, unsigned mask) {
+    /*
+     Output columns for the fused kernels, written straight into the mapping
+     */
+
+    double** targets[7];
+    GreeksColumns columns;
+
+    targets[0] = &columns.price;
+    targets[1] = &columns.delta;
+    targets[2] = &columns.gamma;
+    targets[3] = &columns.vega;
+    targets[4] = &columns.theta;
+    targets[5] = &columns.rho;
+    targets[6] = &columns.carry_rho;
+
+    for (unsigned bit = 0; bit < 7; bit++) {
+        if (mask & (1u << bit)) *targets[bit] = file.Doubles(GREEK_COLUMNS[bit]);
+    }
+
+    return columns;
+}
+
+void WriteBook(const std::string& path, const OptionBatchView& book) {
+    /*
+     Save a book in the columnar format. Missing dividend or foreign rate columns are written as zeros
+     */
+
+    ColumnFile file = ColumnFile::Create(path, book.size, BookColumns());
+
+    if (book.size == 0) return;
+
+    size_t doubles = book.size * sizeof(double);
+
+    memcpy(file.Doubles("S"), book.S, doubles);
+    memcpy(file.Doubles("K"), book.K, doubles);
+    memcpy(file.Doubles("T"), book.T, doubles);
+    memcpy(file.Doubles("r"), book.r, doubles);
+    memcpy(file.Doubles("sigma"), book.s, doubles);
+    memcpy(file.Doubles("b"), book.b, doubles);
+    memcpy(file.Bytes("type"), book.call_or_put, book.size);
+
+    if (book.underlying_type) memcpy(file.Bytes("underlying"), book.underlying_type, book.size);
+    if (book.q) memcpy(file.Doubles("q"), book.q, doubles);
+    if (book.R) memcpy(file.Doubles("R"), book.R, doubles);
+
+    file.Sync();
+}
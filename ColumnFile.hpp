@@ -0,0 +1,133 @@
+//
+//  File: ColumnFile.hpp
+//  Project: ExactPricingModels
+//  Objective: Memory-mapped columnar files for option books and pricing results
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ColumnFile_hpp
+#define ColumnFile_hpp
+
+#include <stdio.h>
+#include <cstdint>
+#include <string>
+#include "OptionBatch.hpp"
+#include "Greeks.hpp"
+
+/*
+ File layout, native byte order:
+    ColumnFileHeader                     32 bytes
+    ColumnEntry x header.columns         48 bytes each
+    column data                          each column starts on a COLUMN_ALIGNMENT boundary
+ Readers reject other magics and versions. Columns are found by name, so extra columns can be
+ added without breaking existing readers
+ */
+
+const char COLUMN_FILE_MAGIC[8] = {'E', 'P', 'M', 'C', 'O', 'L', 'S', 0}; // First bytes of every column file
+
+const uint32_t COLUMN_FILE_VERSION = 1; // Layout version written by this code
+
+enum ColumnType{ FLOAT64_COLUMN, UINT8_COLUMN }; // Element type of a column
+
+struct ColumnFileHeader {
+    char magic[8]; // COLUMN_FILE_MAGIC
+    uint32_t version; // COLUMN_FILE_VERSION
+    uint32_t columns; // Entries in the column directory
+    uint64_t rows; // Elements in every column
+    uint64_t reserved; // Zero
+};
+
+struct ColumnEntry {
+    char name[24]; // Zero-terminated column name
+    uint32_t type; // ColumnType
+    uint32_t reserved; // Zero
+    uint64_t offset; // Byte offset of the first element from the start of the file
+    uint64_t bytes; // Size of the column data
+};
+
+static_assert(sizeof(ColumnFileHeader) == 32, "ColumnFileHeader must stay 32 bytes");
+static_assert(sizeof(ColumnEntry) == 48, "ColumnEntry must stay 48 bytes");
+
+struct ColumnSpec {
+    std::string name; // Column name, at most 23 characters
+    enum ColumnType type; // Element type
+};
+
+class ColumnFile {
+
+    // Attributes
+    unsigned char* m_data = nullptr; // Start of the mapping
+    size_t m_size = 0; // Mapped bytes
+    bool m_writable = false; // Mapped for writing
+
+public:
+    /* CANONICAL HEADER START */
+    ColumnFile(){} // Default constructor, no file
+
+    ColumnFile(const ColumnFile& other_file) = delete; // Not copyable
+
+    ColumnFile(ColumnFile&& other_file); // Move constructor
+
+    virtual ~ColumnFile(); // Destructor. Unmaps the file
+
+    ColumnFile& operator = (const ColumnFile& other_file) = delete; // Not assignable
+
+    ColumnFile& operator = (ColumnFile&& other_file); // Move assignment
+    /* CANONICAL HEADER END */
+
+    static ColumnFile Open(const std::string& path, bool writable = false); // Map an existing file and check its type and underlying values, other pages are read on first access
+
+    static ColumnFile Create(const std::string& path, size_t rows, const vector<ColumnSpec>& columns); // Create or truncate a file and map it for writing
+
+    /* GETTERS START */
+
+    size_t Rows() const {
+        return m_data ? static_cast<size_t>(Header().rows) : 0;
+    }
+
+    size_t Columns() const {
+        return m_data ? Header().columns : 0;
+    }
+
+    bool Writable() const {
+        return m_writable;
+    }
+
+    /* GETTERS END */
+
+    const ColumnEntry& Entry(size_t index) const; // Directory entry of a column
+
+    bool Has(const std::string& name) const; // Whether a column exists
+
+    const double* Doubles(const std::string& name) const; // FLOAT64 column. Throws if it does not exist
+    double* Doubles(const std::string& name); // Writable FLOAT64 column
+
+    const unsigned char* Bytes(const std::string& name) const; // UINT8 column. Throws if it does not exist
+    unsigned char* Bytes(const std::string& name); // Writable UINT8 column
+
+    void Sync(); // Flush written pages to the file
+
+    // Helper functions
+private:
+    const ColumnFileHeader& Header() const {
+        return *reinterpret_cast<const ColumnFileHeader*>(m_data);
+    }
+
+    const ColumnEntry* Find(const std::string& name, enum ColumnType type) const; // Entry of a column with the given type
+
+    void Unmap(); // Release the mapping
+
+};
+
+vector<ColumnSpec> BookColumns(); // S, K, T, r, sigma, b, type, underlying, q, R
+
+vector<ColumnSpec> ResultColumns(unsigned mask); // Requested GreekMask outputs, named price, delta, ...
+
+OptionBatchView BookView(const ColumnFile& file); // Pricer view straight over the mapped book columns
+
+GreeksColumns ResultView(ColumnFile& file, unsigned mask); // Writable result columns of a file made with ResultColumns(mask)
+
+void WriteBook(const std::string& path, const OptionBatchView& book); // Save a book in the columnar format
+
+#endif /* ColumnFile_hpp */
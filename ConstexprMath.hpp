@@ -0,0 +1,139 @@
+//
+//  File: ConstexprMath.hpp
+//  Project: ExactPricingModels
+//  Objective: exp, log, sqrt and normal distribution usable in constant expressions
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ConstexprMath_hpp
+#define ConstexprMath_hpp
+
+#include <stdio.h>
+#include <limits>
+
+/*
+ The <cmath> functions cannot be evaluated at compile time, so the templated kernels of BlackScholes.hpp
+ switch to these when std::is_constant_evaluated(). They favour accuracy (1e-14 relative or better) over
+ speed and are not meant for runtime use; NormalMath provides the runtime kernels
+ */
+
+constexpr double CONSTEXPR_LN2 = 0.693147180559945309417232121458176568; // log(2)
+constexpr double CONSTEXPR_INV_SQRT_2PI = 0.398942280401432677939946059934381868; // 1/sqrt(2*pi)
+
+constexpr double ConstexprScale2(double x, int exponent) {
+    /*
+     x * 2^exponent by repeated doubling or halving, exact while no overflow or underflow occurs
+     */
+    while (exponent > 0) { x *= 2.0; exponent--; }
+    while (exponent < 0) { x *= 0.5; exponent++; }
+    return x;
+}
+
+constexpr double ConstexprExp(double x) {
+    /*
+     exp(x) = 2^k * exp(t), k = round(x / log 2), |t| <= log(2)/2, exp(t) by its Taylor series
+     */
+    if (x != x) return x;
+    if (x > 709.8) return std::numeric_limits<double>::infinity();
+    if (x < -745.2) return 0.0;
+
+    int k = static_cast<int>(x / CONSTEXPR_LN2 + (x < 0 ? -0.5 : 0.5));
+
+    // log(2) split so that k * LN2_HI is exact
+    double t = (x - k * 0.693145751953125) - k * 1.42860682030941723212e-6;
+
+    double term = 1.0, sum = 1.0;
+
+    for (int n = 1; n < 30; n++) {
+        term *= t / n;
+        sum += term;
+    }
+
+    return ConstexprScale2(sum, k);
+}
+
+constexpr double ConstexprLog(double x) {
+    /*
+     log(x) = e * log 2 + log(m), x = m * 2^e with m in [sqrt(1/2), sqrt(2)),
+     log(m) = 2 * atanh(z) = 2 * (z + z^3/3 + z^5/5 + ...), z = (m - 1) / (m + 1)
+     */
+    if (x != x || x < 0) return std::numeric_limits<double>::quiet_NaN();
+    if (x == 0) return -std::numeric_limits<double>::infinity();
+    if (x == std::numeric_limits<double>::infinity()) return x;
+
+    int e = 0;
+    double m = x;
+
+    while (m >= 1.4142135623730951) { m *= 0.5; e++; }
+    while (m < 0.7071067811865476) { m *= 2.0; e--; }
+
+    double z = (m - 1.0) / (m + 1.0);
+    double z2 = z * z;
+    double power = z, sum = 0.0;
+
+    for (int n = 1; n < 80; n += 2) {
+        sum += power / n;
+        power *= z2;
+    }
+
+    return e * CONSTEXPR_LN2 + 2.0 * sum;
+}
+
+constexpr double ConstexprSqrt(double x) {
+    /*
+     Newton iterations y <- (y + x/y) / 2, started from a power of two near sqrt(x)
+     */
+    if (x != x || x < 0) return std::numeric_limits<double>::quiet_NaN();
+    if (x == 0 || x == std::numeric_limits<double>::infinity()) return x;
+
+    double y = 1.0;
+    double z = x;
+
+    while (z >= 4.0) { z *= 0.25; y *= 2.0; }
+    while (z < 0.25) { z *= 4.0; y *= 0.5; }
+
+    for (int n = 0; n < 8; n++) y = 0.5 * (y + x / y);
+
+    return y;
+}
+
+constexpr double ConstexprNormalPdf(double x) {
+    return CONSTEXPR_INV_SQRT_2PI * ConstexprExp(-0.5 * x * x);
+}
+
+constexpr double ConstexprNormalCdf(double x) {
+    /*
+     N(x). Near the centre N(x) = 1/2 + n(x) * (x + x^3/3 + x^5/(3*5) + ...), a series of positive
+     terms. In the tails the Mills ratio continued fraction gives the upper tail Q(|x|) = n(x) / (|x| + 1/(|x| + 2/(|x| + ...)))
+     without cancellation
+     */
+    if (x != x) return x;
+
+    double y = x < 0 ? -x : x;
+
+    if (y < 2.0) {
+
+        double term = x, sum = x;
+
+        for (int n = 1; n < 200 && term != 0; n++) {
+            term *= x * x / (2 * n + 1);
+            sum += term;
+        }
+
+        return 0.5 + ConstexprNormalPdf(x) * sum;
+    }
+
+    if (y > 40.0) return x < 0 ? 0.0 : 1.0;
+
+    // Continued fraction evaluated from the back, depth chosen for convergence down to |x| = 2
+    double fraction = y;
+
+    for (int n = 400; n > 0; n--) fraction = y + n / fraction;
+
+    double tail = ConstexprNormalPdf(y) / fraction;
+
+    return x < 0 ? tail : 1.0 - tail;
+}
+
+#endif /* ConstexprMath_hpp */
@@ -7,13 +7,125 @@
 //
 
 #include "EuropeanOption.hpp"
+#include "BatchPricer.hpp"
+#include "BlackScholes.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "ResultCache.hpp"
+#include "ThreadPool.hpp"
 #include "cmath"
 
-#include <boost/math/distributions/normal.hpp>
+#include <stdexcept>
+
+const size_t GRID_CHUNK = 1024; // Inner axis elements per grid work unit
+const size_t GRID_PARALLEL_THRESHOLD = 1 << 16; // Grid points from which grid pricing is split across threads
+const size_t MESH_CHUNK = 4096; // Mesh elements per thread pool task
+const size_t MESH_PARALLEL_THRESHOLD = 1 << 15; // Mesh size from which mesh evaluation is split across threads
+
+template <typename Body>
+static void ForEachMeshChunk(size_t size, const Body& body) {
+    /*
+     Run body over [0, size), on the shared thread pool when the mesh is large enough to pay off.
+     body is passed by reference so the ThreadPool::RangeTask wrapping it does not allocate;
+     only queuing chunks for other threads does
+     */
+    if (size < MESH_PARALLEL_THRESHOLD) {
+        body(0, size);
+        return;
+    }
+    
+    ThreadPool::Instance().ParallelFor(0, size, MESH_CHUNK, std::cref(body));
+}
+
+static void CheckMeshOutput(size_t mesh_size, size_t output_size, const char* function) {
+    if (output_size != mesh_size) {
+        throw std::invalid_argument(string(function) + ": output size differs from mesh size");
+    }
+}
+
+template <typename Evaluate>
+static void ForEachMeshBlock(const MeshView& mesh, size_t begin, size_t end, const Evaluate& evaluate) {
+    /*
+     Hand points [begin, end) of a mesh to evaluate(first index, points, count). Stored points are
+     passed in place; generated points are computed block by block into a buffer that stays in L1
+     */
+    if (const double* data = mesh.Data()) {
+        evaluate(begin, data + begin, end - begin);
+        return;
+    }
+    
+    alignas(COLUMN_ALIGNMENT) double points[BATCH_BLOCK];
+    
+    for (size_t start = begin; start < end; start += BATCH_BLOCK) {
+        size_t count = end - start < BATCH_BLOCK ? end - start : BATCH_BLOCK;
+        mesh.Fill(start, count, points);
+        evaluate(start, points, count);
+    }
+}
+
+template <typename Block>
+static void EvaluateMesh(const MeshView& mesh, span<double> values, const Block& block) {
+    /*
+     values[i] from mesh point i, with block(points, values, count) evaluating a block of points
+     */
+    ForEachMeshChunk(mesh.Size(), [&](size_t begin, size_t end) {
+        ForEachMeshBlock(mesh, begin, end, [&](size_t start, const double* points, size_t count) {
+            block(points, values.data() + start, count);
+        });
+    });
+}
+
+template <typename Block>
+static void StreamMesh(const MeshView& mesh, const MeshBlockSink& sink, const Block& block) {
+    /*
+     Evaluate the mesh on the calling thread and pass the results to sink block by block, in order
+     */
+    alignas(COLUMN_ALIGNMENT) double values[BATCH_BLOCK];
+    
+    for (size_t begin = 0; begin < mesh.Size(); begin += BATCH_BLOCK) {
+        size_t end = mesh.Size() - begin < BATCH_BLOCK ? mesh.Size() : begin + BATCH_BLOCK;
+        ForEachMeshBlock(mesh, begin, end, [&](size_t start, const double* points, size_t count) {
+            block(points, values, count);
+            sink(start, values, count);
+        });
+    }
+}
+
+template <typename Body>
+static void WithParameter(enum Parameter parameter, Body&& body) {
+    /*
+     Branch once on a mesh parameter, then run body with it as a compile-time constant,
+     e.g. [&](auto parameter) { Kernel::template PriceMesh<decltype(parameter)::value>(...); }
+     */
+    switch (parameter) {
+        case UNDERLYING:
+            body(std::integral_constant<enum Parameter, UNDERLYING>());
+            break;
+        case STRIKE:
+            body(std::integral_constant<enum Parameter, STRIKE>());
+            break;
+        case TIME:
+            body(std::integral_constant<enum Parameter, TIME>());
+            break;
+        case RATE:
+            body(std::integral_constant<enum Parameter, RATE>());
+            break;
+        case SIGMA:
+            body(std::integral_constant<enum Parameter, SIGMA>());
+            break;
+        case CARRY:
+            body(std::integral_constant<enum Parameter, CARRY>());
+            break;
+        default:
+            break;
+    }
+}
 
 
 EuropeanOption::EuropeanOption(const EuropeanOption& other_option) :
-Option(other_option) {
+Option(other_option),
+m_terms(other_option.m_terms),
+m_cache(other_option.m_cache) {
     /*
      Copy constructor
      */
@@ -39,8 +151,11 @@ Option(underlying_price,
        dividend_yield,
        foreign_rate) {
     /*
-     Parameter constructor
+     Parameter constructor. The pricing terms are computed up front, so a new option can be priced
+     from several threads at once
      */
+    
+    TermsChanged(ALL_TERMS);
 }
 
 EuropeanOption& EuropeanOption::operator = (const EuropeanOption& other_option){
@@ -54,6 +169,10 @@ EuropeanOption& EuropeanOption::operator = (const EuropeanOption& other_option){
     
     Option::operator=(other_option);
     
+    m_terms = other_option.m_terms;
+    
+    m_cache = other_option.m_cache;
+    
     return *this;
 }
 
@@ -61,318 +180,550 @@ double EuropeanOption::Price() const {
     /*
      Price the option based on Call/Put attribute
      */
-    return CallOrPut() == CALL ? PriceAsCall() : PriceAsPut() ;
+    if (m_cache) return Cached(GREEK_PRICE).price;
+    
+    METRIC_RETURN(TIMER_PRICE, WithKernel(CallOrPut(), [&](auto kernel) {
+        return decltype(kernel)::Price(S(), K(), Terms());
+    }));
 }
 
-double EuropeanOption::PriceAsCall() const {
+vector<double> EuropeanOption::Price(double price) const {
     /*
-     Price as a call option
+     Price the option using put-call parity
+     input:
+        option price
+     output:
+        vector with option price and parity difference
      */
     
-    double temp =  s() * sqrt(T());
+    ParityResult parity = Parity(price);
     
-    double d1 = ( log(S()/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
-    
-    double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), d1);
+    return {parity.price, parity.difference};
+}
+
+ParityResult EuropeanOption::Parity(double price) const {
+    /*
+     Price the option using put-call parity, without allocating
+     input:
+        option price
+     output:
+        price of the opposite option type and parity difference
+     */
     
-    double d2 = d1 - temp;
+    double temp = K() * Terms().discount;
     
-    double Nd2 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), d2);
+    ParityResult parity;
     
-    double SebrT = S() * exp( (b() - r()) * T() );
+    parity.price = CallOrPut() == CALL ? ( price + temp - S() ) :
+    ( price + S() - temp );
     
-    double KerT = K() * exp( - r() * T() );
+    parity.difference = CallOrPut() == CALL ? ( price + temp - (parity.price + S()) ) :
+    ( parity.price + temp - (price + S()) ) ;
     
-    return SebrT*Nd1 - KerT*Nd2;
+    return parity;
 }
 
-double EuropeanOption::PriceAsPut() const {
+// Price the option using an array of parameters
+vector<double> EuropeanOption::Price(const vector<double>& parameter_mesh, enum Parameter parameter) const {
     /*
-     Price as a put option
+     Price the option using an array of parameters
+     input:
+        parameter mesh
+        parameter type
+     output:
+        vector with prices
      */
     
-    double temp =  s() * sqrt(T());
+    vector<double> prices(parameter_mesh.size());
     
-    double d1 = ( log(S()/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
+    Price(parameter_mesh, parameter, prices);
     
-    double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), -d1);
-    
-    double d2 = d1 - temp;
+    return prices;
+}
+
+void EuropeanOption::Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const {
+    /*
+     Price the option using an array of parameters into a caller-provided array. Meshes below
+     MESH_PARALLEL_THRESHOLD, or any mesh on a single-threaded pool, are priced without allocating
+     input:
+        parameter mesh
+        parameter type
+        prices, same size as the mesh
+     */
     
-    double Nd2 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), -d2);
+    Price(MeshView(parameter_mesh), parameter, prices);
+}
+
+void EuropeanOption::Price(const MeshView& parameter_mesh, enum Parameter parameter, span<double> prices) const {
+    /*
+     Price the option over a mesh into a caller-provided array. Generated points are computed
+     block by block and never stored
+     input:
+        parameter mesh
+        parameter type
+        prices, same size as the mesh
+     */
     
-    double SebrT = S() * exp( (b() - r()) * T() );
+    METRIC_SCOPE(TIMER_MESH, parameter_mesh.Size());
     
-    double KerT = K() * exp( - r() * T() );
+    CheckMeshOutput(parameter_mesh.Size(), prices.size(), "EuropeanOption::Price");
     
-    return KerT*Nd2 - SebrT*Nd1;
+    double S = Option::S(), K = Option::K(), T = Option::T(), r = Option::r(), s = Option::s(), b = Option::b();
     
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        WithParameter(parameter, [&](auto varied) {
+            EvaluateMesh(parameter_mesh, prices, [&](const double* points, double* values, size_t count) {
+                decltype(kernel)::template PriceMesh<decltype(varied)::value>(S, K, T, r, s, b, points, values, count);
+            });
+        });
+    });
 }
 
-vector<double> EuropeanOption::Price(double price) const {
+void EuropeanOption::Price(const MeshView& parameter_mesh, enum Parameter parameter, const MeshBlockSink& sink) const {
     /*
-     Price the option using put-call parity
+     Price the option over a mesh without storing points or prices: sink(first index, prices, count)
+     receives consecutive blocks of at most BATCH_BLOCK prices, in order, on the calling thread
      input:
-        option price
-     output:
-        vector with option price and parity difference
+        parameter mesh
+        parameter type
+        sink
      */
     
-    double temp = K() * exp( - r() * T() );
-    
-    double parity_price = CallOrPut() == CALL ? ( price + temp - S() ) :
-    ( price + S() - temp );
+    METRIC_SCOPE(TIMER_MESH, parameter_mesh.Size());
     
-    double parity_difference = CallOrPut() == CALL ? ( price + temp - (parity_price + S()) ) :
-    ( parity_price + temp - (price + S()) ) ;
+    double S = Option::S(), K = Option::K(), T = Option::T(), r = Option::r(), s = Option::s(), b = Option::b();
     
-    return {parity_price, parity_difference};
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        WithParameter(parameter, [&](auto varied) {
+            StreamMesh(parameter_mesh, sink, [&](const double* points, double* values, size_t count) {
+                decltype(kernel)::template PriceMesh<decltype(varied)::value>(S, K, T, r, s, b, points, values, count);
+            });
+        });
+    });
 }
 
-// Price the option using an array of parameters
-vector<double> EuropeanOption::Price(vector<double>& parameter_mesh, enum Parameter parameter) const {
+vector<double> EuropeanOption::Price(const vector<GridAxis>& axes, enum Precision precision) const {
     /*
-     Price the option using an array of parameters
+     Price the option over a Cartesian grid of parameters
      input:
-        parameter mesh
-        parameter type
+        grid axes, first axis outermost, precision of the distribution kernels
      output:
-        vector with prices
+        row-major tensor of prices
      */
     
-    vector<double> prices;
-    bool is_call = CallOrPut() == CALL;
+    size_t size = 1;
     
-    switch(parameter){
-        case UNDERLYING:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(element, -1, -1, -1, -1, -1));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(element, -1, -1, -1, -1, -1));
-            }
-            
-            break;
-        case STRIKE:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(-1, element, -1, -1, -1, -1));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(-1, element, -1, -1, -1, -1));
-            }
-            
-            break;
-        case TIME:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(-1, -1, element, -1, -1, -1));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(-1, -1, element, -1, -1, -1));
-            }
-            
-            break;
-        case RATE:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(-1, -1, -1, element, -1, -1));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(-1, -1, -1, element, -1, -1));
-            }
-            
-            break;
-        case SIGMA:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(-1, -1, -1, -1, element, -1));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(-1, -1, -1, -1, element, -1));
-            }
-            
-            break;
-        case CARRY:
-            
-            if(is_call){
-                for(double element: parameter_mesh) prices.push_back(PriceAsCall(-1, -1, -1, -1, -1, element));
-            } else {
-                for(double element: parameter_mesh) prices.push_back(PriceAsPut(-1, -1, -1, -1, -1, element));
-            }
-            
-            break;
-        default:
-            break;
-    }
+    for (const GridAxis& axis: axes) size *= axis.Mesh().Size();
+    
+    vector<double> prices(size);
+    
+    Price(axes, prices.data(), precision);
     
     return prices;
 }
 
-double EuropeanOption::PriceAsCall(double i_S, double i_K, double i_T, double i_r, double i_s, double i_b) const {
+void EuropeanOption::Price(const vector<GridAxis>& axes, double* prices, enum Precision precision) const {
     /*
-     Price as a call option using a parameter
+     Price the option over a Cartesian grid of parameters. Parameters without an axis keep the
+     option's value. The output is row-major with the last axis varying fastest, i.e. for axes
+     (S, sigma, T) the price at (i, j, k) is prices[(i * n_sigma + j) * n_T + k]
+     The grid is cut into work units of up to GRID_CHUNK points of the innermost axis;
+     large grids are spread over the shared thread pool. MIXED_PRECISION evaluates N in single
+     precision (price error below 2e-7 * (S*e^((b-r)T) + K*e^(-rT)), see BatchPricer)
      input:
-        desired parameter
-     output:
-        price
+        grid axes, each parameter at most once
+        output tensor with the product of the mesh sizes elements
+        precision of the distribution kernels
      */
     
-    double S = i_S == -1 ? Option::S() : i_S;
-    double K = i_K == -1 ? Option::K() : i_K;
-    double T = i_T == -1 ? Option::T() : i_T;
-    double r = i_r == -1 ? Option::r() : i_r;
-    double s = i_s == -1 ? Option::s() : i_s;
-    double b = i_b == -1 ? Option::b() : i_b;
+    bool seen[CARRY + 1] = {false};
     
-    double temp =  s * sqrt(T);
+    size_t size = 1;
     
-    double d1 = ( log(S/K) + (b + (s*s / 2.0) ) * T ) / temp;
+    for (const GridAxis& axis: axes) {
+        if (axis.parameter < UNDERLYING || axis.parameter > CARRY || seen[axis.parameter]) {
+            throw std::invalid_argument("EuropeanOption::Price: grid axes must be distinct parameters");
+        }
+        seen[axis.parameter] = true;
+        size *= axis.Mesh().Size();
+    }
     
-    double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), d1);
+    if (size == 0) return;
     
-    double d2 = d1 - temp;
+    METRIC_SCOPE(TIMER_MESH, size);
     
-    double Nd2 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), d2);
+    size_t inner = axes.empty() ? 1 : axes.back().Mesh().Size();
     
-    double SebrT = S * exp( (b - r) * T );
+    size_t units = (size / inner) * ((inner + GRID_CHUNK - 1) / GRID_CHUNK);
     
-    double KerT = K * exp( - r * T );
+    if (size < GRID_PARALLEL_THRESHOLD) {
+        PriceGridRows(axes, 0, units, prices, precision);
+        return;
+    }
     
-    return SebrT*Nd1 - KerT*Nd2;
+    ThreadPool::Instance().ParallelFor(0, units, 1, [&](size_t begin, size_t end) {
+        PriceGridRows(axes, begin, end, prices, precision);
+    });
 }
 
-double EuropeanOption::PriceAsPut(double i_S, double i_K, double i_T, double i_r, double i_s, double i_b) const {
+void EuropeanOption::PriceGridRows(const vector<GridAxis>& axes, size_t first_unit, size_t last_unit, double* prices, enum Precision precision) const {
     /*
-     Price as a put option using a parameter
+     Price a range of grid work units. A unit is a chunk of one row of the innermost axis.
+     The parameters of a row are decoded from its index and the chunk is priced by the
+     BlackScholes mesh kernel of the innermost parameter, which computes the row invariants once.
+     Lazy axes are generated point by point, the innermost one in blocks
      input:
-        desired parameter
-     output:
-        price
+        grid axes, unit range, output tensor, precision of the distribution kernels
      */
     
-    double S = i_S == -1 ? Option::S() : i_S;
-    double K = i_K == -1 ? Option::K() : i_K;
-    double T = i_T == -1 ? Option::T() : i_T;
-    double r = i_r == -1 ? Option::r() : i_r;
-    double s = i_s == -1 ? Option::s() : i_s;
-    double b = i_b == -1 ? Option::b() : i_b;
+    if (axes.empty()) {
+        prices[0] = Price();
+        return;
+    }
     
-    double temp =  s * sqrt(T);
+    const GridAxis& inner_axis = axes.back();
+    
+    MeshView inner_mesh = inner_axis.Mesh();
+    
+    size_t inner = inner_mesh.Size();
+    
+    size_t chunks = (inner + GRID_CHUNK - 1) / GRID_CHUNK;
+    
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        WithParameter(inner_axis.parameter, [&](auto varied) {
+            for (size_t unit = first_unit; unit < last_unit; unit++) {
+                
+                size_t row = unit / chunks;
+                
+                size_t begin = (unit % chunks) * GRID_CHUNK;
+                
+                size_t end = begin + GRID_CHUNK < inner ? begin + GRID_CHUNK : inner;
+                
+                // Parameters of the row, outer axes decoded from the row index
+                double p[CARRY + 1] = { S(), K(), T(), r(), s(), b() };
+                
+                size_t remainder = row;
+                
+                for (size_t axis = axes.size() - 1; axis-- > 0;) {
+                    MeshView mesh = axes[axis].Mesh();
+                    p[axes[axis].parameter] = mesh[remainder % mesh.Size()];
+                    remainder /= mesh.Size();
+                }
+                
+                ForEachMeshBlock(inner_mesh, begin, end, [&](size_t start, const double* points, size_t count) {
+                    decltype(kernel)::template PriceMesh<decltype(varied)::value>(p[UNDERLYING], p[STRIKE], p[TIME], p[RATE], p[SIGMA], p[CARRY],
+                                                                                   points, prices + row * inner + start, count, precision);
+                });
+            }
+        });
+    });
+}
+
+
+// Compute delta
+double EuropeanOption::Delta() const {
+    /*
+     Compute delta
+     */
+
+    if (m_cache) return Cached(GREEK_DELTA).delta;
+
+    METRIC_RETURN(TIMER_GREEKS, WithKernel(CallOrPut(), [&](auto kernel) {
+        return decltype(kernel)::Delta(Terms());
+    }));
     
-    double d1 = ( log(S/K) + (b + (s*s / 2.0) ) * T ) / temp;
+}
+
+// Compute gamma
+double EuropeanOption::Gamma() const {
+    /*
+     Compute gamma
+     */
     
-    double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), -d1);
+    if (m_cache) return Cached(GREEK_GAMMA).gamma;
     
-    double d2 = d1 - temp;
+    METRIC_RETURN(TIMER_GREEKS, WithKernel(CallOrPut(), [&](auto kernel) {
+        return decltype(kernel)::Gamma(S(), Terms());
+    }));
     
-    double Nd2 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), -d2);
+}
+
+// Compute delta using array of prices
+vector<double> EuropeanOption::Delta(const vector<double>& price_mesh) const {
+    /*
+     Compute delta
+     input:
+        price mesh
+     output:
+        delta
+     */
     
-    double SebrT = S * exp( (b - r) * T );
+    vector<double> deltas(price_mesh.size());
     
-    double KerT = K * exp( - r * T );
+    Delta(price_mesh, deltas);
     
-    return KerT*Nd2 - SebrT*Nd1;
+    return deltas;
     
 }
 
-
-// Compute delta
-double EuropeanOption::Delta() const {
+void EuropeanOption::Delta(span<const double> price_mesh, span<double> deltas) const {
     /*
-     Compute delta
+     Compute delta into a caller-provided array, without allocating on the calling thread
+     input:
+        price mesh
+        deltas, same size as the mesh
      */
+    
+    Delta(MeshView(price_mesh), deltas);
+    
+}
 
-    bool is_call = CallOrPut() == CALL;
+void EuropeanOption::Delta(const MeshView& price_mesh, span<double> deltas) const {
+    /*
+     Compute delta over a mesh of underlying prices into a caller-provided array
+     input:
+        price mesh
+        deltas, same size as the mesh
+     */
     
-    double temp =  s() * sqrt(T());
+    METRIC_SCOPE(TIMER_MESH, price_mesh.Size());
     
-    double d1 = ( log(S()/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
+    CheckMeshOutput(price_mesh.Size(), deltas.size(), "EuropeanOption::Delta");
     
-    double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), (is_call ? +1 : -1) * d1);
+    // Only log(S) varies along the mesh
+    const PricingTerms& terms = Terms();
     
-    double ebrT = exp( (b() - r()) * T() );
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        EvaluateMesh(price_mesh, deltas, [&](const double* points, double* values, size_t count) {
+            decltype(kernel)::DeltaMesh(terms, points, values, count);
+        });
+    });
     
-    return (is_call ? +1 : -1) * ebrT * Nd1;
+}
+
+void EuropeanOption::Delta(const MeshView& price_mesh, const MeshBlockSink& sink) const {
+    /*
+     Compute delta over a mesh of underlying prices, streaming blocks to sink in order
+     input:
+        price mesh
+        sink
+     */
+    
+    METRIC_SCOPE(TIMER_MESH, price_mesh.Size());
+    
+    const PricingTerms& terms = Terms();
+    
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        StreamMesh(price_mesh, sink, [&](const double* points, double* values, size_t count) {
+            decltype(kernel)::DeltaMesh(terms, points, values, count);
+        });
+    });
     
 }
 
-// Compute gamma
-double EuropeanOption::Gamma() const {
+// Compute gamma using array of prices
+vector<double> EuropeanOption::Gamma(const vector<double>& price_mesh) const {
     /*
      Compute gamma
+     input:
+        price mesh
+     output:
+        gamma
      */
     
-    bool is_call = CallOrPut() == CALL;
+    vector<double> gammas(price_mesh.size());
     
-    double temp =  s() * sqrt(T());
+    Gamma(price_mesh, gammas);
     
-    double d1 = ( log(S()/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
+    return gammas;
     
-    double nd1 = boost::math::pdf(boost::math::normal_distribution<double>(0.0, 1.0), (is_call ? +1 : -1) * d1);
+}
+
+void EuropeanOption::Gamma(span<const double> price_mesh, span<double> gammas) const {
+    /*
+     Compute gamma into a caller-provided array, without allocating on the calling thread
+     input:
+        price mesh
+        gammas, same size as the mesh
+     */
     
-    double ebrT = exp( (b() - r()) * T() );
+    Gamma(MeshView(price_mesh), gammas);
     
-    return (nd1 * ebrT) / (S() * temp);
+}
+
+void EuropeanOption::Gamma(const MeshView& price_mesh, span<double> gammas) const {
+    /*
+     Compute gamma over a mesh of underlying prices into a caller-provided array
+     input:
+        price mesh
+        gammas, same size as the mesh
+     */
+    
+    METRIC_SCOPE(TIMER_MESH, price_mesh.Size());
+    
+    CheckMeshOutput(price_mesh.Size(), gammas.size(), "EuropeanOption::Gamma");
+    
+    // Only log(S) varies along the mesh
+    const PricingTerms& terms = Terms();
+    
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        EvaluateMesh(price_mesh, gammas, [&](const double* points, double* values, size_t count) {
+            decltype(kernel)::GammaMesh(terms, points, values, count);
+        });
+    });
     
 }
 
-// Compute delta using array of prices
-vector<double> EuropeanOption::Delta(vector<double>& price_mesh) const {
+void EuropeanOption::Gamma(const MeshView& price_mesh, const MeshBlockSink& sink) const {
     /*
-     Compute delta
+     Compute gamma over a mesh of underlying prices, streaming blocks to sink in order
      input:
         price mesh
+        sink
+     */
+    
+    METRIC_SCOPE(TIMER_MESH, price_mesh.Size());
+    
+    const PricingTerms& terms = Terms();
+    
+    WithKernel(CallOrPut(), [&](auto kernel) {
+        StreamMesh(price_mesh, sink, [&](const double* points, double* values, size_t count) {
+            decltype(kernel)::GammaMesh(terms, points, values, count);
+        });
+    });
+    
+}
+
+// Compute price and greeks
+Greeks EuropeanOption::PriceAndGreeks(unsigned mask) const {
+    /*
+     Compute the price and the requested sensitivities, from the cache when one is set
+     input:
+        mask of GreekMask values
      output:
-        delta
+        greeks, zero where not requested
      */
     
-    bool is_call = CallOrPut() == CALL;
+    if (m_cache) return Cached(mask);
     
-    vector<double> deltas;
+    return FusedGreeks(mask);
+}
+
+Greeks EuropeanOption::Cached(unsigned mask) const {
+    /*
+     Outputs of mask from the cache. A miss computes RESULT_CACHE_MASK as well, so the Price,
+     Delta and Gamma calls that usually follow hit, and inserts the record
+     input:
+        mask of GreekMask values
+     output:
+        greeks, zero where not requested
+     */
     
-    for(double price: price_mesh){
-        
-        double temp =  s() * sqrt(T());
-        
-        double d1 = ( log(price/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
-        
-        double Nd1 = boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), (is_call ? +1 : -1) * d1);
-        
-        double ebrT = exp( (b() - r()) * T() );
-        
-        deltas.push_back((is_call ? +1 : -1) * ebrT * Nd1);
-    }
+    Greeks greeks;
     
-    return deltas;
+    if (m_cache->Find(*this, mask, greeks)) return greeks;
     
+    greeks = FusedGreeks(mask | RESULT_CACHE_MASK);
+    
+    m_cache->Insert(*this, mask | RESULT_CACHE_MASK, greeks);
+    
+    if (!(mask & GREEK_PRICE)) greeks.price = 0;
+    if (!(mask & GREEK_DELTA)) greeks.delta = 0;
+    if (!(mask & GREEK_GAMMA)) greeks.gamma = 0;
+    
+    return greeks;
 }
 
-// Compute gamma using array of prices
-vector<double> EuropeanOption::Gamma(vector<double>& price_mesh) const {
+Greeks EuropeanOption::FusedGreeks(unsigned mask) const {
     /*
-     Compute gamma
+     Compute the price and the requested sensitivities in one pass. d1, d2 and the normal
+     distribution terms are evaluated once, and only when a requested output needs them.
+     The discount factors and the other inputs of d1 come from the cached terms
      input:
-        price mesh
+        mask of GreekMask values
      output:
-        gamma
+        greeks, zero where not requested
      */
     
-    bool is_call = CallOrPut() == CALL;
+    METRIC_SCOPE(TIMER_GREEKS, 1);
+    
+    Greeks greeks;
     
-    vector<double> gammas;
+    double phi = CallOrPut() == CALL ? +1 : -1;
     
-    for(double price: price_mesh){
-        
-        double temp =  s() * sqrt(T());
-        
-        double d1 = ( log(price/K()) + (b() + (s()*s() / 2.0) ) * T() ) / temp;
-        
-        double nd1 = boost::math::pdf(boost::math::normal_distribution<double>(0.0, 1.0), (is_call ? +1 : -1) * d1);
-        
-        double ebrT = exp( (b() - r()) * T() );
-        
-        gammas.push_back((nd1 * ebrT) / (price * temp));
+    bool need_Nd1 = mask & (GREEK_PRICE | GREEK_DELTA | GREEK_THETA | GREEK_RHO | GREEK_CARRY_RHO);
+    bool need_Nd2 = mask & (GREEK_PRICE | GREEK_THETA | GREEK_RHO);
+    bool need_nd1 = mask & (GREEK_GAMMA | GREEK_VEGA | GREEK_THETA);
+    
+    const PricingTerms& terms = Terms();
+    
+    double sqrtT = terms.sqrt_T;
+    
+    double temp = terms.volatility;
+    
+    double d1 = ( terms.log_S - terms.log_K + terms.drift ) / temp;
+    
+    double d2 = d1 - temp;
+    
+    double Nd1 = need_Nd1 ? NormalCdf(phi * d1) : 0;
+    
+    double Nd2 = need_Nd2 ? NormalCdf(phi * d2) : 0;
+    
+    double nd1 = need_nd1 ? NormalPdf(d1) : 0;
+    
+    double ebrT = terms.carry;
+    
+    double SebrT = S() * ebrT;
+    
+    double KerT = K() * terms.discount;
+    
+    double price = phi * (SebrT*Nd1 - KerT*Nd2);
+    
+    double carry_rho = phi * T() * SebrT * Nd1;
+    
+    if (mask & GREEK_PRICE) greeks.price = price;
+    
+    if (mask & GREEK_DELTA) greeks.delta = phi * ebrT * Nd1;
+    
+    if (mask & GREEK_GAMMA) greeks.gamma = (nd1 * ebrT) / (S() * temp);
+    
+    if (mask & GREEK_VEGA) greeks.vega = SebrT * nd1 * sqrtT;
+    
+    if (mask & GREEK_THETA) greeks.theta = - (SebrT * nd1 * s()) / (2.0 * sqrtT) - phi * (b() - r()) * SebrT * Nd1 - phi * r() * KerT * Nd2;
+    
+    if (mask & GREEK_RHO) greeks.rho = - T() * price + (UnderlyingType() == FUTURES ? 0 : carry_rho);
+    
+    if (mask & GREEK_CARRY_RHO) greeks.carry_rho = carry_rho;
+    
+    return greeks;
+}
+
+void EuropeanOption::TermsChanged(unsigned terms) {
+    /*
+     Recompute the intermediate terms shared by Price, Delta, Gamma and PriceAndGreeks that depend
+     on the input a setter changed, e.g. S() only refreshes log(S), so a spot tick costs one log.
+     Doing it here rather than on the next evaluation keeps the const methods free of writes, so
+     any number of threads can price an option that no thread is modifying
+     input:
+        PricingTerm values to recompute
+     */
+    
+    METRIC_COUNT(COUNTER_TERM_REFRESH);
+    
+    if (terms & TERM_LOG_S) m_terms.log_S = log(S());
+    
+    if (terms & TERM_LOG_K) m_terms.log_K = log(K());
+    
+    if (terms & TERM_VOLATILITY) {
+        m_terms.sqrt_T = sqrt(T());
+        m_terms.volatility = s() * m_terms.sqrt_T;
     }
     
-    return gammas;
+    if (terms & TERM_DRIFT) m_terms.drift = (b() + (s()*s() / 2.0) ) * T();
+    
+    if (terms & TERM_DISCOUNT) m_terms.discount = exp( - r() * T() );
     
+    if (terms & TERM_CARRY) m_terms.carry = exp( (b() - r()) * T() );
 }
 
 // Compute delta
@@ -385,8 +736,10 @@ double EuropeanOption::DeltaApproximation(double h) const {
         delta
      */
     
-    return CallOrPut() == CALL ? (PriceAsCall(S() + h, -1, -1, -1, -1, -1) - PriceAsCall(S() - h, -1, -1, -1, -1, -1)) / (2 * h) :
-    (PriceAsPut(S() + h, -1, -1, -1, -1, -1) - PriceAsPut(S() - h, -1, -1, -1, -1, -1)) / (2 * h);
+    return WithKernel(CallOrPut(), [&](auto kernel) {
+        typedef decltype(kernel) Kernel;
+        return (Kernel::Price(S() + h, K(), T(), r(), s(), b()) - Kernel::Price(S() - h, K(), T(), r(), s(), b())) / (2 * h);
+    });
     
 }
 
@@ -400,6 +753,8 @@ double EuropeanOption::GammaApproximation(double h) const {
         gamma
      */
     
-    return CallOrPut() == CALL ? (PriceAsCall(S() + h, -1, -1, -1, -1, -1) - (2 * PriceAsCall(S(), -1, -1, -1, -1, -1)) + PriceAsCall(S() - h, -1, -1, -1, -1, -1)) / (h * h) :
-    (PriceAsPut(S() + h, -1, -1, -1, -1, -1) - (2 * PriceAsPut(S(), -1, -1, -1, -1, -1)) + PriceAsPut(S() - h, -1, -1, -1, -1, -1)) / (h * h);
+    return WithKernel(CallOrPut(), [&](auto kernel) {
+        typedef decltype(kernel) Kernel;
+        return (Kernel::Price(S() + h, K(), T(), r(), s(), b()) - (2 * Kernel::Price(S(), K(), T(), r(), s(), b())) + Kernel::Price(S() - h, K(), T(), r(), s(), b())) / (h * h);
+    });
 }
@@ -11,9 +11,29 @@
 
 #include <stdio.h>
 #include "Option.hpp"
+#include "Greeks.hpp"
+
+class ResultCache;
+
+struct PricingTerms {
+    /*
+     Intermediate terms of the Black-Scholes-Merton formula, see PricingTerm
+     */
+    double log_S = 0; // log(S)
+    double log_K = 0; // log(K)
+    double sqrt_T = 0; // sqrt(T)
+    double volatility = 0; // s*sqrt(T)
+    double drift = 0; // (b + s*s/2)*T
+    double discount = 0; // e^(-rT)
+    double carry = 0; // e^((b-r)T)
+};
 
 class EuropeanOption : public Option {
     
+    // Attributes
+    PricingTerms m_terms; // Cached terms, recomputed by the setters so const evaluation only reads them
+    ResultCache* m_cache = nullptr; // Shared cache consulted by Price, Delta, Gamma and PriceAndGreeks, nullptr for none
+    
 public:
     /* CANONICAL HEADER START */
     EuropeanOption(){} // Default constructor
@@ -35,11 +55,40 @@ public:
     EuropeanOption& operator = (const EuropeanOption& other_option); // Assignment operator overload
     /* CANONICAL HEADER END */
     
+    /* GETTERS START */
+    
+    ResultCache* Cache() const {
+        return m_cache;
+    }
+    
+    /* GETTERS END */
+    
+    /* SETTERS START */
+    
+    void Cache(ResultCache* cache) {
+        // Copies share the cache. Setters need no invalidation: the cache keys on the current inputs
+        this->m_cache = cache;
+    }
+    
+    /* SETTERS END */
+    
     double Price() const; // Price the option
     
     vector<double> Price(double price) const; // Price the option using put-call parity
     
-    vector<double> Price(vector<double>& price_mesh, enum Parameter parameter) const; // Price the option using an array of parameters
+    ParityResult Parity(double price) const; // Price the option using put-call parity, without allocating
+    
+    vector<double> Price(const vector<double>& price_mesh, enum Parameter parameter) const; // Price the option using an array of parameters
+    
+    void Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const; // Price the option using an array of parameters into a caller-provided array
+    
+    void Price(const MeshView& parameter_mesh, enum Parameter parameter, span<double> prices) const; // Price the option over a lazy mesh into a caller-provided array
+    
+    void Price(const MeshView& parameter_mesh, enum Parameter parameter, const MeshBlockSink& sink) const; // Price the option over a lazy mesh, streaming blocks of prices in order
+    
+    vector<double> Price(const vector<GridAxis>& axes, enum Precision precision = DOUBLE_PRECISION) const; // Price the option over a Cartesian grid of parameters
+    
+    void Price(const vector<GridAxis>& axes, double* prices, enum Precision precision = DOUBLE_PRECISION) const; // Price the option over a Cartesian grid of parameters into a caller-provided tensor
     
     double Delta() const; // Compute delta
     
@@ -49,17 +98,39 @@ public:
     
     double GammaApproximation(double h) const; // Compute gamma using an approximation
     
-    vector<double> Delta(vector<double>& parameter_mesh) const; // Price the option using an array of parameters
+    vector<double> Delta(const vector<double>& price_mesh) const; // Compute delta using array of underlying prices
+    
+    vector<double> Gamma(const vector<double>& price_mesh) const; // Compute gamma using array of underlying prices
+    
+    void Delta(span<const double> price_mesh, span<double> deltas) const; // Compute delta using array of underlying prices into a caller-provided array
+    
+    void Gamma(span<const double> price_mesh, span<double> gammas) const; // Compute gamma using array of underlying prices into a caller-provided array
+    
+    void Delta(const MeshView& price_mesh, span<double> deltas) const; // Compute delta over a lazy mesh of underlying prices into a caller-provided array
     
-    vector<double> Gamma(vector<double>& parameter_mesh) const; // Price the option using an array of parameters
+    void Gamma(const MeshView& price_mesh, span<double> gammas) const; // Compute gamma over a lazy mesh of underlying prices into a caller-provided array
+    
+    void Delta(const MeshView& price_mesh, const MeshBlockSink& sink) const; // Compute delta over a lazy mesh of underlying prices, streaming blocks in order
+    
+    void Gamma(const MeshView& price_mesh, const MeshBlockSink& sink) const; // Compute gamma over a lazy mesh of underlying prices, streaming blocks in order
+    
+    Greeks PriceAndGreeks(unsigned mask = ALL_GREEKS) const; // Compute the price and the requested sensitivities in one pass
+    
+    const PricingTerms& Terms() const {
+        // Cached intermediate terms, always current
+        return m_terms;
+    }
+    
+protected:
+    void TermsChanged(unsigned terms) override; // Recompute the terms depending on the input a setter changed
     
     // Helper functions
 private:
-    double PriceAsCall() const; // Price as a call option
-    double PriceAsPut() const;  // Price as a put option
+    Greeks FusedGreeks(unsigned mask) const; // PriceAndGreeks without the cache
+    
+    Greeks Cached(unsigned mask) const; // Outputs of mask from the cache, computed with RESULT_CACHE_MASK and inserted on a miss
     
-    double PriceAsCall(double S, double K, double T, double r, double s, double b) const; // Price as a call option. Used for mesh pricing
-    double PriceAsPut(double S, double K, double T, double r, double s, double b) const; // Price as a put option. Used for mesh pricing
+    void PriceGridRows(const vector<GridAxis>& axes, size_t first_unit, size_t last_unit, double* prices, enum Precision precision) const; // Price a range of grid work units
     
 };
 
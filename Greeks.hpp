@@ -0,0 +1,111 @@
+//
+//  File: Greeks.hpp
+//  Project: ExactPricingModels
+//  Objective: Price and sensitivities computed in a single pass
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef Greeks_hpp
+#define Greeks_hpp
+
+#include <stdio.h>
+#include "AlignedAllocator.hpp"
+
+enum GreekMask{
+    GREEK_PRICE = 1 << 0,
+    GREEK_DELTA = 1 << 1,
+    GREEK_GAMMA = 1 << 2,
+    GREEK_VEGA = 1 << 3,
+    GREEK_THETA = 1 << 4,
+    GREEK_RHO = 1 << 5,
+    GREEK_CARRY_RHO = 1 << 6,
+    ALL_GREEKS = (1 << 7) - 1
+}; // Outputs requested from the fused kernels. Combine with |
+
+struct Greeks {
+    /*
+     Price and sensitivities of one option. Outputs that were not requested are left at zero
+     */
+    double price = 0; // Option value
+    double delta = 0; // dV/dS
+    double gamma = 0; // d2V/dS2
+    double vega = 0; // dV/dsigma
+    double theta = 0; // -dV/dT, time decay per year
+    double rho = 0; // dV/dr, with the carry cost following the underlying asset class (b = r, r - q, 0, r - R)
+    double carry_rho = 0; // dV/db
+};
+
+struct GreeksColumns {
+    /*
+     Non-owning output columns for the batch kernels. Requested outputs must point to `size` elements
+     */
+    double* price = nullptr;
+    double* delta = nullptr;
+    double* gamma = nullptr;
+    double* vega = nullptr;
+    double* theta = nullptr;
+    double* rho = nullptr;
+    double* carry_rho = nullptr;
+};
+
+class GreeksBatch {
+
+    // Attributes
+    AlignedVector<double> m_price;
+    AlignedVector<double> m_delta;
+    AlignedVector<double> m_gamma;
+    AlignedVector<double> m_vega;
+    AlignedVector<double> m_theta;
+    AlignedVector<double> m_rho;
+    AlignedVector<double> m_carry_rho;
+
+public:
+    /* CANONICAL HEADER START */
+    GreeksBatch(){} // Default constructor
+
+    virtual ~GreeksBatch(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    GreeksColumns Allocate(size_t size, unsigned mask) {
+        /*
+         Size the requested columns and release the others
+         input:
+            number of contracts, requested outputs
+         output:
+            columns view, null where not requested
+         */
+        GreeksColumns columns;
+
+        columns.price = Column(m_price, size, mask & GREEK_PRICE);
+        columns.delta = Column(m_delta, size, mask & GREEK_DELTA);
+        columns.gamma = Column(m_gamma, size, mask & GREEK_GAMMA);
+        columns.vega = Column(m_vega, size, mask & GREEK_VEGA);
+        columns.theta = Column(m_theta, size, mask & GREEK_THETA);
+        columns.rho = Column(m_rho, size, mask & GREEK_RHO);
+        columns.carry_rho = Column(m_carry_rho, size, mask & GREEK_CARRY_RHO);
+
+        return columns;
+    }
+
+    const AlignedVector<double>& Price() const { return m_price; }
+    const AlignedVector<double>& Delta() const { return m_delta; }
+    const AlignedVector<double>& Gamma() const { return m_gamma; }
+    const AlignedVector<double>& Vega() const { return m_vega; }
+    const AlignedVector<double>& Theta() const { return m_theta; }
+    const AlignedVector<double>& Rho() const { return m_rho; }
+    const AlignedVector<double>& CarryRho() const { return m_carry_rho; }
+
+private:
+    static double* Column(AlignedVector<double>& column, size_t size, unsigned requested) {
+        if (!requested) {
+            AlignedVector<double>().swap(column);
+            return nullptr;
+        }
+        column.resize(size);
+        return column.data();
+    }
+
+};
+
+#endif /* Greeks_hpp */
@@ -11,24 +11,26 @@
 
 #include <stdio.h>
 #include <vector>
+#include "MeshView.hpp"
+#include "cmath"
 
-std::vector<double> CreateMesh(double mesh_start, double mesh_end, double step) {
+inline std::vector<double> CreateMesh(double mesh_start, double mesh_end, double step) {
     /*
-     Returns a mesh used for a monotonically increasing range of underlying values
+     Returns a mesh used for a monotonically increasing range of underlying values. Point i is
+     mesh_start + i*step, computed from i so the points do not drift, up to mesh_end included
+     (within rounding). For large meshes prefer a MeshView, which is never materialized
      input:
         mesh_start: first element
         mesh_end: last element
         step: iteration step until last element is reached
      output:
-        mesh: resulting array that goes from start to end
+        mesh: resulting array that goes from start to end, empty if step is not positive or end < start
     */
-    std::vector<double> mesh; // Output mesh
+    if (!(step > 0) || mesh_end < mesh_start) return {};
     
-    for (double start = mesh_start; start < mesh_end + 1; start+=step) {
-        mesh.push_back(start); // Populate mesh
-    }
+    size_t size = static_cast<size_t>(floor((mesh_end - mesh_start) / step + 1e-9)) + 1; // Number of points
     
-    return mesh;
+    return MeshView::Linear(mesh_start, mesh_start + (size - 1) * step, size).ToVector();
     
 }
 
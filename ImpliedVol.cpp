@@ -0,0 +1,301 @@
+//
+//  File: ImpliedVol.cpp
+//  Project: ExactPricingModels
+//  Objective: Implied volatility from option prices, scalar and batch
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ImpliedVol.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+#include <limits>
+
+const double IV_MIN_VOLATILITY = 1e-8; // Lower end of the search bracket
+const double IV_MAX_VOLATILITY = 10.0; // Upper end of the search bracket
+const double IV_PI = 3.14159265358979323846; // pi, for the Corrado-Miller guess
+
+ImpliedVolSolver::ImpliedVolSolver(double tolerance, int max_iterations, ThreadPool* pool) :
+m_tolerance(tolerance),
+m_max_iterations(max_iterations),
+m_pricer(pool) {
+    /*
+     Parameter constructor
+     */
+}
+
+double ImpliedVolSolver::Solve(const EuropeanOption& option, double price, enum ImpliedVolStatus* status) const {
+    /*
+     Implied volatility of one option. Runs the batch solver over a one contract view of the option
+     input:
+        option (its volatility is ignored), observed price
+     output:
+        implied volatility, status if requested
+     */
+
+    METRIC_SCOPE(TIMER_IMPLIED_VOL, 1);
+
+    double S = option.S(), K = option.K(), T = option.T(), r = option.r(), s = option.s(), b = option.b();
+    double q = option.q(), R = option.R();
+    unsigned char call_or_put = static_cast<unsigned char>(option.CallOrPut());
+    unsigned char underlying_type = static_cast<unsigned char>(option.UnderlyingType());
+
+    OptionBatchView view;
+    view.size = 1;
+    view.S = &S;
+    view.K = &K;
+    view.T = &T;
+    view.r = &r;
+    view.s = &s;
+    view.b = &b;
+    view.call_or_put = &call_or_put;
+    view.underlying_type = &underlying_type;
+    view.q = &q;
+    view.R = &R;
+
+    double volatility;
+    unsigned char result;
+
+    SolveBlocks(view, &price, &volatility, &result);
+
+    if (status) *status = static_cast<enum ImpliedVolStatus>(result);
+
+    return volatility;
+}
+
+vector<double> ImpliedVolSolver::Solve(const OptionBatch& batch, const vector<double>& prices, vector<unsigned char>& status) const {
+    /*
+     Implied volatilities of a batch
+     input:
+        option batch (volatility column ignored), observed prices in batch order
+     output:
+        implied volatilities, status resized to one ImpliedVolStatus per contract
+     */
+
+    vector<double> volatilities(batch.Size());
+
+    status.resize(batch.Size());
+
+    Solve(batch.View(), prices.data(), volatilities.data(), status.data());
+
+    return volatilities;
+}
+
+void ImpliedVolSolver::Solve(const OptionBatchView& batch, const double* prices, double* volatilities, unsigned char* status) const {
+    /*
+     Implied volatilities into caller-provided columns, chunked over the thread pool
+     */
+
+    METRIC_SCOPE(TIMER_IMPLIED_VOL, batch.size);
+
+    if (batch.size <= m_pricer.ChunkSize()) {
+        SolveBlocks(batch, prices, volatilities, status);
+        return;
+    }
+
+    m_pricer.Pool().ParallelFor(0, batch.size, m_pricer.ChunkSize(), [&](size_t begin, size_t end) {
+        SolveBlocks(batch.Slice(begin, end), prices + begin, volatilities + begin, status + begin);
+    });
+}
+
+void ImpliedVolSolver::SolveBlocks(const OptionBatchView& batch, const double* prices, double* volatilities, unsigned char* status) const {
+    /*
+     Solve price(sigma) = target for every contract, BATCH_BLOCK contracts at a time.
+        1. No-arbitrage bounds in forward terms, F = S*e^(bT), D = e^(-rT):
+           call in [D*max(F - K, 0), D*F), put in [D*max(K - F, 0), D*K)
+        2. In-the-money contracts are solved as their out-of-the-money twin through parity:
+           the opposite type at price target - D*|F - K|, so the residual is measured against time
+           value only and intrinsic value cannot hide a wrong volatility
+        3. Initial guess from the Corrado-Miller rational approximation on the call-equivalent price
+        4. Householder (Halley) steps. Price and vega come from the fused kernel,
+           volga / vega = d1*d2 / sigma gives the second order term. Each contract keeps a bracket
+           and falls back to bisection when a step leaves it
+     Contracts still iterating are gathered into contiguous columns before every pass, so the array
+     kernels only reprice those; the loop stops once the last contract of the block is done
+     */
+
+    alignas(COLUMN_ALIGNMENT) double sigma[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double low[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double high[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double log_FK[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double price[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double vega[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double twin_target[BATCH_BLOCK]; // Out-of-the-money price, target less the intrinsic bound
+    alignas(COLUMN_ALIGNMENT) unsigned char twin[BATCH_BLOCK]; // Out-of-the-money type solved for
+    bool resolved[BATCH_BLOCK]; // Time value large enough for the tolerance to be met above the rounding of the price
+
+    // Contracts still iterating, gathered contiguously so converged ones are not repriced
+    size_t active[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_S[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_K[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_T[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_r[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_s[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double active_b[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) unsigned char active_call_or_put[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) unsigned char active_underlying_type[BATCH_BLOCK];
+
+    OptionBatchView compact;
+    compact.S = active_S;
+    compact.K = active_K;
+    compact.T = active_T;
+    compact.r = active_r;
+    compact.s = active_s;
+    compact.b = active_b;
+    compact.call_or_put = active_call_or_put;
+    compact.underlying_type = active_underlying_type;
+
+    GreeksColumns outputs;
+    outputs.price = price;
+    outputs.vega = vega;
+
+    for (size_t start = 0; start < batch.size; start += BATCH_BLOCK) {
+
+        size_t n = batch.size - start < BATCH_BLOCK ? batch.size - start : BATCH_BLOCK;
+
+        OptionBatchView block = batch.Slice(start, start + n);
+
+        const double* target = prices + start;
+        unsigned char* result = status + start;
+
+        for (size_t index = 0; index < n; index++) log_FK[index] = block.S[index] / block.K[index];
+
+        Log(log_FK, log_FK, n);
+
+        size_t n_active = 0;
+
+        for (size_t index = 0; index < n; index++) {
+
+            double S = block.S[index], K = block.K[index], T = block.T[index];
+            double r = block.r[index], b = block.b[index];
+            bool is_call = block.call_or_put[index] == CALL;
+
+            log_FK[index] += b * T;
+
+            low[index] = IV_MIN_VOLATILITY;
+            high[index] = IV_MAX_VOLATILITY;
+            sigma[index] = 0.2;
+
+            if (!(S > 0 && K > 0 && T > 0) || !std::isfinite(target[index])) {
+                result[index] = IV_INVALID_INPUT;
+                continue;
+            }
+
+            double D = exp(-r * T);
+            double F = S * exp(b * T);
+            double lower = is_call ? D * (F > K ? F - K : 0) : D * (K > F ? K - F : 0);
+            double upper = is_call ? D * F : D * K;
+
+            if (target[index] < lower * (1 - m_tolerance)) {
+                result[index] = IV_BELOW_INTRINSIC;
+                continue;
+            }
+
+            if (target[index] >= upper) {
+                result[index] = IV_ABOVE_MAXIMUM;
+                continue;
+            }
+
+            // Parity twin: an in-the-money call is solved as the put worth target - D(F - K), and
+            // conversely, so only time value enters the residual
+            bool in_the_money = is_call ? F > K : K > F;
+            twin[index] = static_cast<unsigned char>(in_the_money == is_call ? PUT : CALL);
+            twin_target[index] = target[index] - lower > 0 ? target[index] - lower : 0;
+
+            // The price carries the time value only to its rounding, eps * target. Below
+            // eps * target / tolerance the tolerance cannot be met, whatever volatility is found
+            resolved[index] = m_tolerance * twin_target[index] >= std::numeric_limits<double>::epsilon() * target[index];
+
+            // No time value: any volatility small enough reproduces the price
+            if (twin_target[index] == 0) {
+                sigma[index] = IV_MIN_VOLATILITY;
+                result[index] = IV_NOT_CONVERGED;
+                continue;
+            }
+
+            // Corrado-Miller guess on the undiscounted call-equivalent price
+            double C = twin_target[index] / D + (twin[index] == CALL ? 0 : F - K);
+            double x = C - (F - K) / 2;
+            double root = x*x - (F - K)*(F - K) / IV_PI;
+            double guess = sqrt(2 * IV_PI) / (F + K) * (x + sqrt(root > 0 ? root : 0)) / sqrt(T);
+
+            sigma[index] = guess > 1e-4 && guess < 5 ? guess : (guess >= 5 ? 5 : 0.2);
+
+            result[index] = IV_NOT_CONVERGED;
+            active[n_active++] = index;
+        }
+
+        for (int iteration = 0; iteration < m_max_iterations && n_active > 0; iteration++) {
+
+            for (size_t slot = 0; slot < n_active; slot++) {
+                size_t index = active[slot];
+                active_S[slot] = block.S[index];
+                active_K[slot] = block.K[index];
+                active_T[slot] = block.T[index];
+                active_r[slot] = block.r[index];
+                active_s[slot] = sigma[index];
+                active_b[slot] = block.b[index];
+                active_call_or_put[slot] = twin[index];
+                active_underlying_type[slot] = block.underlying_type ? block.underlying_type[index] : static_cast<unsigned char>(STOCK);
+            }
+
+            compact.size = n_active;
+
+            m_pricer.PriceAndGreeks(compact, GREEK_PRICE | GREEK_VEGA, outputs);
+
+            size_t still_active = 0;
+
+            for (size_t slot = 0; slot < n_active; slot++) {
+
+                size_t index = active[slot];
+
+                double f = price[slot] - twin_target[index];
+
+                if (fabs(f) <= m_tolerance * twin_target[index]) {
+                    result[index] = resolved[index] ? IV_CONVERGED : IV_NOT_CONVERGED;
+                    continue;
+                }
+
+                double s = sigma[index];
+
+                if (f > 0) high[index] = s;
+                else low[index] = s;
+
+                double sqrtT = sqrt(block.T[index]);
+                double d1 = (log_FK[index] + s*s*block.T[index] / 2.0) / (s * sqrtT);
+                double d2 = d1 - s * sqrtT;
+
+                double newton = f / vega[slot];
+                double denominator = 1.0 - 0.5 * newton * d1 * d2 / s;
+                double step = denominator > 0.5 ? newton / denominator : newton;
+                double next = s - step;
+
+                if (!(next > low[index] && next < high[index])) next = 0.5 * (low[index] + high[index]);
+
+                // Stalled above the tolerance: keep the estimate, reported as not converged
+                if (fabs(next - s) <= 1e-15 * s) continue;
+
+                sigma[index] = next;
+                active[still_active++] = index;
+            }
+
+            n_active = still_active;
+        }
+
+        for (size_t index = 0; index < n; index++) {
+            bool solved = result[index] == IV_CONVERGED || result[index] == IV_NOT_CONVERGED;
+            volatilities[start + index] = solved ? sigma[index] : std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+}
+
+double ImpliedVolatility(const EuropeanOption& option, double price, enum ImpliedVolStatus* status) {
+    /*
+     Implied volatility with the default solver settings
+     */
+    static const ImpliedVolSolver solver;
+
+    return solver.Solve(option, price, status);
+}
@@ -0,0 +1,75 @@
+//
+//  File: ImpliedVol.hpp
+//  Project: ExactPricingModels
+//  Objective: Implied volatility from option prices, scalar and batch
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ImpliedVol_hpp
+#define ImpliedVol_hpp
+
+#include <stdio.h>
+#include "BatchPricer.hpp"
+
+enum ImpliedVolStatus{ IV_CONVERGED, IV_NOT_CONVERGED, IV_BELOW_INTRINSIC, IV_ABOVE_MAXIMUM, IV_INVALID_INPUT }; // Per-contract solver outcome
+
+class ImpliedVolSolver {
+
+    // Attributes
+    double m_tolerance = 1e-10; // Relative tolerance on time value: converged once |price - target| <= tolerance * (target - intrinsic bound), i.e. on the out-of-the-money twin's price
+    int m_max_iterations = 32; // Iterations before giving up
+    BatchPricer m_pricer; // Fused price and vega kernel, also provides the thread pool
+
+public:
+    /* CANONICAL HEADER START */
+    ImpliedVolSolver(){} // Default constructor
+
+    ImpliedVolSolver(double tolerance, int max_iterations, ThreadPool* pool = nullptr); // Parameter constructor
+
+    virtual ~ImpliedVolSolver(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    double Tolerance() const {
+        return m_tolerance;
+    }
+
+    int MaxIterations() const {
+        return m_max_iterations;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Tolerance(double tolerance) {
+        this->m_tolerance = tolerance;
+    }
+
+    void MaxIterations(int max_iterations) {
+        this->m_max_iterations = max_iterations;
+    }
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    /* SETTERS END */
+
+    double Solve(const EuropeanOption& option, double price, enum ImpliedVolStatus* status = nullptr) const; // Implied volatility of one option
+
+    vector<double> Solve(const OptionBatch& batch, const vector<double>& prices, vector<unsigned char>& status) const; // Implied volatilities of a batch
+
+    void Solve(const OptionBatchView& batch, const double* prices, double* volatilities, unsigned char* status) const; // Implied volatilities into caller-provided columns
+
+    // Helper functions
+private:
+    void SolveBlocks(const OptionBatchView& batch, const double* prices, double* volatilities, unsigned char* status) const; // Single-threaded solver
+
+};
+
+double ImpliedVolatility(const EuropeanOption& option, double price, enum ImpliedVolStatus* status = nullptr); // Implied volatility with the default solver settings
+
+#endif /* ImpliedVol_hpp */
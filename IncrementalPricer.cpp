@@ -0,0 +1,411 @@
+//
+//  File: IncrementalPricer.cpp
+//  Project: ExactPricingModels
+//  Objective: Tick-driven batch repricing that only recomputes terms depending on changed inputs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "IncrementalPricer.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+#include <cstring>
+#include <stdexcept>
+
+struct TermColumns {
+    /*
+     Inputs and cached terms of contiguous contracts, see PricingTerms
+     */
+    const double* S;
+    const double* K;
+    const double* T;
+    const double* r;
+    const double* s;
+    const double* b;
+    const unsigned char* call_or_put;
+    const unsigned char* underlying_type;
+    const double* log_S;
+    const double* log_K;
+    const double* sqrt_T;
+    const double* volatility;
+    const double* drift;
+    const double* discount;
+    const double* carry;
+};
+
+static void PriceFromTerms(const TermColumns& terms, size_t n, unsigned mask, const GreeksColumns& greeks) {
+    /*
+     Price and sensitivities of at most BATCH_BLOCK contracts from their cached terms. Only d1, d2 and
+     the normal distribution terms are evaluated; the formulas are those of BatchPricer::PriceAndGreeks
+     input:
+        terms, number of contracts, mask of GreekMask values
+        output columns with n elements for every requested output
+     */
+
+    bool need_Nd1 = mask & (GREEK_PRICE | GREEK_DELTA | GREEK_THETA | GREEK_RHO | GREEK_CARRY_RHO);
+    bool need_Nd2 = mask & (GREEK_PRICE | GREEK_THETA | GREEK_RHO);
+    bool need_nd1 = mask & (GREEK_GAMMA | GREEK_VEGA | GREEK_THETA);
+
+    alignas(COLUMN_ALIGNMENT) double phi[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double d1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double Nd1[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double Nd2[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double nd1[BATCH_BLOCK];
+
+    const double* __restrict S = terms.S;
+    const double* __restrict K = terms.K;
+    const double* __restrict T = terms.T;
+    const double* __restrict r = terms.r;
+    const double* __restrict s = terms.s;
+    const double* __restrict b = terms.b;
+    const double* __restrict sqrtT = terms.sqrt_T;
+    const double* __restrict volatility = terms.volatility;
+    const double* __restrict e1 = terms.carry;
+    const double* __restrict e2 = terms.discount;
+
+    for (size_t index = 0; index < n; index++) {
+
+        phi[index] = 1.0 - 2.0 * terms.call_or_put[index];
+
+        d1[index] = ( terms.log_S[index] - terms.log_K[index] + terms.drift[index] ) / volatility[index];
+
+        Nd1[index] = phi[index] * d1[index];
+        Nd2[index] = phi[index] * (d1[index] - volatility[index]);
+    }
+
+    if (need_Nd1) NormalCdf(Nd1, Nd1, n);
+    if (need_Nd2) NormalCdf(Nd2, Nd2, n);
+    if (need_nd1) NormalPdf(d1, nd1, n);
+
+    if (mask & GREEK_PRICE) {
+        double* __restrict out = greeks.price;
+        for (size_t index = 0; index < n; index++) {
+            out[index] = phi[index] * (S[index]*e1[index]*Nd1[index] - K[index]*e2[index]*Nd2[index]);
+        }
+    }
+
+    if (mask & GREEK_DELTA) {
+        double* __restrict out = greeks.delta;
+        for (size_t index = 0; index < n; index++) out[index] = phi[index] * e1[index] * Nd1[index];
+    }
+
+    if (mask & GREEK_GAMMA) {
+        double* __restrict out = greeks.gamma;
+        for (size_t index = 0; index < n; index++) out[index] = (nd1[index] * e1[index]) / (S[index] * volatility[index]);
+    }
+
+    if (mask & GREEK_VEGA) {
+        double* __restrict out = greeks.vega;
+        for (size_t index = 0; index < n; index++) out[index] = S[index] * e1[index] * nd1[index] * sqrtT[index];
+    }
+
+    if (mask & GREEK_THETA) {
+        double* __restrict out = greeks.theta;
+        for (size_t index = 0; index < n; index++) {
+            double SebrT = S[index] * e1[index];
+            out[index] = - (SebrT * nd1[index] * s[index]) / (2.0 * sqrtT[index])
+                         - phi[index] * (b[index] - r[index]) * SebrT * Nd1[index]
+                         - phi[index] * r[index] * K[index] * e2[index] * Nd2[index];
+        }
+    }
+
+    if (mask & GREEK_RHO) {
+        double* __restrict out = greeks.rho;
+        for (size_t index = 0; index < n; index++) {
+            double SebrT = S[index] * e1[index];
+            double price = phi[index] * (SebrT*Nd1[index] - K[index]*e2[index]*Nd2[index]);
+            double carry_rho = terms.underlying_type[index] == FUTURES ? 0.0 : phi[index] * T[index] * SebrT * Nd1[index];
+            out[index] = - T[index] * price + carry_rho;
+        }
+    }
+
+    if (mask & GREEK_CARRY_RHO) {
+        double* __restrict out = greeks.carry_rho;
+        for (size_t index = 0; index < n; index++) out[index] = phi[index] * T[index] * S[index] * e1[index] * Nd1[index];
+    }
+}
+
+static GreeksColumns Offset(const GreeksColumns& greeks, size_t offset) {
+    GreeksColumns slice;
+    slice.price = greeks.price ? greeks.price + offset : nullptr;
+    slice.delta = greeks.delta ? greeks.delta + offset : nullptr;
+    slice.gamma = greeks.gamma ? greeks.gamma + offset : nullptr;
+    slice.vega = greeks.vega ? greeks.vega + offset : nullptr;
+    slice.theta = greeks.theta ? greeks.theta + offset : nullptr;
+    slice.rho = greeks.rho ? greeks.rho + offset : nullptr;
+    slice.carry_rho = greeks.carry_rho ? greeks.carry_rho + offset : nullptr;
+    return slice;
+}
+
+template <typename Body>
+void IncrementalPricer::ForEachChunk(size_t size, const Body& body) const {
+    /*
+     Run body over [0, size) in chunks of the pricer's chunk size, on the pool when there is more than one chunk.
+     body is passed by reference so wrapping it in a ThreadPool::RangeTask does not allocate
+     */
+
+    if (size <= m_pricer.ChunkSize()) {
+        body(0, size);
+        return;
+    }
+
+    m_pricer.Pool().ParallelFor(0, size, m_pricer.ChunkSize(), std::cref(body));
+}
+
+IncrementalPricer::IncrementalPricer(const OptionBatch& batch, ThreadPool* pool) :
+m_batch(batch),
+m_pricer(pool) {
+    /*
+     Parameter constructor. Every term is computed on the first evaluation
+     */
+
+    size_t size = m_batch.Size();
+
+    m_log_S.resize(size);
+    m_log_K.resize(size);
+    m_sqrt_T.resize(size);
+    m_volatility.resize(size);
+    m_drift.resize(size);
+    m_discount.resize(size);
+    m_carry.resize(size);
+}
+
+void IncrementalPricer::Update(enum Parameter parameter, const double* values) {
+    /*
+     Replace a whole input column. Only the terms depending on it are recomputed on the next
+     evaluation, e.g. a new spot column costs one log per contract
+     input:
+        parameter, Size() new values
+     */
+
+    double* column = nullptr;
+
+    switch (parameter) {
+        case UNDERLYING: column = m_batch.S(); break;
+        case STRIKE: column = m_batch.K(); break;
+        case TIME: column = m_batch.T(); break;
+        case RATE: column = m_batch.r(); break;
+        case SIGMA: column = m_batch.s(); break;
+        case CARRY: column = m_batch.b(); break;
+        default: throw std::invalid_argument("IncrementalPricer::Update: unknown parameter");
+    }
+
+    if (column != values) memcpy(column, values, Size() * sizeof(double));
+
+    m_stale_terms |= DependentTerms(parameter);
+}
+
+void IncrementalPricer::Update(enum Parameter parameter, const size_t* indices, const double* values, size_t count) {
+    /*
+     Replace the input of some contracts, e.g. the few underlyings that ticked. Their dependent terms
+     are recomputed at once so the other contracts keep their cached terms
+     input:
+        parameter, contract indices, new values (values[k] belongs to indices[k]), number of updates
+     */
+
+    Refresh();
+
+    unsigned stale = DependentTerms(parameter);
+
+    for (size_t update = 0; update < count; update++) {
+
+        size_t index = indices[update];
+
+        if (index >= Size()) throw std::out_of_range("IncrementalPricer::Update: contract index out of range");
+
+        switch (parameter) {
+            case UNDERLYING: m_batch.S()[index] = values[update]; break;
+            case STRIKE: m_batch.K()[index] = values[update]; break;
+            case TIME: m_batch.T()[index] = values[update]; break;
+            case RATE: m_batch.r()[index] = values[update]; break;
+            case SIGMA: m_batch.s()[index] = values[update]; break;
+            case CARRY: m_batch.b()[index] = values[update]; break;
+            default: throw std::invalid_argument("IncrementalPricer::Update: unknown parameter");
+        }
+
+        RefreshRange(stale, index, index + 1);
+    }
+}
+
+void IncrementalPricer::Price(double* prices) {
+    /*
+     Price every contract from the cached terms, recomputing stale terms first
+     */
+
+    GreeksColumns greeks;
+    greeks.price = prices;
+
+    PriceAndGreeks(GREEK_PRICE, greeks);
+}
+
+vector<double> IncrementalPricer::Price() {
+
+    vector<double> prices(Size());
+
+    Price(prices.data());
+
+    return prices;
+}
+
+void IncrementalPricer::Price(const size_t* indices, size_t count, double* prices) {
+    /*
+     Price some contracts, e.g. those whose inputs just changed. The contracts are gathered into
+     blocks so the array kernels still run on contiguous data
+     input:
+        contract indices, number of contracts, output with count elements
+     */
+
+    METRIC_SCOPE(TIMER_BATCH_PRICE, count);
+
+    Refresh();
+
+    alignas(COLUMN_ALIGNMENT) double columns[15][BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) unsigned char call_or_put[BATCH_BLOCK];
+    alignas(COLUMN_ALIGNMENT) unsigned char underlying_type[BATCH_BLOCK];
+
+    const double* sources[13] = {
+        m_batch.S(), m_batch.K(), m_batch.T(), m_batch.r(), m_batch.s(), m_batch.b(),
+        m_log_S.data(), m_log_K.data(), m_sqrt_T.data(), m_volatility.data(), m_drift.data(), m_discount.data(), m_carry.data()
+    };
+
+    TermColumns terms = {
+        columns[0], columns[1], columns[2], columns[3], columns[4], columns[5], call_or_put, underlying_type,
+        columns[6], columns[7], columns[8], columns[9], columns[10], columns[11], columns[12]
+    };
+
+    for (size_t start = 0; start < count; start += BATCH_BLOCK) {
+
+        size_t n = count - start < BATCH_BLOCK ? count - start : BATCH_BLOCK;
+
+        for (size_t slot = 0; slot < n; slot++) {
+
+            size_t index = indices[start + slot];
+
+            if (index >= Size()) throw std::out_of_range("IncrementalPricer::Price: contract index out of range");
+
+            for (size_t column = 0; column < 13; column++) columns[column][slot] = sources[column][index];
+
+            call_or_put[slot] = m_batch.CallOrPut()[index];
+            underlying_type[slot] = m_batch.UnderlyingType()[index];
+        }
+
+        GreeksColumns greeks;
+        greeks.price = prices + start;
+
+        PriceFromTerms(terms, n, GREEK_PRICE, greeks);
+    }
+}
+
+void IncrementalPricer::PriceAndGreeks(unsigned mask, const GreeksColumns& greeks) {
+    /*
+     Price and requested sensitivities of every contract, chunked over the thread pool
+     input:
+        mask of GreekMask values, output columns with Size() elements for every requested output
+     */
+
+    METRIC_SCOPE(mask == GREEK_PRICE ? TIMER_BATCH_PRICE : TIMER_BATCH_GREEKS, Size());
+
+    Refresh();
+
+    ForEachChunk(Size(), [&](size_t begin, size_t end) {
+        PriceBlocks(begin, end, mask, greeks);
+    });
+}
+
+void IncrementalPricer::PriceAndGreeks(unsigned mask, GreeksBatch& greeks) {
+    PriceAndGreeks(mask, greeks.Allocate(Size(), mask));
+}
+
+void IncrementalPricer::UpdateSpotAndPrice(const double* S, double* prices) {
+    /*
+     Tick-driven revaluation: new spots for every contract, then prices. Strikes, maturities, rates
+     and volatilities are untouched, so only log(S) and the normal distribution terms are evaluated
+     */
+
+    Update(UNDERLYING, S);
+
+    Price(prices);
+}
+
+void IncrementalPricer::Refresh() {
+    /*
+     Recompute the stale term columns, on the pool for large batches
+     */
+
+    if (m_stale_terms == 0) return;
+
+    unsigned stale = m_stale_terms;
+
+    ForEachChunk(Size(), [&](size_t begin, size_t end) {
+        RefreshRange(stale, begin, end);
+    });
+
+    m_stale_terms = 0;
+}
+
+void IncrementalPricer::RefreshRange(unsigned stale, size_t begin, size_t end) {
+    /*
+     Recompute the given terms of contracts [begin, end), see EuropeanOption::Terms
+     */
+
+    size_t n = end - begin;
+
+    const double* __restrict S = m_batch.S() + begin;
+    const double* __restrict K = m_batch.K() + begin;
+    const double* __restrict T = m_batch.T() + begin;
+    const double* __restrict r = m_batch.r() + begin;
+    const double* __restrict s = m_batch.s() + begin;
+    const double* __restrict b = m_batch.b() + begin;
+
+    if (stale & TERM_LOG_S) Log(S, m_log_S.data() + begin, n);
+
+    if (stale & TERM_LOG_K) Log(K, m_log_K.data() + begin, n);
+
+    if (stale & TERM_VOLATILITY) {
+        double* __restrict sqrtT = m_sqrt_T.data() + begin;
+        double* __restrict volatility = m_volatility.data() + begin;
+        for (size_t index = 0; index < n; index++) {
+            sqrtT[index] = sqrt(T[index]);
+            volatility[index] = s[index] * sqrtT[index];
+        }
+    }
+
+    if (stale & TERM_DRIFT) {
+        double* __restrict drift = m_drift.data() + begin;
+        for (size_t index = 0; index < n; index++) drift[index] = (b[index] + (s[index]*s[index] / 2.0) ) * T[index];
+    }
+
+    if (stale & TERM_DISCOUNT) {
+        double* __restrict discount = m_discount.data() + begin;
+        for (size_t index = 0; index < n; index++) discount[index] = - r[index] * T[index];
+        Exp(discount, discount, n);
+    }
+
+    if (stale & TERM_CARRY) {
+        double* __restrict carry = m_carry.data() + begin;
+        for (size_t index = 0; index < n; index++) carry[index] = (b[index] - r[index]) * T[index];
+        Exp(carry, carry, n);
+    }
+}
+
+void IncrementalPricer::PriceBlocks(size_t begin, size_t end, unsigned mask, const GreeksColumns& greeks) const {
+    /*
+     Price contracts [begin, end) block by block from the cached terms
+     */
+
+    for (size_t start = begin; start < end; start += BATCH_BLOCK) {
+
+        size_t n = end - start < BATCH_BLOCK ? end - start : BATCH_BLOCK;
+
+        TermColumns terms = {
+            m_batch.S() + start, m_batch.K() + start, m_batch.T() + start, m_batch.r() + start,
+            m_batch.s() + start, m_batch.b() + start, m_batch.CallOrPut() + start, m_batch.UnderlyingType() + start,
+            m_log_S.data() + start, m_log_K.data() + start, m_sqrt_T.data() + start, m_volatility.data() + start,
+            m_drift.data() + start, m_discount.data() + start, m_carry.data() + start
+        };
+
+        PriceFromTerms(terms, n, mask, Offset(greeks, start));
+    }
+}
@@ -0,0 +1,91 @@
+//
+//  File: IncrementalPricer.hpp
+//  Project: ExactPricingModels
+//  Objective: Tick-driven batch repricing that only recomputes terms depending on changed inputs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef IncrementalPricer_hpp
+#define IncrementalPricer_hpp
+
+#include <stdio.h>
+#include "BatchPricer.hpp"
+
+class IncrementalPricer {
+
+    // Attributes
+    OptionBatch m_batch; // Current state of the contracts
+    AlignedVector<double> m_log_S; // log(S)
+    AlignedVector<double> m_log_K; // log(K)
+    AlignedVector<double> m_sqrt_T; // sqrt(T)
+    AlignedVector<double> m_volatility; // s*sqrt(T)
+    AlignedVector<double> m_drift; // (b + s*s/2)*T
+    AlignedVector<double> m_discount; // e^(-rT)
+    AlignedVector<double> m_carry; // e^((b-r)T)
+    unsigned m_stale_terms = ALL_TERMS; // PricingTerm columns to recompute before the next evaluation
+    BatchPricer m_pricer; // Thread pool and chunk size
+
+public:
+    /* CANONICAL HEADER START */
+    IncrementalPricer(){} // Default constructor
+
+    IncrementalPricer(const OptionBatch& batch, ThreadPool* pool = nullptr); // Parameter constructor. Copies the contracts
+
+    virtual ~IncrementalPricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    const OptionBatch& Batch() const {
+        return m_batch;
+    }
+
+    size_t Size() const {
+        return m_batch.Size();
+    }
+
+    unsigned StaleTerms() const {
+        return m_stale_terms;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    /* SETTERS END */
+
+    void Update(enum Parameter parameter, const double* values); // Replace a whole input column and mark the terms depending on it
+
+    void Update(enum Parameter parameter, const size_t* indices, const double* values, size_t count); // Replace the input of some contracts. Their terms are recomputed right away
+
+    void Price(double* prices); // Price every contract into a caller-provided column
+
+    vector<double> Price(); // Price every contract
+
+    void Price(const size_t* indices, size_t count, double* prices); // Price some contracts, prices[k] belongs to indices[k]
+
+    void PriceAndGreeks(unsigned mask, const GreeksColumns& greeks); // Price and requested sensitivities into caller-provided columns
+
+    void PriceAndGreeks(unsigned mask, GreeksBatch& greeks); // Price and requested sensitivities of every contract
+
+    void UpdateSpotAndPrice(const double* S, double* prices); // Tick: replace the spot column and reprice, only log(S) is recomputed
+
+    // Helper functions
+private:
+    void Refresh(); // Recompute the stale term columns
+
+    void RefreshRange(unsigned stale, size_t begin, size_t end); // Recompute terms of contracts [begin, end)
+
+    template <typename Body>
+    void ForEachChunk(size_t size, const Body& body) const; // Split the batch into chunks on the pool
+
+    void PriceBlocks(size_t begin, size_t end, unsigned mask, const GreeksColumns& greeks) const; // Price and Greeks from the cached terms
+
+};
+
+#endif /* IncrementalPricer_hpp */
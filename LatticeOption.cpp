@@ -0,0 +1,478 @@
+//
+//  File: LatticeOption.cpp
+//  Project: ExactPricingModels
+//  Objective: Binomial and trinomial lattice option, inherits Option. American exercise
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "LatticeOption.hpp"
+#include "EuropeanOption.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+struct LatticeTree {
+    /*
+     Everything the contracts induced together share
+     */
+    enum LatticeType lattice = BINOMIAL_LATTICE;
+    size_t steps = 0;
+    bool american = false;
+    double S = 0; // Spot at the root
+    double up = 1, down = 1; // Spot moves of one step
+    double weight_up = 0, weight_middle = 0, weight_down = 0; // Discounted probabilities of the moves
+    vector<double> grid; // Binomial: S u^(2i - n), i = 0..n, then S u^(2i - n + 1), i = 0..n-1. Trinomial: S u^(k - n), k = 0..2n
+};
+
+static LatticeTree BuildTree(const Option& option, const LatticeSettings& settings) {
+    /*
+     Probabilities and spot grids of an option's tree
+     input:
+        option and its settings
+     output:
+        tree
+     */
+
+    size_t n = settings.steps;
+
+    if (n < 2) throw std::invalid_argument("LatticeOption: at least 2 steps are needed");
+    if (!(option.T() > 0) || !(option.s() > 0)) throw std::invalid_argument("LatticeOption: time to maturity and volatility must be positive");
+
+    LatticeTree tree;
+    tree.lattice = settings.lattice;
+    tree.steps = n;
+    tree.american = settings.exercise == AMERICAN_EXERCISE;
+    tree.S = option.S();
+
+    double dt = option.T() / n;
+    double discount = std::exp(-option.r() * dt);
+    double log_up;
+    double p_up, p_middle = 0, p_down;
+
+    if (settings.lattice == BINOMIAL_LATTICE) {
+        log_up = option.s() * std::sqrt(dt);
+        tree.up = std::exp(log_up);
+        tree.down = 1 / tree.up;
+        p_up = (std::exp(option.b() * dt) - tree.down) / (tree.up - tree.down);
+        p_down = 1 - p_up;
+
+        tree.grid.resize(2 * n + 1);
+        for (size_t i = 0; i <= n; i++) tree.grid[i] = (2.0 * i - n) * log_up;
+        for (size_t i = 0; i < n; i++) tree.grid[n + 1 + i] = (2.0 * i - n + 1) * log_up;
+    } else {
+        double half = option.s() * std::sqrt(dt / 2);
+        double growth = std::exp(option.b() * dt / 2);
+        double spread = std::exp(half) - std::exp(-half);
+        log_up = 2 * half;
+        tree.up = std::exp(log_up);
+        tree.down = 1 / tree.up;
+        p_up = std::pow((growth - std::exp(-half)) / spread, 2);
+        p_down = std::pow((std::exp(half) - growth) / spread, 2);
+        p_middle = 1 - p_up - p_down;
+
+        tree.grid.resize(2 * n + 1);
+        for (size_t k = 0; k <= 2 * n; k++) tree.grid[k] = (static_cast<double>(k) - n) * log_up;
+    }
+
+    if (p_up < 0 || p_up > 1 || p_down < 0 || p_down > 1 || p_middle < 0) {
+        throw std::invalid_argument("LatticeOption: probabilities outside [0, 1], use more steps");
+    }
+
+    Exp(tree.grid.data(), tree.grid.data(), tree.grid.size());
+    for (double& spot: tree.grid) spot *= tree.S;
+
+    tree.weight_up = discount * p_up;
+    tree.weight_middle = discount * p_middle;
+    tree.weight_down = discount * p_down;
+
+    return tree;
+}
+
+static LatticeResult Induce(const LatticeTree& tree, double strike, double sign, vector<double>& values) {
+    /*
+     Backward induction of one contract, in place in one array: node i of a step reads nodes i,
+     i + 1 (and i + 2 on a trinomial tree) of the next one, which sit at the same or higher
+     addresses, and LatticeStep loads every vector before storing it, so ascending order never
+     reads a value it has overwritten. Each step is one vectorized pass across its nodes
+     input:
+        tree
+        strike and +1/-1 call/put sign
+        values, scratch array reused across the contracts of a tree
+     output:
+        price, delta and gamma
+     */
+
+    size_t n = tree.steps;
+    bool binomial = tree.lattice == BINOMIAL_LATTICE;
+    size_t branches = binomial ? 2 : 3;
+    double weights[3] = {tree.weight_down, tree.weight_middle, tree.weight_up};
+
+    values.resize(binomial ? n + 1 : 2 * n + 1);
+
+    for (size_t i = 0; i < values.size(); i++) values[i] = std::max(sign * (tree.grid[i] - strike), 0.0);
+
+    double first[2] = {}, second[3] = {};
+
+    if (binomial && n == 2) std::copy(values.begin(), values.begin() + 3, second);
+
+    for (size_t step = n; step-- > 0; ) {
+
+        size_t nodes = binomial ? step + 1 : 2 * step + 1;
+        const double* spot;
+
+        if (binomial) {
+            size_t offset = n - step;
+            spot = offset % 2 == 0 ? tree.grid.data() + offset / 2 : tree.grid.data() + n + 1 + (offset - 1) / 2;
+        } else {
+            spot = tree.grid.data() + (n - step);
+        }
+
+        LatticeStep(values.data(), spot, weights, branches, strike, sign, tree.american, values.data(), nodes);
+
+        if (step == 2 && binomial) std::copy(values.begin(), values.begin() + 3, second);
+        if (step == 1) std::copy(values.begin(), values.begin() + (binomial ? 2 : 3), binomial ? first : second);
+    }
+
+    // Delta and gamma from three nodes: S d^2, S, S u^2 after two binomial steps, S d, S, S u after one
+    // trinomial step. Binomial delta comes from the two nodes after the first step
+    double S = tree.S;
+    double low = binomial ? S * tree.down * tree.down : S * tree.down;
+    double high = binomial ? S * tree.up * tree.up : S * tree.up;
+
+    LatticeResult result;
+    result.price = values[0];
+    result.delta = binomial ? (first[1] - first[0]) / (S * tree.up - S * tree.down) : (second[2] - second[0]) / (high - low);
+    result.gamma = ((second[2] - second[1]) / (high - S) - (second[1] - second[0]) / (S - low)) / (0.5 * (high - low));
+
+    return result;
+}
+
+LatticeOption::LatticeOption(const LatticeOption& other_option) :
+Option(other_option),
+m_settings(other_option.m_settings) {
+    /*
+     Copy constructor
+     */
+}
+
+LatticeOption::LatticeOption(double underlying_price,
+                             double strike_price,
+                             double time_to_maturity,
+                             double riskfree_rate,
+                             double constant_volatility,
+                             enum CallOrPut call_or_put,
+                             enum UnderlyingType underlying_type,
+                             double dividend_yield,
+                             double foreign_rate,
+                             const LatticeSettings& settings) :
+Option(underlying_price,
+       strike_price,
+       time_to_maturity,
+       riskfree_rate,
+       constant_volatility,
+       call_or_put,
+       underlying_type,
+       dividend_yield,
+       foreign_rate),
+m_settings(settings) {
+    /*
+     Parameter constructor
+     */
+}
+
+LatticeOption& LatticeOption::operator = (const LatticeOption& other_option){
+    /*
+     Assignment operator overload
+     */
+
+    if(this == &other_option){
+        return *this;
+    }
+
+    Option::operator=(other_option);
+
+    m_settings = other_option.m_settings;
+
+    return *this;
+}
+
+LatticeResult LatticeOption::Evaluate() const {
+    /*
+     Induce the option's tree
+     output:
+        price, delta and gamma
+     */
+
+    METRIC_SCOPE(TIMER_LATTICE, 1);
+
+    vector<double> values;
+
+    return Induce(BuildTree(*this, m_settings), K(), CallOrPut() == CALL ? 1 : -1, values);
+}
+
+double LatticeOption::Price() const {
+    /*
+     Price the option
+     */
+
+    return Evaluate().price;
+}
+
+vector<double> LatticeOption::Price(double price) const {
+    /*
+     Price the option using put-call parity
+     input:
+        option price
+     output:
+        vector with option price and parity difference
+     */
+
+    ParityResult parity = Parity(price);
+
+    return {parity.price, parity.difference};
+}
+
+ParityResult LatticeOption::Parity(double price) const {
+    /*
+     Put-call parity, the same relation as EuropeanOption. American options only satisfy bounds
+     input:
+        option price
+     output:
+        price of the opposite option type and parity difference
+     */
+
+    if (m_settings.exercise == AMERICAN_EXERCISE) {
+        throw std::invalid_argument("LatticeOption::Parity: put-call parity does not hold for American exercise");
+    }
+
+    EuropeanOption european(S(), K(), T(), r(), s(), CallOrPut(), UnderlyingType(), q(), R());
+    european.b(b());
+
+    return european.Parity(price);
+}
+
+vector<double> LatticeOption::Price(const vector<double>& parameter_mesh, enum Parameter parameter) const {
+    /*
+     Price the option using an array of parameters
+     input:
+        parameter mesh
+        parameter type
+     output:
+        vector with prices
+     */
+
+    vector<double> prices(parameter_mesh.size());
+
+    Price(parameter_mesh, parameter, prices);
+
+    return prices;
+}
+
+void LatticeOption::Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const {
+    /*
+     Price the option using an array of parameters into a caller-provided array. The points go
+     through LatticePricer, so a STRIKE mesh shares one tree
+     input:
+        parameter mesh
+        parameter type
+        prices, same size as the mesh
+     */
+
+    if (prices.size() != parameter_mesh.size()) {
+        throw std::invalid_argument("LatticeOption::Price: output size differs from mesh size");
+    }
+
+    vector<LatticeOption> points;
+    points.reserve(parameter_mesh.size());
+    for (double value: parameter_mesh) points.push_back(WithParameter(parameter, value));
+
+    vector<double> values = LatticePricer().Price(points);
+
+    std::copy(values.begin(), values.end(), prices.begin());
+}
+
+double LatticeOption::Delta() const {
+    /*
+     Compute delta
+     */
+
+    return Evaluate().delta;
+}
+
+double LatticeOption::Gamma() const {
+    /*
+     Compute gamma
+     */
+
+    return Evaluate().gamma;
+}
+
+vector<double> LatticeOption::Delta(const vector<double>& price_mesh) const {
+    /*
+     Compute delta using array of underlying prices
+     */
+
+    vector<double> deltas(price_mesh.size());
+
+    Delta(price_mesh, deltas);
+
+    return deltas;
+}
+
+vector<double> LatticeOption::Gamma(const vector<double>& price_mesh) const {
+    /*
+     Compute gamma using array of underlying prices
+     */
+
+    vector<double> gammas(price_mesh.size());
+
+    Gamma(price_mesh, gammas);
+
+    return gammas;
+}
+
+void LatticeOption::Delta(span<const double> price_mesh, span<double> deltas) const {
+    /*
+     Compute delta using array of underlying prices into a caller-provided array
+     */
+
+    if (deltas.size() != price_mesh.size()) {
+        throw std::invalid_argument("LatticeOption::Delta: output size differs from mesh size");
+    }
+
+    vector<LatticeOption> points;
+    points.reserve(price_mesh.size());
+    for (double value: price_mesh) points.push_back(WithParameter(UNDERLYING, value));
+
+    vector<LatticeResult> results = LatticePricer().Evaluate(points);
+
+    for (size_t index = 0; index < results.size(); index++) deltas[index] = results[index].delta;
+}
+
+void LatticeOption::Gamma(span<const double> price_mesh, span<double> gammas) const {
+    /*
+     Compute gamma using array of underlying prices into a caller-provided array
+     */
+
+    if (gammas.size() != price_mesh.size()) {
+        throw std::invalid_argument("LatticeOption::Gamma: output size differs from mesh size");
+    }
+
+    vector<LatticeOption> points;
+    points.reserve(price_mesh.size());
+    for (double value: price_mesh) points.push_back(WithParameter(UNDERLYING, value));
+
+    vector<LatticeResult> results = LatticePricer().Evaluate(points);
+
+    for (size_t index = 0; index < results.size(); index++) gammas[index] = results[index].gamma;
+}
+
+double LatticeOption::EarlyExercisePremium() const {
+    /*
+     American minus European price, both on the same tree, so the discretization error mostly cancels
+     */
+
+    LatticeOption european(*this);
+    LatticeSettings settings = m_settings;
+    settings.exercise = EUROPEAN_EXERCISE;
+    european.Settings(settings);
+
+    settings.exercise = AMERICAN_EXERCISE;
+    LatticeOption american(*this);
+    american.Settings(settings);
+
+    return american.Price() - european.Price();
+}
+
+LatticeOption LatticeOption::WithParameter(enum Parameter parameter, double value) const {
+    /*
+     Copy of the option with one parameter replaced. A RATE point keeps the carry cost, like the
+     EuropeanOption meshes
+     */
+
+    LatticeOption option(*this);
+
+    switch (parameter) {
+        case UNDERLYING: option.S(value); break;
+        case STRIKE: option.K(value); break;
+        case TIME: option.T(value); break;
+        case RATE: option.r(value); break;
+        case SIGMA: option.s(value); break;
+        case CARRY: option.b(value); break;
+        default: break;
+    }
+
+    return option;
+}
+
+vector<LatticeResult> LatticePricer::Evaluate(const vector<LatticeOption>& book) const {
+    /*
+     Group the book by tree, split each group into chunks of LATTICE_CHUNK contracts and induce
+     the chunks on the thread pool
+     input:
+        book
+     output:
+        price, delta and gamma of every option, in book order
+     */
+
+    METRIC_SCOPE(TIMER_LATTICE, book.size());
+
+    auto tree_key = [&](size_t index) {
+        const LatticeOption& option = book[index];
+        const LatticeSettings& settings = option.Settings();
+        return std::make_tuple(option.S(), option.T(), option.r(), option.s(), option.b(),
+                               settings.steps, static_cast<int>(settings.lattice), static_cast<int>(settings.exercise));
+    };
+
+    vector<size_t> order(book.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return tree_key(a) < tree_key(b); });
+
+    // Chunks of contracts sharing a tree: [begin, end) of order
+    vector<std::pair<size_t, size_t>> chunks;
+
+    for (size_t begin = 0; begin < order.size(); ) {
+        size_t end = begin + 1;
+        while (end < order.size() && end - begin < LATTICE_CHUNK && tree_key(order[end]) == tree_key(order[begin])) end++;
+        chunks.emplace_back(begin, end);
+        begin = end;
+    }
+
+    vector<LatticeResult> results(book.size());
+
+    auto body = [&](size_t first_chunk, size_t last_chunk) {
+        vector<double> values;
+        for (size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+            const LatticeOption& leader = book[order[chunks[chunk].first]];
+            LatticeTree tree = BuildTree(leader, leader.Settings());
+            for (size_t position = chunks[chunk].first; position < chunks[chunk].second; position++) {
+                const LatticeOption& option = book[order[position]];
+                results[order[position]] = Induce(tree, option.K(), option.CallOrPut() == CALL ? 1 : -1, values);
+            }
+        }
+    };
+
+    Pool().ParallelFor(0, chunks.size(), 1, std::cref(body));
+
+    return results;
+}
+
+vector<double> LatticePricer::Price(const vector<LatticeOption>& book) const {
+    /*
+     Price every option of a book
+     */
+
+    vector<LatticeResult> results = Evaluate(book);
+
+    vector<double> prices(results.size());
+    for (size_t index = 0; index < results.size(); index++) prices[index] = results[index].price;
+
+    return prices;
+}
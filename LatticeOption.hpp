@@ -0,0 +1,157 @@
+//
+//  File: LatticeOption.hpp
+//  Project: ExactPricingModels
+//  Objective: Binomial and trinomial lattice option, inherits Option. American exercise
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef LatticeOption_hpp
+#define LatticeOption_hpp
+
+#include <stdio.h>
+#include "Option.hpp"
+#include "ThreadPool.hpp"
+
+enum LatticeType{ BINOMIAL_LATTICE, TRINOMIAL_LATTICE }; // Cox-Ross-Rubinstein binomial or Boyle trinomial tree
+
+const size_t LATTICE_CHUNK = 8; // Contracts of a batch group sharing one tree build per pool task
+
+struct LatticeSettings {
+    size_t steps = 1000; // Time steps, at least 2
+    enum LatticeType lattice = BINOMIAL_LATTICE;
+    enum ExerciseStyle exercise = AMERICAN_EXERCISE;
+};
+
+struct LatticeResult {
+    double price = 0; // Value at the root
+    double delta = 0; // From the nodes after the first step (binomial: second step for gamma)
+    double gamma = 0;
+};
+
+class LatticeOption : public Option {
+    /*
+     Prices an option by backward induction on a recombining tree with the same carry cost b as
+     EuropeanOption. Node values of a step overwrite those of the next step in place, in one
+     contiguous array, and spot prices come from precomputed grids of S u^k read with unit stride,
+     so each step is one pass of the vectorized LatticeStep kernel across its nodes. With European exercise
+     the price converges to EuropeanOption::Price() as O(1/steps). Delta and gamma are read off
+     the first nodes of the same tree
+     */
+
+    // Attributes
+    LatticeSettings m_settings; // Tree settings
+
+public:
+    /* CANONICAL HEADER START */
+    LatticeOption(){} // Default constructor
+
+    LatticeOption(const LatticeOption& other_option); // Copy constructor
+
+    LatticeOption(double underlying_price,
+                  double strike_price,
+                  double time_to_maturity,
+                  double riskfree_rate,
+                  double constant_volatility,
+                  enum CallOrPut call_or_put,
+                  enum UnderlyingType underlying_type,
+                  double dividend_yield = 0,
+                  double foreign_rate = 0,
+                  const LatticeSettings& settings = LatticeSettings()); // Parameter constructor
+
+    virtual ~LatticeOption(){} // Destructor
+
+    LatticeOption& operator = (const LatticeOption& other_option); // Assignment operator overload
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    const LatticeSettings& Settings() const {
+        return m_settings;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Settings(const LatticeSettings& settings) {
+        this->m_settings = settings;
+    }
+
+    /* SETTERS END */
+
+    LatticeResult Evaluate() const; // Price, delta and gamma from one induction
+
+    double Price() const; // Price the option
+
+    vector<double> Price(double price) const; // Price the option using put-call parity. European exercise only
+
+    ParityResult Parity(double price) const; // Price the option using put-call parity, without allocating. European exercise only
+
+    vector<double> Price(const vector<double>& parameter_mesh, enum Parameter parameter) const; // Price the option using an array of parameters
+
+    void Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const; // Price the option using an array of parameters into a caller-provided array
+
+    double Delta() const; // Compute delta
+
+    double Gamma() const; // Compute gamma
+
+    vector<double> Delta(const vector<double>& price_mesh) const; // Compute delta using array of underlying prices
+
+    vector<double> Gamma(const vector<double>& price_mesh) const; // Compute gamma using array of underlying prices
+
+    void Delta(span<const double> price_mesh, span<double> deltas) const; // Compute delta using array of underlying prices into a caller-provided array
+
+    void Gamma(span<const double> price_mesh, span<double> gammas) const; // Compute gamma using array of underlying prices into a caller-provided array
+
+    double EarlyExercisePremium() const; // American minus European price on the same tree
+
+    // Helper functions
+private:
+    LatticeOption WithParameter(enum Parameter parameter, double value) const; // Copy with one parameter replaced, as in the EuropeanOption meshes
+
+};
+
+class LatticePricer {
+    /*
+     Prices a book of lattice options. Contracts sharing a tree (same S, T, r, s, b and settings,
+     e.g. every strike of one underlying and expiry) are grouped, so the tree's spot grids and
+     probabilities are computed once per LATTICE_CHUNK contracts and the contracts are induced
+     one after another in the same scratch array, which stays in cache
+     */
+
+    // Attributes
+    ThreadPool* m_pool = nullptr; // Pool running the groups, nullptr for the shared pool
+
+public:
+    /* CANONICAL HEADER START */
+    LatticePricer(){} // Default constructor
+
+    LatticePricer(ThreadPool* pool) : m_pool(pool) {} // Parameter constructor
+
+    virtual ~LatticePricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    ThreadPool& Pool() const {
+        return m_pool ? *m_pool : ThreadPool::Instance();
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        this->m_pool = pool;
+    }
+
+    /* SETTERS END */
+
+    vector<LatticeResult> Evaluate(const vector<LatticeOption>& book) const; // Price, delta and gamma of every option, in book order
+
+    vector<double> Price(const vector<LatticeOption>& book) const; // Price of every option, in book order
+
+};
+
+#endif /* LatticeOption_hpp */
@@ -0,0 +1,356 @@
+//
+//  File: MarketData.cpp
+//  Project: ExactPricingModels
+//  Objective: Shared market state with lock-free consistent snapshots, and books priced against a snapshot
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "MarketData.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+static const size_t MARKET_FIELDS = 4; // S, s, r, b of an underlying, stored together
+
+struct MarketDataStore::Version {
+    std::atomic<uint64_t> sequence{0}; // Even when stable, odd while the writer fills the version
+    std::atomic<uint64_t> id{0}; // Snapshot id held
+    std::unique_ptr<std::atomic<double>[]> quotes; // MARKET_FIELDS values per underlying, underlying-major
+};
+
+MarketDataStore::MarketDataStore(size_t underlyings) :
+m_underlyings(underlyings),
+m_versions(new Version[MARKET_VERSIONS]),
+m_staged(underlyings) {
+    /*
+     Parameter constructor
+     input:
+        number of underlyings
+     */
+
+    for (size_t index = 0; index < MARKET_VERSIONS; index++) {
+        m_versions[index].quotes.reset(new std::atomic<double>[underlyings * MARKET_FIELDS]);
+        for (size_t i = 0; i < underlyings * MARKET_FIELDS; i++) m_versions[index].quotes[i].store(0.0, std::memory_order_relaxed);
+    }
+}
+
+MarketDataStore::~MarketDataStore() {
+    /*
+     Destructor
+     */
+}
+
+void MarketDataStore::Set(size_t underlying, const MarketQuote& quote) {
+    /*
+     Stage a quote. Readers keep seeing the previous one until Publish
+     input:
+        underlying index, quote
+     */
+
+    if (underlying >= m_underlyings) {
+        throw std::invalid_argument("MarketDataStore::Set: unknown underlying");
+    }
+
+    while (m_writer.test_and_set(std::memory_order_acquire)) {
+        while (m_writer.test(std::memory_order_relaxed)) {}
+    }
+
+    m_staged[underlying] = quote;
+
+    m_writer.clear(std::memory_order_release);
+}
+
+uint64_t MarketDataStore::Publish() {
+    /*
+     Copy the staged quotes into the ring version after the current one and make it current.
+     That version was current MARKET_VERSIONS publications ago, so only a reader still copying it
+     then has to retry
+     output:
+        new snapshot id
+     */
+
+    while (m_writer.test_and_set(std::memory_order_acquire)) {
+        while (m_writer.test(std::memory_order_relaxed)) {}
+    }
+
+    uint64_t id = m_latest.load(std::memory_order_relaxed) + 1;
+    Version& version = m_versions[id % MARKET_VERSIONS];
+
+    uint64_t sequence = version.sequence.load(std::memory_order_relaxed);
+    version.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::atomic<double>* quotes = version.quotes.get();
+
+    for (size_t underlying = 0; underlying < m_underlyings; underlying++) {
+        const MarketQuote& quote = m_staged[underlying];
+        quotes[underlying * MARKET_FIELDS + 0].store(quote.S, std::memory_order_relaxed);
+        quotes[underlying * MARKET_FIELDS + 1].store(quote.s, std::memory_order_relaxed);
+        quotes[underlying * MARKET_FIELDS + 2].store(quote.r, std::memory_order_relaxed);
+        quotes[underlying * MARKET_FIELDS + 3].store(quote.b, std::memory_order_relaxed);
+    }
+
+    version.id.store(id, std::memory_order_relaxed);
+    version.sequence.store(sequence + 2, std::memory_order_release);
+
+    m_latest.store(id, std::memory_order_release);
+
+    m_writer.clear(std::memory_order_release);
+
+    return id;
+}
+
+uint64_t MarketDataStore::Update(size_t underlying, const MarketQuote& quote) {
+    Set(underlying, quote);
+    return Publish();
+}
+
+void MarketDataStore::Snapshot(MarketSnapshot& snapshot) const {
+    /*
+     Copy the latest version without locking. The copy is kept when the version's sequence was
+     even and unchanged around it and the version still held the id read from m_latest;
+     otherwise a writer reused it meanwhile and the copy restarts from the new latest id
+     input:
+        reader's snapshot, resized to the number of underlyings on first use
+     */
+
+    if (snapshot.Size() != m_underlyings) {
+        snapshot.S.resize(m_underlyings);
+        snapshot.s.resize(m_underlyings);
+        snapshot.r.resize(m_underlyings);
+        snapshot.b.resize(m_underlyings);
+    }
+
+    double* __restrict S = snapshot.S.data();
+    double* __restrict s = snapshot.s.data();
+    double* __restrict r = snapshot.r.data();
+    double* __restrict b = snapshot.b.data();
+
+    while (true) {
+
+        uint64_t id = m_latest.load(std::memory_order_acquire);
+        const Version& version = m_versions[id % MARKET_VERSIONS];
+
+        uint64_t before = version.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        const std::atomic<double>* quotes = version.quotes.get();
+
+        for (size_t underlying = 0; underlying < m_underlyings; underlying++) {
+            S[underlying] = quotes[underlying * MARKET_FIELDS + 0].load(std::memory_order_relaxed);
+            s[underlying] = quotes[underlying * MARKET_FIELDS + 1].load(std::memory_order_relaxed);
+            r[underlying] = quotes[underlying * MARKET_FIELDS + 2].load(std::memory_order_relaxed);
+            b[underlying] = quotes[underlying * MARKET_FIELDS + 3].load(std::memory_order_relaxed);
+        }
+
+        uint64_t held = version.id.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (version.sequence.load(std::memory_order_relaxed) == before && held == id) {
+            snapshot.id = id;
+            return;
+        }
+    }
+}
+
+MarketSnapshot MarketDataStore::Snapshot() const {
+    MarketSnapshot snapshot;
+    Snapshot(snapshot);
+    return snapshot;
+}
+
+MarketQuote MarketDataStore::Quote(size_t underlying, uint64_t* id) const {
+    /*
+     Latest quote of one underlying, read like Snapshot but for its four fields only
+     input:
+        underlying index, optional output for the snapshot id
+     output:
+        quote
+     */
+
+    if (underlying >= m_underlyings) {
+        throw std::invalid_argument("MarketDataStore::Quote: unknown underlying");
+    }
+
+    while (true) {
+
+        uint64_t latest = m_latest.load(std::memory_order_acquire);
+        const Version& version = m_versions[latest % MARKET_VERSIONS];
+
+        uint64_t before = version.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        const std::atomic<double>* quotes = version.quotes.get() + underlying * MARKET_FIELDS;
+
+        MarketQuote quote;
+        quote.S = quotes[0].load(std::memory_order_relaxed);
+        quote.s = quotes[1].load(std::memory_order_relaxed);
+        quote.r = quotes[2].load(std::memory_order_relaxed);
+        quote.b = quotes[3].load(std::memory_order_relaxed);
+
+        uint64_t held = version.id.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (version.sequence.load(std::memory_order_relaxed) == before && held == latest) {
+            if (id) *id = latest;
+            return quote;
+        }
+    }
+}
+
+size_t MarketBook::Add(double strike_price, double time_to_maturity, enum CallOrPut call_or_put,
+                       enum UnderlyingType underlying_type, size_t underlying) {
+    /*
+     Append a contract
+     input:
+        strike, time to maturity, call or put, underlying class, underlying index in the store
+     output:
+        index of the contract
+     */
+
+    m_contracts.Add(0, strike_price, time_to_maturity, 0, 0, call_or_put, underlying_type);
+    m_underlying.push_back(underlying);
+
+    if (underlying >= m_underlyings) m_underlyings = underlying + 1;
+
+    return m_contracts.Size() - 1;
+}
+
+void MarketBook::Clear() {
+    m_contracts.Clear();
+    m_underlying.clear();
+    m_underlyings = 0;
+}
+
+EuropeanOption MarketBook::Contract(size_t index, const MarketSnapshot& snapshot) const {
+    /*
+     Rebuild a single option with the market of its underlying in the snapshot
+     input:
+        contract index, snapshot
+     output:
+        option
+     */
+
+    Validate(snapshot);
+
+    MarketQuote quote = snapshot.Quote(m_underlying[index]);
+
+    EuropeanOption option(quote.S, m_contracts.K()[index], m_contracts.T()[index], quote.r, quote.s,
+                          static_cast<enum CallOrPut>(m_contracts.CallOrPut()[index]),
+                          static_cast<enum UnderlyingType>(m_contracts.UnderlyingType()[index]));
+    option.b(quote.b);
+
+    return option;
+}
+
+void MarketBook::Validate(const MarketSnapshot& snapshot) const {
+    if (snapshot.Size() < m_underlyings) {
+        throw std::invalid_argument("MarketBook: the snapshot does not cover every underlying of the book");
+    }
+}
+
+template <typename Body>
+void MarketBook::ForEachBlock(const MarketSnapshot& snapshot, const Body& body) const {
+    /*
+     Split the book in chunks over the pool, and each chunk in blocks of BATCH_BLOCK contracts
+     whose spot, volatility, rate and carry columns are gathered from the snapshot on the stack
+     input:
+        snapshot covering the book, body(view, first contract) called once per block
+     */
+
+    Validate(snapshot);
+
+    OptionBatchView book = m_contracts.View();
+
+    auto chunk = [&](size_t begin, size_t end) {
+
+        alignas(COLUMN_ALIGNMENT) double S[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double r[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double s[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double b[BATCH_BLOCK];
+
+        for (size_t start = begin; start < end; start += BATCH_BLOCK) {
+
+            size_t count = std::min(BATCH_BLOCK, end - start);
+            const size_t* underlying = m_underlying.data() + start;
+
+            for (size_t index = 0; index < count; index++) {
+                size_t u = underlying[index];
+                S[index] = snapshot.S[u];
+                r[index] = snapshot.r[u];
+                s[index] = snapshot.s[u];
+                b[index] = snapshot.b[u];
+            }
+
+            OptionBatchView block = book.Slice(start, start + count);
+            block.S = S;
+            block.r = r;
+            block.s = s;
+            block.b = b;
+
+            body(block, start);
+        }
+    };
+
+    if (Size() <= m_pricer.ChunkSize()) {
+        chunk(0, Size());
+        return;
+    }
+
+    m_pricer.Pool().ParallelFor(0, Size(), m_pricer.ChunkSize(), std::cref(chunk));
+}
+
+void MarketBook::Price(const MarketSnapshot& snapshot, double* prices) const {
+    /*
+     Price every contract against one snapshot
+     input:
+        snapshot covering the book
+        output column with at least Size() elements
+     */
+
+    // Blocks are priced one at a time inside the chunks, never split further
+    BatchPricer block_pricer(nullptr, BATCH_BLOCK, m_pricer.Precision());
+
+    ForEachBlock(snapshot, [&](const OptionBatchView& block, size_t first) {
+        block_pricer.Price(block, prices + first);
+    });
+}
+
+uint64_t MarketBook::Price(const MarketDataStore& store, MarketSnapshot& snapshot, double* prices) const {
+    /*
+     Take the latest snapshot of the store and price every contract against it. Updates
+     published meanwhile do not reach this call
+     input:
+        store, reader's snapshot (reused between calls), output column with at least Size() elements
+     output:
+        snapshot id the prices belong to
+     */
+
+    store.Snapshot(snapshot);
+
+    Price(snapshot, prices);
+
+    return snapshot.id;
+}
+
+void MarketBook::PriceAndGreeks(const MarketSnapshot& snapshot, unsigned mask, const GreeksColumns& greeks) const {
+    /*
+     Price and requested sensitivities of every contract against one snapshot
+     input:
+        snapshot covering the book, mask of GreekMask values, output columns
+     */
+
+    BatchPricer block_pricer(nullptr, BATCH_BLOCK, m_pricer.Precision());
+
+    ForEachBlock(snapshot, [&](const OptionBatchView& block, size_t first) {
+        GreeksColumns columns = greeks;
+        for (double** column: {&columns.price, &columns.delta, &columns.gamma, &columns.vega,
+                               &columns.theta, &columns.rho, &columns.carry_rho}) {
+            if (*column) *column += first;
+        }
+        block_pricer.PriceAndGreeks(block, mask, columns);
+    });
+}
@@ -0,0 +1,189 @@
+//
+//  File: MarketData.hpp
+//  Project: ExactPricingModels
+//  Objective: Shared market state with lock-free consistent snapshots, and books priced against a snapshot
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef MarketData_hpp
+#define MarketData_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "BatchPricer.hpp"
+
+const size_t MARKET_VERSIONS = 4; // Published versions kept in the ring; a writer reuses a version MARKET_VERSIONS publications after it was current
+
+struct MarketQuote {
+    /*
+     Market inputs of one underlying
+     */
+    double S = 0; // Underlying price
+    double s = 0; // Constant volatility
+    double r = 0; // Risk-free rate
+    double b = 0; // Cost of carry, as EuropeanOption::b(), e.g. CostOfCarry(type, r, q, R)
+};
+
+struct MarketSnapshot {
+    /*
+     A reader's private copy of one published version, in columns indexed by underlying.
+     Reusing a snapshot for the next Snapshot() call does not allocate
+     */
+    uint64_t id = 0; // Publication number of the version copied, 0 for the initial state
+    AlignedVector<double> S; // Underlying prices
+    AlignedVector<double> s; // Volatilities
+    AlignedVector<double> r; // Risk-free rates
+    AlignedVector<double> b; // Costs of carry
+
+    size_t Size() const {
+        return S.size();
+    }
+
+    MarketQuote Quote(size_t underlying) const {
+        MarketQuote quote;
+        quote.S = S[underlying];
+        quote.s = s[underlying];
+        quote.r = r[underlying];
+        quote.b = b[underlying];
+        return quote;
+    }
+};
+
+class MarketDataStore {
+    /*
+     Spots, volatilities, rates and carries of a fixed set of underlyings, shared by a feed thread
+     and any number of pricing threads. Writers stage quotes with Set and make them visible
+     together with Publish, which copies the staged state into the next version of a ring of
+     MARKET_VERSIONS and bumps the snapshot id. Each version is a seqlock: readers take no lock,
+     copy the current version and keep the copy only when its sequence did not move meanwhile, so
+     a snapshot never mixes two publications. A reader retries only when a writer laps the ring
+     during its copy. Writers are serialized by a spinlock and never wait for readers
+     */
+
+    struct Version; // Sequence, id and quotes of one published state
+
+    // Attributes
+    size_t m_underlyings = 0; // Number of underlyings
+    std::unique_ptr<Version[]> m_versions; // Ring of MARKET_VERSIONS published states
+    std::atomic<uint64_t> m_latest{0}; // Id of the current version
+    vector<MarketQuote> m_staged; // Writer state, published by the next Publish
+    std::atomic_flag m_writer = ATOMIC_FLAG_INIT; // Held by Set and Publish
+
+public:
+    /* CANONICAL HEADER START */
+    MarketDataStore(size_t underlyings); // Parameter constructor. Every quote starts at zero, under id 0
+
+    MarketDataStore(const MarketDataStore& other_store) = delete; // Not copyable
+
+    virtual ~MarketDataStore(); // Destructor
+
+    MarketDataStore& operator = (const MarketDataStore& other_store) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Underlyings() const {
+        return m_underlyings;
+    }
+
+    uint64_t Latest() const {
+        return m_latest.load(std::memory_order_acquire);
+    }
+
+    /* GETTERS END */
+
+    void Set(size_t underlying, const MarketQuote& quote); // Stage a quote, visible to readers after the next Publish. Throws std::invalid_argument for an unknown underlying
+
+    uint64_t Publish(); // Make every staged quote visible at once, returns the new snapshot id
+
+    uint64_t Update(size_t underlying, const MarketQuote& quote); // Set and Publish
+
+    void Snapshot(MarketSnapshot& snapshot) const; // Copy the latest version into a reader's snapshot, without locking
+
+    MarketSnapshot Snapshot() const; // Same into a new snapshot
+
+    MarketQuote Quote(size_t underlying, uint64_t* id = nullptr) const; // Latest quote of one underlying, optionally with its snapshot id
+
+};
+
+class MarketBook {
+    /*
+     European contracts that refer to underlyings of a MarketDataStore by index instead of holding
+     market values. Only strike, maturity, call or put and underlying class are stored; spot,
+     volatility, rate and carry are gathered from a snapshot block by block, as the scenario
+     pricer gathers shocked inputs, so every contract of a call is priced against the same
+     snapshot id
+     */
+
+    // Attributes
+    OptionBatch m_contracts; // Contract terms. The market columns are unused
+    vector<size_t> m_underlying; // Underlying of each contract
+    size_t m_underlyings = 0; // One past the largest underlying index
+    BatchPricer m_pricer; // Thread pool, contracts per chunk and precision
+
+public:
+    /* CANONICAL HEADER START */
+    MarketBook(){} // Default constructor
+
+    MarketBook(ThreadPool* pool) : m_pricer(pool) {} // Parameter constructor
+
+    virtual ~MarketBook(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Size() const {
+        return m_contracts.Size();
+    }
+
+    size_t Underlyings() const {
+        return m_underlyings;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    void ChunkSize(size_t chunk_size) {
+        m_pricer.ChunkSize(chunk_size);
+    }
+
+    void Precision(enum Precision precision) {
+        m_pricer.Precision(precision);
+    }
+
+    /* SETTERS END */
+
+    size_t Add(double strike_price,
+               double time_to_maturity,
+               enum CallOrPut call_or_put,
+               enum UnderlyingType underlying_type,
+               size_t underlying); // Append a contract on an underlying of the store, returns its index
+
+    void Clear(); // Remove every contract
+
+    EuropeanOption Contract(size_t index, const MarketSnapshot& snapshot) const; // Rebuild a single option with the snapshot's market
+
+    void Price(const MarketSnapshot& snapshot, double* prices) const; // Price every contract against a snapshot into a caller-provided column
+
+    uint64_t Price(const MarketDataStore& store, MarketSnapshot& snapshot, double* prices) const; // Take a snapshot of the store into snapshot and price against it, returns its id
+
+    void PriceAndGreeks(const MarketSnapshot& snapshot, unsigned mask, const GreeksColumns& greeks) const; // Price and requested sensitivities against a snapshot
+
+    // Helper functions
+private:
+    void Validate(const MarketSnapshot& snapshot) const; // The snapshot covers every underlying of the book
+
+    template <typename Body>
+    void ForEachBlock(const MarketSnapshot& snapshot, const Body& body) const; // Run body on every block with its market gathered from the snapshot
+
+};
+
+#endif /* MarketData_hpp */
@@ -0,0 +1,137 @@
+//
+//  File: MeshView.cpp
+//  Project: ExactPricingModels
+//  Objective: Lazy parameter meshes generated from their index instead of stored
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "MeshView.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+#include <stdexcept>
+
+const double MESH_PI = 3.14159265358979323846; // pi
+
+MeshView::MeshView(enum MeshSpacing spacing, double start, double end, size_t size) :
+m_spacing(spacing),
+m_start(start),
+m_end(end),
+m_size(size) {
+    /*
+     Parameter constructor
+     input:
+        spacing (not EXPLICIT_MESH), first point, last point, number of points
+     */
+
+    if (!std::isfinite(start) || !std::isfinite(end)) {
+        throw std::invalid_argument("MeshView: start and end must be finite");
+    }
+
+    switch (spacing) {
+        case LINEAR_MESH:
+            m_scale = end - start;
+            break;
+        case LOG_MESH:
+            if (start <= 0 || end <= 0) throw std::invalid_argument("MeshView: a logarithmic mesh needs positive start and end");
+            m_scale = log(end / start);
+            break;
+        case CHEBYSHEV_MESH:
+            m_scale = (end - start) / 2.0;
+            break;
+        default:
+            throw std::invalid_argument("MeshView: explicit meshes are built from their values");
+    }
+}
+
+MeshView::MeshView(std::span<const double> values) :
+m_spacing(EXPLICIT_MESH),
+m_start(values.empty() ? 0 : values.front()),
+m_end(values.empty() ? 0 : values.back()),
+m_size(values.size()),
+m_values(values.data()) {
+    /*
+     View of existing values, which must outlive the view
+     */
+}
+
+MeshView MeshView::Linear(double start, double end, size_t size) {
+    return MeshView(LINEAR_MESH, start, end, size);
+}
+
+MeshView MeshView::Logarithmic(double start, double end, size_t size) {
+    return MeshView(LOG_MESH, start, end, size);
+}
+
+MeshView MeshView::Chebyshev(double start, double end, size_t size) {
+    return MeshView(CHEBYSHEV_MESH, start, end, size);
+}
+
+double MeshView::operator [] (size_t index) const {
+    /*
+     Point `index`, computed from the index only. The first and last points are exactly start and end
+     input:
+        index below Size()
+     output:
+        point
+     */
+
+    if (m_spacing == EXPLICIT_MESH) return m_values[index];
+
+    double value = 0;
+
+    Fill(index, 1, &value);
+
+    return value;
+}
+
+void MeshView::Fill(size_t begin, size_t count, double* values) const {
+    /*
+     Points [begin, begin + count). LOG_MESH points go through the array exp kernel
+     input:
+        first index, number of points, output array with count elements
+     */
+
+    if (count == 0) return;
+
+    if (m_spacing == EXPLICIT_MESH) {
+        for (size_t index = 0; index < count; index++) values[index] = m_values[begin + index];
+        return;
+    }
+
+    double inverse = m_size > 1 ? 1.0 / double(m_size - 1) : 0;
+
+    switch (m_spacing) {
+        case LOG_MESH:
+            for (size_t index = 0; index < count; index++) values[index] = double(begin + index) * inverse * m_scale;
+            Exp(values, values, count);
+            for (size_t index = 0; index < count; index++) values[index] *= m_start;
+            break;
+        case CHEBYSHEV_MESH:
+            for (size_t index = 0; index < count; index++) values[index] = m_start + m_scale * (1.0 - cos(MESH_PI * double(begin + index) * inverse));
+            break;
+        default:
+            for (size_t index = 0; index < count; index++) values[index] = m_start + m_scale * (double(begin + index) * inverse);
+            break;
+    }
+
+    // Exact end points
+    if (begin == 0) values[0] = m_start;
+
+    if (begin + count == m_size && m_size > 1) values[count - 1] = m_end;
+}
+
+std::vector<double> MeshView::ToVector() const {
+    /*
+     Materialize every point
+     output:
+        vector of Size() points
+     */
+
+    std::vector<double> values(m_size);
+
+    Fill(0, m_size, values.data());
+
+    return values;
+}
@@ -0,0 +1,91 @@
+//
+//  File: MeshView.hpp
+//  Project: ExactPricingModels
+//  Objective: Lazy parameter meshes generated from their index instead of stored
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef MeshView_hpp
+#define MeshView_hpp
+
+#include <stdio.h>
+#include <functional>
+#include <span>
+#include <vector>
+
+enum MeshSpacing{ LINEAR_MESH, LOG_MESH, CHEBYSHEV_MESH, EXPLICIT_MESH }; // How the points of a mesh are placed
+
+typedef std::function<void(size_t begin, const double* values, size_t count)> MeshBlockSink; // Receives results [begin, begin + count) of a mesh evaluation
+
+class MeshView {
+    /*
+     A mesh of `size` points between `start` and `end` (both included) that is never stored.
+     Point i is computed from i alone, so there is no drift and any block can be generated
+     independently:
+        LINEAR_MESH     start + (end - start) * i/(n-1)
+        LOG_MESH        start * (end/start)^(i/(n-1)), start and end positive
+        CHEBYSHEV_MESH  (start + end)/2 - (end - start)/2 * cos(pi * i/(n-1)), denser at both ends
+        EXPLICIT_MESH   values of a caller-owned array, which must outlive the view
+     The mesh pricing APIs pull points block by block into a buffer that stays in L1
+     */
+
+    // Attributes
+    enum MeshSpacing m_spacing = LINEAR_MESH; // Point placement
+    double m_start = 0; // First point
+    double m_end = 0; // Last point
+    size_t m_size = 0; // Number of points
+    double m_scale = 0; // end - start (LINEAR_MESH), log(end/start) (LOG_MESH), (end - start)/2 (CHEBYSHEV_MESH)
+    const double* m_values = nullptr; // Points of an EXPLICIT_MESH
+
+public:
+    /* CANONICAL HEADER START */
+    MeshView(){} // Default constructor, empty mesh
+
+    MeshView(enum MeshSpacing spacing, double start, double end, size_t size); // Parameter constructor. Throws std::invalid_argument on an impossible mesh
+
+    MeshView(std::span<const double> values); // View of existing values, not copied
+
+    virtual ~MeshView(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    static MeshView Linear(double start, double end, size_t size); // Evenly spaced points
+
+    static MeshView Logarithmic(double start, double end, size_t size); // Evenly spaced logarithms, for strikes and spots
+
+    static MeshView Chebyshev(double start, double end, size_t size); // Chebyshev-Lobatto points, for interpolating a price curve
+
+    /* GETTERS START */
+
+    enum MeshSpacing Spacing() const {
+        return m_spacing;
+    }
+
+    double Start() const {
+        return m_start;
+    }
+
+    double End() const {
+        return m_end;
+    }
+
+    size_t Size() const {
+        return m_size;
+    }
+
+    const double* Data() const {
+        // Stored points of an EXPLICIT_MESH, nullptr for a generated mesh
+        return m_values;
+    }
+
+    /* GETTERS END */
+
+    double operator [] (size_t index) const; // Point `index`
+
+    void Fill(size_t begin, size_t count, double* values) const; // Points [begin, begin + count) into a caller-provided array
+
+    std::vector<double> ToVector() const; // Materialize every point
+
+};
+
+#endif /* MeshView_hpp */
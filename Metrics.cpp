@@ -0,0 +1,426 @@
+//
+//  File: Metrics.cpp
+//  Project: ExactPricingModels
+//  Objective: Opt-in hot-path instrumentation: per-thread counters, latency histograms and their export
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "Metrics.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+struct MetricsRegistry {
+    std::mutex mutex; // Guards the lists, taken only when a thread starts or ends
+    std::vector<std::unique_ptr<ThreadMetrics>> all; // Every block ever handed out, never freed so snapshots stay lock-free
+    std::vector<ThreadMetrics*> released; // Blocks of finished threads, reused by new threads with their counts kept
+    Clock::time_point start = Clock::now(); // First registration
+};
+
+static MetricsRegistry& Registry() {
+    // Never destroyed: thread_local owners may release their block after static destructors ran
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+constinit thread_local int32_t metric_countdown[TIMER_COUNT] = {};
+
+static constinit thread_local int32_t metric_reload[TIMER_COUNT] = {}; // Value each countdown restarted from
+
+struct MetricsOwner {
+    /*
+     Thread-local handle returning its block to the registry when the thread ends
+     */
+    ThreadMetrics* metrics = nullptr;
+
+    ~MetricsOwner() {
+        if (!metrics) return;
+        // Calls counted down since the last sample
+        for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+            if (metric_reload[timer] > metric_countdown[timer]) MetricAdd(metrics->timers[timer].calls, metric_reload[timer] - metric_countdown[timer]);
+            metric_reload[timer] = metric_countdown[timer] = 0;
+        }
+        local_metrics = nullptr;
+        MetricsRegistry& registry = Registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.released.push_back(metrics);
+    }
+};
+
+constinit thread_local ThreadMetrics* local_metrics = nullptr;
+
+ThreadMetrics& RegisterLocalMetrics() {
+
+    static thread_local MetricsOwner owner;
+
+    if (owner.metrics) return *owner.metrics;
+
+    MetricsRegistry& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    if (!registry.released.empty()) {
+        owner.metrics = registry.released.back();
+        registry.released.pop_back();
+    } else {
+        registry.all.emplace_back(new ThreadMetrics());
+        owner.metrics = registry.all.back().get();
+    }
+
+    local_metrics = owner.metrics;
+
+    return *owner.metrics;
+}
+
+size_t MetricBucket(uint64_t ns) {
+    /*
+     Log-linear bucket: exact below METRIC_SUB_BUCKETS ns, then METRIC_SUB_BUCKETS buckets per power of two
+     */
+
+    if (ns < METRIC_SUB_BUCKETS) return ns;
+
+    unsigned exponent = 63 - __builtin_clzll(ns); // >= 4
+
+    size_t bucket = (exponent - 3) * METRIC_SUB_BUCKETS + ((ns >> (exponent - 4)) - METRIC_SUB_BUCKETS);
+
+    return bucket < METRIC_BUCKETS ? bucket : METRIC_BUCKETS - 1;
+}
+
+uint64_t MetricBucketLowerBound(size_t bucket) {
+
+    if (bucket < METRIC_SUB_BUCKETS) return bucket;
+
+    unsigned exponent = unsigned(bucket / METRIC_SUB_BUCKETS) + 3;
+
+    return uint64_t(bucket % METRIC_SUB_BUCKETS + METRIC_SUB_BUCKETS) << (exponent - 4);
+}
+
+uint64_t MetricStart() {
+    uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    return now ? now : 1;
+}
+
+void MetricRecord(ThreadMetrics::Timer& timer, uint64_t items, uint64_t start) {
+    /*
+     Out of line so that the scope inlined in every kernel stays a counter increment and a branch
+     */
+
+    uint64_t ns = MetricStart() - start;
+
+    MetricAdd(timer.timed_calls, 1);
+    MetricAdd(timer.timed_items, items);
+    MetricAdd(timer.timed_ns, ns);
+    MetricAdd(timer.buckets[MetricBucket(ns)], 1);
+}
+
+void MetricSampled(enum MetricTimer timer, uint64_t start) {
+    /*
+     Sampled single-item call. The countdown went from metric_reload to -1, so reload + 1 calls
+     including this one are credited at once
+     */
+
+    ThreadMetrics::Timer& metrics = LocalMetrics().timers[timer];
+
+    MetricAdd(metrics.calls, uint64_t(metric_reload[timer]) + 1);
+
+    uint64_t mask = metrics_sample_mask.load(std::memory_order_relaxed);
+    metric_reload[timer] = metric_countdown[timer] = int32_t(mask < INT32_MAX ? mask : INT32_MAX);
+
+    MetricRecord(metrics, 1, start);
+}
+
+std::atomic<uint64_t> metrics_sample_mask{1023};
+
+unsigned MetricsSamplePeriod() {
+    return unsigned(metrics_sample_mask.load(std::memory_order_relaxed) + 1);
+}
+
+void SetMetricsSamplePeriod(unsigned period) {
+    uint64_t rounded = 1;
+    while (rounded < period) rounded <<= 1;
+    metrics_sample_mask = rounded - 1;
+}
+
+bool MetricsEnabled() {
+#if defined(EXACT_PRICING_METRICS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* MetricTimerName(enum MetricTimer timer) {
+    const char* names[TIMER_COUNT] = {"price", "greeks", "mesh", "batch_price", "batch_greeks", "implied_vol", "monte_carlo", "lattice", "pde", "scenario"};
+    return timer < TIMER_COUNT ? names[timer] : "unknown";
+}
+
+const char* MetricCounterName(enum MetricCounter counter) {
+    const char* names[COUNTER_COUNT] = {"term_refresh", "result_cache_hit", "result_cache_miss"};
+    return counter < COUNTER_COUNT ? names[counter] : "unknown";
+}
+
+double TimerSnapshot::Percentile(double fraction) const {
+    /*
+     Upper edge of the bucket holding the requested rank, the HDR convention of never under-reporting
+     */
+
+    if (timed_calls == 0) return 0;
+
+    uint64_t rank = static_cast<uint64_t>(fraction * (timed_calls - 1)) + 1;
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < METRIC_BUCKETS; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            uint64_t upper = bucket + 1 < METRIC_BUCKETS ? MetricBucketLowerBound(bucket + 1) : MetricBucketLowerBound(bucket);
+            return upper * 1e-9;
+        }
+    }
+
+    return MetricBucketLowerBound(METRIC_BUCKETS - 1) * 1e-9;
+}
+
+double TimerSnapshot::MeanSeconds() const {
+    return timed_calls ? timed_ns * 1e-9 / timed_calls : 0;
+}
+
+double TimerSnapshot::ItemsPerSecond() const {
+    return timed_ns ? timed_items / (timed_ns * 1e-9) : 0;
+}
+
+MetricsSnapshot SnapshotMetrics() {
+    /*
+     Sum every thread's block. Blocks are never freed, so the list is copied under the registry
+     lock and the values are read without it; a snapshot taken while threads record may mix
+     counts from slightly different instants, each value itself is never torn
+     */
+
+    MetricsSnapshot snapshot;
+    std::vector<ThreadMetrics*> blocks;
+
+    MetricsRegistry& registry = Registry();
+
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const std::unique_ptr<ThreadMetrics>& block: registry.all) blocks.push_back(block.get());
+        snapshot.threads = registry.all.size();
+    }
+
+    snapshot.uptime = std::chrono::duration<double>(Clock::now() - registry.start).count();
+
+    for (ThreadMetrics* block: blocks) {
+
+        for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+
+            const ThreadMetrics::Timer& source = block->timers[timer];
+            TimerSnapshot& target = snapshot.timers[timer];
+
+            uint64_t calls = source.calls.load(std::memory_order_relaxed);
+
+            target.calls += calls;
+            target.items += calls + source.extra_items.load(std::memory_order_relaxed);
+            target.timed_calls += source.timed_calls.load(std::memory_order_relaxed);
+            target.timed_items += source.timed_items.load(std::memory_order_relaxed);
+            target.timed_ns += source.timed_ns.load(std::memory_order_relaxed);
+
+            for (size_t bucket = 0; bucket < METRIC_BUCKETS; bucket++) {
+                target.buckets[bucket] += source.buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+
+        for (size_t counter = 0; counter < COUNTER_COUNT; counter++) {
+            snapshot.counters[counter] += block->counters[counter].load(std::memory_order_relaxed);
+        }
+    }
+
+    return snapshot;
+}
+
+void MetricsSnapshot::Write(std::ostream& out, enum MetricsFormat format) const {
+    /*
+     Text: one row per operation then the counters. Prometheus: counters for calls and items,
+     a summary of the latency (quantiles from the histogram) and an items per second gauge
+     */
+
+    char line[256];
+
+    if (format == TEXT_METRICS) {
+
+        snprintf(line, sizeof(line), "metrics: %s, uptime %.1f s, %zu threads\n", MetricsEnabled() ? "enabled" : "disabled at compile time", uptime, threads);
+        out << line;
+
+        snprintf(line, sizeof(line), "%-14s %14s %16s %12s %10s %10s %10s %10s %14s\n",
+                 "operation", "calls", "items", "timed", "mean us", "p50 us", "p99 us", "p99.9 us", "items/s");
+        out << line;
+
+        for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+            const TimerSnapshot& t = timers[timer];
+            snprintf(line, sizeof(line), "%-14s %14llu %16llu %12llu %10.3f %10.3f %10.3f %10.3f %14.0f\n",
+                     MetricTimerName(static_cast<enum MetricTimer>(timer)),
+                     (unsigned long long)t.calls, (unsigned long long)t.items, (unsigned long long)t.timed_calls,
+                     t.MeanSeconds() * 1e6, t.Percentile(0.5) * 1e6, t.Percentile(0.99) * 1e6, t.Percentile(0.999) * 1e6, t.ItemsPerSecond());
+            out << line;
+        }
+
+        for (size_t counter = 0; counter < COUNTER_COUNT; counter++) {
+            snprintf(line, sizeof(line), "%-14s %14llu\n", MetricCounterName(static_cast<enum MetricCounter>(counter)), (unsigned long long)counters[counter]);
+            out << line;
+        }
+
+        return;
+    }
+
+    out << "# HELP exact_pricing_calls_total Calls of each instrumented operation\n"
+           "# TYPE exact_pricing_calls_total counter\n";
+    for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+        snprintf(line, sizeof(line), "exact_pricing_calls_total{operation=\"%s\"} %llu\n", MetricTimerName(static_cast<enum MetricTimer>(timer)), (unsigned long long)timers[timer].calls);
+        out << line;
+    }
+
+    out << "# HELP exact_pricing_items_total Contracts or mesh points processed by each operation\n"
+           "# TYPE exact_pricing_items_total counter\n";
+    for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+        snprintf(line, sizeof(line), "exact_pricing_items_total{operation=\"%s\"} %llu\n", MetricTimerName(static_cast<enum MetricTimer>(timer)), (unsigned long long)timers[timer].items);
+        out << line;
+    }
+
+    out << "# HELP exact_pricing_latency_seconds Latency of the sampled calls\n"
+           "# TYPE exact_pricing_latency_seconds summary\n";
+    for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+        const TimerSnapshot& t = timers[timer];
+        const char* name = MetricTimerName(static_cast<enum MetricTimer>(timer));
+        for (double quantile: {0.5, 0.9, 0.99, 0.999}) {
+            snprintf(line, sizeof(line), "exact_pricing_latency_seconds{operation=\"%s\",quantile=\"%g\"} %.9g\n", name, quantile, t.Percentile(quantile));
+            out << line;
+        }
+        snprintf(line, sizeof(line), "exact_pricing_latency_seconds_sum{operation=\"%s\"} %.9g\n", name, t.timed_ns * 1e-9);
+        out << line;
+        snprintf(line, sizeof(line), "exact_pricing_latency_seconds_count{operation=\"%s\"} %llu\n", name, (unsigned long long)t.timed_calls);
+        out << line;
+    }
+
+    out << "# HELP exact_pricing_items_per_second Items processed per second of busy time\n"
+           "# TYPE exact_pricing_items_per_second gauge\n";
+    for (size_t timer = 0; timer < TIMER_COUNT; timer++) {
+        snprintf(line, sizeof(line), "exact_pricing_items_per_second{operation=\"%s\"} %.9g\n", MetricTimerName(static_cast<enum MetricTimer>(timer)), timers[timer].ItemsPerSecond());
+        out << line;
+    }
+
+    out << "# HELP exact_pricing_events_total Instrumented events such as cache hits and misses\n"
+           "# TYPE exact_pricing_events_total counter\n";
+    for (size_t counter = 0; counter < COUNTER_COUNT; counter++) {
+        snprintf(line, sizeof(line), "exact_pricing_events_total{event=\"%s\"} %llu\n", MetricCounterName(static_cast<enum MetricCounter>(counter)), (unsigned long long)counters[counter]);
+        out << line;
+    }
+
+    snprintf(line, sizeof(line), "# HELP exact_pricing_uptime_seconds Seconds since metrics started\n"
+                                 "# TYPE exact_pricing_uptime_seconds gauge\nexact_pricing_uptime_seconds %.3f\n", uptime);
+    out << line;
+}
+
+void WriteMetrics(const std::string& path, enum MetricsFormat format) {
+    /*
+     Write a snapshot next to path and rename it over path. The rename is atomic, which is what the
+     Prometheus node exporter's textfile collector expects
+     */
+
+    std::string temporary = path + ".tmp";
+
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        if (!out) throw std::runtime_error("WriteMetrics: cannot open " + temporary);
+        SnapshotMetrics().Write(out, format);
+        if (!out) throw std::runtime_error("WriteMetrics: cannot write " + temporary);
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("WriteMetrics: cannot rename " + temporary + " to " + path);
+    }
+}
+
+struct SignalDump {
+    std::string path; // Destination
+    enum MetricsFormat format = TEXT_METRICS; // Encoding
+};
+
+const int METRIC_SIGNALS = 65; // Signal numbers handled, covers the real-time range on Linux
+
+static std::mutex dump_mutex; // Guards dumps and the writer thread start
+static SignalDump dumps[METRIC_SIGNALS]; // Destination per signal, empty path when not installed
+static int dump_pipe[2] = {-1, -1}; // The handler writes the signal number, the writer thread reads it
+
+static void DumpSignalHandler(int signal) {
+    // Only write(2), which is async-signal-safe; the snapshot is taken on the writer thread
+    int saved_errno = errno;
+    unsigned char byte = static_cast<unsigned char>(signal);
+    ssize_t written = write(dump_pipe[1], &byte, 1);
+    (void)written;
+    errno = saved_errno;
+}
+
+static void DumpWriter() {
+    /*
+     Writer thread: one dump per signal received
+     */
+
+    unsigned char signal;
+
+    while (read(dump_pipe[0], &signal, 1) == 1) {
+
+        SignalDump dump;
+
+        {
+            std::lock_guard<std::mutex> lock(dump_mutex);
+            if (signal < METRIC_SIGNALS) dump = dumps[signal];
+        }
+
+        if (dump.path.empty()) continue;
+
+        try {
+            WriteMetrics(dump.path, dump.format);
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+        }
+    }
+}
+
+void DumpMetricsOnSignal(int signal, const std::string& path, enum MetricsFormat format) {
+    /*
+     Install a handler for signal. The handler only wakes a detached writer thread, started on first use,
+     which takes the snapshot and writes the file with WriteMetrics
+     input:
+        signal number (e.g. SIGUSR1), destination file, format
+     */
+
+    if (signal <= 0 || signal >= METRIC_SIGNALS) throw std::invalid_argument("DumpMetricsOnSignal: unsupported signal");
+
+    std::lock_guard<std::mutex> lock(dump_mutex);
+
+    if (dump_pipe[0] < 0) {
+        if (pipe(dump_pipe) != 0) throw std::runtime_error("DumpMetricsOnSignal: cannot create pipe");
+        std::thread(DumpWriter).detach();
+    }
+
+    dumps[signal].path = path;
+    dumps[signal].format = format;
+
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = DumpSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+
+    sigaction(signal, &action, nullptr);
+}
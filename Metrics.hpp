@@ -0,0 +1,188 @@
+//
+//  File: Metrics.hpp
+//  Project: ExactPricingModels
+//  Objective: Opt-in hot-path instrumentation: per-thread counters, latency histograms and their export
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef Metrics_hpp
+#define Metrics_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+// Instrumentation is compiled in with -DEXACT_PRICING_METRICS. Without it METRIC_SCOPE and
+// METRIC_COUNT expand to nothing, and the export functions below report an empty snapshot
+
+enum MetricTimer{ TIMER_PRICE, TIMER_GREEKS, TIMER_MESH, TIMER_BATCH_PRICE, TIMER_BATCH_GREEKS, TIMER_IMPLIED_VOL, TIMER_MONTE_CARLO, TIMER_LATTICE, TIMER_PDE, TIMER_SCENARIO, TIMER_COUNT }; // Instrumented operations
+
+enum MetricCounter{ COUNTER_TERM_REFRESH, COUNTER_RESULT_CACHE_HIT, COUNTER_RESULT_CACHE_MISS, COUNTER_COUNT }; // Instrumented events
+
+enum MetricsFormat{ TEXT_METRICS, PROMETHEUS_METRICS }; // Export format
+
+const unsigned METRIC_SUB_BUCKETS = 16; // Histogram buckets per power of two, so a bucket is at most 1/16 of its value wide
+
+const size_t METRIC_BUCKETS = 41 * METRIC_SUB_BUCKETS; // Covers 0 ns to 2^44 ns (about 4.9 hours); longer calls land in the last bucket
+
+struct ThreadMetrics {
+    /*
+     Metrics of one thread. Only the owning thread writes, with relaxed load/store pairs rather than
+     atomic read-modify-writes, so recording costs no locked instruction; snapshots read with relaxed loads
+     */
+    struct Timer {
+        std::atomic<uint64_t> calls{0}; // Every call
+        std::atomic<uint64_t> extra_items{0}; // Items beyond one per call, so single-item calls only touch calls
+        std::atomic<uint64_t> timed_calls{0}; // Calls timed, see SetMetricsSamplePeriod
+        std::atomic<uint64_t> timed_items{0}; // Items of the timed calls
+        std::atomic<uint64_t> timed_ns{0}; // Duration of the timed calls
+        std::atomic<uint64_t> buckets[METRIC_BUCKETS] = {}; // Latency histogram of the timed calls
+    };
+
+    Timer timers[TIMER_COUNT];
+    std::atomic<uint64_t> counters[COUNTER_COUNT] = {};
+};
+
+inline void MetricAdd(std::atomic<uint64_t>& value, uint64_t amount) {
+    // Single-writer increment
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+size_t MetricBucket(uint64_t ns); // Histogram bucket of a duration
+
+uint64_t MetricBucketLowerBound(size_t bucket); // Smallest duration in a bucket
+
+extern constinit thread_local ThreadMetrics* local_metrics; // Block of the calling thread, nullptr before its first metric. constinit lets other files read it without a TLS init call
+
+ThreadMetrics& RegisterLocalMetrics(); // Give the calling thread a block
+
+inline ThreadMetrics& LocalMetrics() {
+    // Metrics of the calling thread, registered on first use
+    ThreadMetrics* metrics = local_metrics;
+    return metrics ? *metrics : RegisterLocalMetrics();
+}
+
+extern std::atomic<uint64_t> metrics_sample_mask; // Sample period - 1, see SetMetricsSamplePeriod
+
+unsigned MetricsSamplePeriod(); // Calls of an operation per timed call, on each thread
+
+void SetMetricsSamplePeriod(unsigned period); // Rounded up to a power of two, 1024 by default; 1 times every call. Calls with at least METRIC_ALWAYS_TIMED items are always timed
+
+const size_t METRIC_ALWAYS_TIMED = 64; // Items above which a call is long enough to time every time
+
+uint64_t MetricStart(); // Clock reading of a timed call, in ns, never 0
+
+void MetricRecord(ThreadMetrics::Timer& timer, uint64_t items, uint64_t start); // Record a timed call started at start
+
+class MetricScope {
+    /*
+     Counts one call of an operation and, for one call in MetricsSamplePeriod() or any call of at least
+     METRIC_ALWAYS_TIMED items, times it. Two clock reads cost about as much as a scalar price, so
+     sampling keeps the enabled overhead of the scalar paths small. The clock and histogram work is out
+     of line, leaving the scalar kernels small enough to stay inlined. Latency and items per second
+     come from the timed calls; call and item totals are exact
+     */
+
+    ThreadMetrics::Timer& m_timer; // Metrics of the operation on this thread
+    uint64_t m_items; // Items of this call
+    uint64_t m_start; // Start of a timed call, 0 when untimed
+
+public:
+    /* CANONICAL HEADER START */
+    MetricScope(enum MetricTimer timer, uint64_t items = 1) : m_timer(LocalMetrics().timers[timer]), m_items(items), m_start(0) {
+        // Parameter constructor. An untimed single-item call costs one increment and one branch
+        uint64_t calls = m_timer.calls.load(std::memory_order_relaxed);
+        m_timer.calls.store(calls + 1, std::memory_order_relaxed);
+        if (items != 1) MetricAdd(m_timer.extra_items, items - 1);
+        if (items >= METRIC_ALWAYS_TIMED || (calls & metrics_sample_mask.load(std::memory_order_relaxed)) == 0) m_start = MetricStart();
+    }
+
+    MetricScope(const MetricScope& other_scope) = delete; // Not copyable
+
+    ~MetricScope() {
+        // Destructor. Records the duration of a timed call
+        if (m_start) MetricRecord(m_timer, m_items, m_start);
+    }
+
+    MetricScope& operator = (const MetricScope& other_scope) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+};
+
+extern constinit thread_local int32_t metric_countdown[TIMER_COUNT]; // Single-item calls each operation may still make on this thread before its next sampled one
+
+inline bool MetricTick(enum MetricTimer timer) {
+    // One single-item call, true for the one call in MetricsSamplePeriod() to time. Calls are
+    // credited to the thread's metrics in batches, by MetricSampled
+    return --metric_countdown[timer] < 0;
+}
+
+void MetricSampled(enum MetricTimer timer, uint64_t start); // Credit the calls counted down since the last sampled call, record this one and restart the countdown
+
+template <typename Body>
+__attribute__((noinline)) auto MetricTimed(enum MetricTimer timer, Body body) {
+    // Run and time a sampled call. Out of line, so unsampled calls keep nothing alive across the kernel
+    uint64_t start = MetricStart();
+    auto result = body();
+    MetricSampled(timer, start);
+    return result;
+}
+
+#if defined(EXACT_PRICING_METRICS)
+#define METRIC_SCOPE(timer, items) MetricScope metric_scope_(timer, items)
+#define METRIC_COUNT(counter) MetricAdd(LocalMetrics().counters[counter], 1)
+// Returns the expression, counting the call under timer. For the cheap scalar paths: an unsampled
+// call costs one thread-local decrement and one branch, with no scope object around the kernel.
+// Totals of these calls lag by at most MetricsSamplePeriod() - 1 per thread until its next sample
+// The expression is spelled twice so its closure is only built on the sampled branch
+#define METRIC_RETURN(timer, ...) \
+    if (MetricTick(timer)) [[unlikely]] return MetricTimed(timer, [&]() { return __VA_ARGS__; }); \
+    return __VA_ARGS__
+#else
+#define METRIC_SCOPE(timer, items) do {} while (0)
+#define METRIC_COUNT(counter) do {} while (0)
+#define METRIC_RETURN(timer, ...) return __VA_ARGS__
+#endif
+
+struct TimerSnapshot {
+    uint64_t calls = 0;
+    uint64_t items = 0;
+    uint64_t timed_calls = 0;
+    uint64_t timed_items = 0;
+    uint64_t timed_ns = 0;
+    uint64_t buckets[METRIC_BUCKETS] = {};
+
+    double Percentile(double fraction) const; // Latency in seconds below which `fraction` of the timed calls fall, at bucket resolution
+
+    double MeanSeconds() const; // Mean latency of the timed calls
+
+    double ItemsPerSecond() const; // Contracts (or mesh points) per second of busy time
+};
+
+struct MetricsSnapshot {
+    /*
+     Sum of every thread's metrics since the process started
+     */
+    double uptime = 0; // Seconds since the first thread registered
+    size_t threads = 0; // Threads that recorded metrics
+    TimerSnapshot timers[TIMER_COUNT];
+    uint64_t counters[COUNTER_COUNT] = {};
+
+    void Write(std::ostream& out, enum MetricsFormat format) const; // Text table or Prometheus exposition format
+};
+
+bool MetricsEnabled(); // Instrumentation compiled in
+
+const char* MetricTimerName(enum MetricTimer timer); // price, greeks, mesh, ...
+
+const char* MetricCounterName(enum MetricCounter counter); // term_refresh, ...
+
+MetricsSnapshot SnapshotMetrics(); // Lock-free read of every thread's metrics
+
+void WriteMetrics(const std::string& path, enum MetricsFormat format); // Write a snapshot to path.tmp then rename it, so scrapers never read a partial file. Throws std::runtime_error
+
+void DumpMetricsOnSignal(int signal, const std::string& path, enum MetricsFormat format); // Write a snapshot to path whenever the process receives signal (e.g. SIGUSR1)
+
+#endif /* Metrics_hpp */
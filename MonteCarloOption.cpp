@@ -0,0 +1,502 @@
+//
+//  File: MonteCarloOption.cpp
+//  Project: ExactPricingModels
+//  Objective: Monte Carlo option, inherits Option. Cross-check of the closed forms and path-dependent payoffs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "MonteCarloOption.hpp"
+#include "BatchPricer.hpp"
+#include "EuropeanOption.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "Philox.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+const double MONTE_CARLO_GAMMA_STEP = 1e-2; // Relative spot step of Gamma()
+
+struct MonteCarloSums {
+    /*
+     Sums over the samples of one block. Payoffs y and controls x are stored net of the control's
+     expectation, which keeps the sums of squares small and the variances accurate
+     */
+    size_t samples = 0;
+    double y = 0, yy = 0, x = 0, xx = 0, xy = 0; // Price and its control
+    double d = 0, dd = 0, c = 0, cc = 0, dc = 0; // Delta and its control
+
+    void Add(const MonteCarloSums& other) {
+        samples += other.samples;
+        y += other.y; yy += other.yy; x += other.x; xx += other.xx; xy += other.xy;
+        d += other.d; dd += other.dd; c += other.c; cc += other.cc; dc += other.dc;
+    }
+};
+
+struct MonteCarloModel {
+    /*
+     Per-simulation constants shared by every block
+     */
+    double S, K, omega; // Spot, strike, +1 for calls and -1 for puts
+    double drift, vol; // Log-return per step, mean and standard deviation
+    double discount; // e^(-rT)
+    size_t steps, draws; // Monitoring dates, normal draws per date
+    uint64_t seed;
+    enum MonteCarloPayoff payoff;
+    bool antithetic;
+};
+
+static void Estimate(size_t samples, double sum, double sum_sq, double control, double control_sq, double cross,
+                     bool use_control, double& mean, double& error, double& beta) {
+    /*
+     Mean and standard error of a sample, adjusted by a control of zero expectation
+     input:
+        sample count and sums of the sample, the control, their squares and their product
+        use the control
+     output:
+        mean, standard error, control coefficient
+     */
+
+    double n = static_cast<double>(samples);
+
+    mean = sum / n;
+    beta = 0;
+
+    if (samples < 2) {
+        error = 0;
+        return;
+    }
+
+    double variance = (sum_sq - sum * sum / n) / (n - 1);
+
+    if (use_control) {
+        double control_variance = (control_sq - control * control / n) / (n - 1);
+        double covariance = (cross - sum * control / n) / (n - 1);
+        if (control_variance > 0) {
+            beta = covariance / control_variance;
+            mean -= beta * control / n;
+            variance -= beta * covariance;
+        }
+    }
+
+    error = std::sqrt(std::max(variance, 0.0) / n);
+}
+
+static void SimulateBlock(const MonteCarloModel& model, double control_price, double control_delta,
+                          size_t first, size_t count, MonteCarloSums& sums) {
+    /*
+     Simulate draws [first, first + count), and their mirror paths when antithetic, and add up
+     their samples. Every step runs over the whole block: uniforms, normals, log-returns, then the
+     running average, each loop vectorized or on the SIMD math kernels
+     input:
+        model
+        expectations of the price and delta controls
+        first draw and number of draws, at most MONTE_CARLO_BLOCK
+     output:
+        sums of the block
+     */
+
+    alignas(COLUMN_ALIGNMENT) double uniforms[MONTE_CARLO_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double normals[MONTE_CARLO_BLOCK];
+    alignas(COLUMN_ALIGNMENT) double log_return[2 * MONTE_CARLO_BLOCK]; // log(S(t) / S), mirror paths after the first count
+    alignas(COLUMN_ALIGNMENT) double level[2 * MONTE_CARLO_BLOCK]; // S(t) / S
+    alignas(COLUMN_ALIGNMENT) double average[2 * MONTE_CARLO_BLOCK]; // Running sum of S(t) / S, or of log(S(t) / S)
+
+    size_t lanes = model.antithetic ? 2 * count : count;
+
+    std::fill(log_return, log_return + lanes, 0.0);
+    std::fill(average, average + lanes, 0.0);
+
+    for (size_t step = 0; step < model.steps; step++) {
+
+        PhiloxUniforms(model.seed, 0, static_cast<uint32_t>(step), first, count, uniforms);
+        NormalQuantile(uniforms, normals, count);
+
+        for (size_t lane = 0; lane < count; lane++) log_return[lane] += model.drift + model.vol * normals[lane];
+
+        if (model.antithetic) {
+            for (size_t lane = 0; lane < count; lane++) log_return[count + lane] += model.drift - model.vol * normals[lane];
+        }
+
+        if (model.payoff == ARITHMETIC_ASIAN_PAYOFF) {
+            Exp(log_return, level, lanes);
+            for (size_t lane = 0; lane < lanes; lane++) average[lane] += level[lane];
+        } else if (model.payoff == GEOMETRIC_ASIAN_PAYOFF) {
+            for (size_t lane = 0; lane < lanes; lane++) average[lane] += log_return[lane];
+        }
+    }
+
+    if (model.payoff != ARITHMETIC_ASIAN_PAYOFF) Exp(log_return, level, lanes); // S(T) / S, already there after the last average step
+
+    double* ratio = level; // A / S, the payoff's underlying relative to spot
+
+    if (model.payoff == ARITHMETIC_ASIAN_PAYOFF) {
+        for (size_t lane = 0; lane < lanes; lane++) average[lane] /= static_cast<double>(model.steps);
+        ratio = average;
+    } else if (model.payoff == GEOMETRIC_ASIAN_PAYOFF) {
+        for (size_t lane = 0; lane < lanes; lane++) average[lane] /= static_cast<double>(model.steps);
+        Exp(average, average, lanes);
+        ratio = average;
+    }
+
+    double S = model.S, K = model.K, omega = model.omega, discount = model.discount;
+    bool european = model.payoff == EUROPEAN_PAYOFF;
+
+    // One sample per draw: a path, or the mean of a path and its mirror
+    size_t paths_per_sample = model.antithetic ? 2 : 1;
+
+    for (size_t sample = 0; sample < count; sample++) {
+
+        double y = 0, x = 0, d = 0, c = 0;
+
+        for (size_t path = 0; path < paths_per_sample; path++) {
+            size_t lane = sample + path * count;
+            bool in_the_money = omega * (S * ratio[lane] - K) > 0;
+            y += in_the_money ? omega * (S * ratio[lane] - K) : 0;
+            d += in_the_money ? omega * ratio[lane] : 0;
+            if (european) {
+                x += S * level[lane];
+                c += level[lane];
+            } else {
+                bool terminal_in_the_money = omega * (S * level[lane] - K) > 0;
+                x += terminal_in_the_money ? omega * (S * level[lane] - K) : 0;
+                c += terminal_in_the_money ? omega * level[lane] : 0;
+            }
+        }
+
+        double scale = discount / paths_per_sample;
+        y = y * scale - control_price;
+        x = x * scale - control_price;
+        d = d * scale - control_delta;
+        c = c * scale - control_delta;
+
+        sums.y += y; sums.yy += y * y; sums.x += x; sums.xx += x * x; sums.xy += x * y;
+        sums.d += d; sums.dd += d * d; sums.c += c; sums.cc += c * c; sums.dc += d * c;
+    }
+
+    sums.samples += count;
+}
+
+MonteCarloOption::MonteCarloOption(const MonteCarloOption& other_option) :
+Option(other_option),
+m_settings(other_option.m_settings),
+m_pool(other_option.m_pool) {
+    /*
+     Copy constructor
+     */
+}
+
+MonteCarloOption::MonteCarloOption(double underlying_price,
+                                   double strike_price,
+                                   double time_to_maturity,
+                                   double riskfree_rate,
+                                   double constant_volatility,
+                                   enum CallOrPut call_or_put,
+                                   enum UnderlyingType underlying_type,
+                                   double dividend_yield,
+                                   double foreign_rate,
+                                   const MonteCarloSettings& settings) :
+Option(underlying_price,
+       strike_price,
+       time_to_maturity,
+       riskfree_rate,
+       constant_volatility,
+       call_or_put,
+       underlying_type,
+       dividend_yield,
+       foreign_rate),
+m_settings(settings) {
+    /*
+     Parameter constructor
+     */
+}
+
+MonteCarloOption& MonteCarloOption::operator = (const MonteCarloOption& other_option){
+    /*
+     Assignment operator overload
+     */
+
+    if(this == &other_option){
+        return *this;
+    }
+
+    Option::operator=(other_option);
+
+    m_settings = other_option.m_settings;
+    m_pool = other_option.m_pool;
+
+    return *this;
+}
+
+MonteCarloResult MonteCarloOption::Simulate() const {
+    /*
+     Simulate Settings().paths paths
+     output:
+        price and pathwise delta with their standard errors
+     */
+
+    if (m_settings.paths == 0 || m_settings.steps == 0) {
+        throw std::invalid_argument("MonteCarloOption::Simulate: paths and steps must be positive");
+    }
+
+    METRIC_SCOPE(TIMER_MONTE_CARLO, m_settings.paths);
+
+    MonteCarloModel model;
+    model.S = S();
+    model.K = K();
+    model.omega = CallOrPut() == CALL ? 1 : -1;
+    model.drift = (b() - 0.5 * s() * s()) * T() / m_settings.steps;
+    model.vol = s() * std::sqrt(T() / m_settings.steps);
+    model.discount = std::exp(-r() * T());
+    model.steps = m_settings.steps;
+    model.draws = m_settings.antithetic ? (m_settings.paths + 1) / 2 : m_settings.paths;
+    model.seed = m_settings.seed;
+    model.payoff = m_settings.payoff;
+    model.antithetic = m_settings.antithetic;
+
+    // Exact expectations of the controls
+    double control_price, control_delta;
+
+    if (m_settings.payoff == EUROPEAN_PAYOFF) {
+        control_delta = std::exp((b() - r()) * T());
+        control_price = S() * control_delta;
+    } else {
+        EuropeanOption european(S(), K(), T(), r(), s(), CallOrPut(), UnderlyingType(), q(), R());
+        european.b(b());
+        control_price = european.Price();
+        control_delta = european.Delta();
+    }
+
+    size_t blocks = (model.draws + MONTE_CARLO_BLOCK - 1) / MONTE_CARLO_BLOCK;
+
+    vector<MonteCarloSums> block_sums(blocks);
+
+    auto body = [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; block++) {
+            size_t first = block * MONTE_CARLO_BLOCK;
+            size_t count = std::min(MONTE_CARLO_BLOCK, model.draws - first);
+            SimulateBlock(model, control_price, control_delta, first, count, block_sums[block]);
+        }
+    };
+
+    Pool().ParallelFor(0, blocks, 1, std::cref(body));
+
+    // Block order, so the result does not depend on which thread ran which block
+    MonteCarloSums sums;
+    for (const MonteCarloSums& block: block_sums) sums.Add(block);
+
+    MonteCarloResult result;
+    double delta_beta;
+
+    Estimate(sums.samples, sums.y, sums.yy, sums.x, sums.xx, sums.xy, m_settings.control_variate,
+             result.price, result.standard_error, result.beta);
+    Estimate(sums.samples, sums.d, sums.dd, sums.c, sums.cc, sums.dc, m_settings.control_variate,
+             result.delta, result.delta_standard_error, delta_beta);
+
+    result.price += control_price;
+    result.delta += control_delta;
+    result.paths = m_settings.antithetic ? 2 * model.draws : model.draws;
+
+    return result;
+}
+
+double MonteCarloOption::Price() const {
+    /*
+     Price the option by simulation
+     */
+
+    return Simulate().price;
+}
+
+vector<double> MonteCarloOption::Price(double price) const {
+    /*
+     Price the option using put-call parity
+     input:
+        option price
+     output:
+        vector with option price and parity difference
+     */
+
+    ParityResult parity = Parity(price);
+
+    return {parity.price, parity.difference};
+}
+
+ParityResult MonteCarloOption::Parity(double price) const {
+    /*
+     Put-call parity on the payoff's underlying: C - P = e^(-rT) (Forward() - K), which holds for
+     the averages as well as for S(T)
+     input:
+        option price
+     output:
+        price of the opposite option type and parity difference
+     */
+
+    double discount = std::exp(-r() * T());
+    double temp = K() * discount;
+    double forward = Forward() * discount;
+
+    ParityResult parity;
+
+    parity.price = CallOrPut() == CALL ? ( price + temp - forward ) :
+    ( price + forward - temp );
+
+    parity.difference = CallOrPut() == CALL ? ( price + temp - (parity.price + forward) ) :
+    ( parity.price + temp - (price + forward) ) ;
+
+    return parity;
+}
+
+vector<double> MonteCarloOption::Price(const vector<double>& parameter_mesh, enum Parameter parameter) const {
+    /*
+     Price the option using an array of parameters
+     input:
+        parameter mesh
+        parameter type
+     output:
+        vector with prices
+     */
+
+    vector<double> prices(parameter_mesh.size());
+
+    Price(parameter_mesh, parameter, prices);
+
+    return prices;
+}
+
+void MonteCarloOption::Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const {
+    /*
+     Price the option using an array of parameters into a caller-provided array. Every point
+     reuses the seed, so the prices move smoothly along the mesh (common random numbers)
+     input:
+        parameter mesh
+        parameter type
+        prices, same size as the mesh
+     */
+
+    if (prices.size() != parameter_mesh.size()) {
+        throw std::invalid_argument("MonteCarloOption::Price: output size differs from mesh size");
+    }
+
+    for (size_t index = 0; index < parameter_mesh.size(); index++) {
+        prices[index] = WithParameter(parameter, parameter_mesh[index]).Price();
+    }
+}
+
+double MonteCarloOption::Delta() const {
+    /*
+     Pathwise delta
+     */
+
+    return Simulate().delta;
+}
+
+double MonteCarloOption::Gamma() const {
+    /*
+     Central difference of the pathwise deltas at S(1 +/- MONTE_CARLO_GAMMA_STEP), both on the same paths
+     */
+
+    double h = MONTE_CARLO_GAMMA_STEP * S();
+
+    return (WithParameter(UNDERLYING, S() + h).Delta() - WithParameter(UNDERLYING, S() - h).Delta()) / (2 * h);
+}
+
+vector<double> MonteCarloOption::Delta(const vector<double>& price_mesh) const {
+    /*
+     Compute delta using array of underlying prices
+     */
+
+    vector<double> deltas(price_mesh.size());
+
+    Delta(price_mesh, deltas);
+
+    return deltas;
+}
+
+vector<double> MonteCarloOption::Gamma(const vector<double>& price_mesh) const {
+    /*
+     Compute gamma using array of underlying prices
+     */
+
+    vector<double> gammas(price_mesh.size());
+
+    Gamma(price_mesh, gammas);
+
+    return gammas;
+}
+
+void MonteCarloOption::Delta(span<const double> price_mesh, span<double> deltas) const {
+    /*
+     Compute delta using array of underlying prices into a caller-provided array
+     */
+
+    if (deltas.size() != price_mesh.size()) {
+        throw std::invalid_argument("MonteCarloOption::Delta: output size differs from mesh size");
+    }
+
+    for (size_t index = 0; index < price_mesh.size(); index++) {
+        deltas[index] = WithParameter(UNDERLYING, price_mesh[index]).Delta();
+    }
+}
+
+void MonteCarloOption::Gamma(span<const double> price_mesh, span<double> gammas) const {
+    /*
+     Compute gamma using array of underlying prices into a caller-provided array
+     */
+
+    if (gammas.size() != price_mesh.size()) {
+        throw std::invalid_argument("MonteCarloOption::Gamma: output size differs from mesh size");
+    }
+
+    for (size_t index = 0; index < price_mesh.size(); index++) {
+        gammas[index] = WithParameter(UNDERLYING, price_mesh[index]).Gamma();
+    }
+}
+
+double MonteCarloOption::Forward() const {
+    /*
+     Expectation of S(T), of the arithmetic average S/n sum e^(b t_i), or of the geometric
+     average, lognormal with mean (b - s^2/2) T (n + 1) / 2n and variance s^2 T (n + 1)(2n + 1) / 6n^2
+     */
+
+    double n = static_cast<double>(m_settings.steps);
+
+    switch (m_settings.payoff) {
+        case ARITHMETIC_ASIAN_PAYOFF: {
+            double sum = 0;
+            for (size_t step = 1; step <= m_settings.steps; step++) sum += std::exp(b() * T() * step / n);
+            return S() * sum / n;
+        }
+        case GEOMETRIC_ASIAN_PAYOFF: {
+            double mean = (b() - 0.5 * s() * s()) * T() * (n + 1) / (2 * n);
+            double variance = s() * s() * T() * (n + 1) * (2 * n + 1) / (6 * n * n);
+            return S() * std::exp(mean + 0.5 * variance);
+        }
+        default:
+            return S() * std::exp(b() * T());
+    }
+}
+
+MonteCarloOption MonteCarloOption::WithParameter(enum Parameter parameter, double value) const {
+    /*
+     Copy of the option with one parameter replaced. A RATE point keeps the carry cost, like the
+     EuropeanOption meshes
+     */
+
+    MonteCarloOption option(*this);
+
+    switch (parameter) {
+        case UNDERLYING: option.S(value); break;
+        case STRIKE: option.K(value); break;
+        case TIME: option.T(value); break;
+        case RATE: option.r(value); break;
+        case SIGMA: option.s(value); break;
+        case CARRY: option.b(value); break;
+        default: break;
+    }
+
+    return option;
+}
@@ -0,0 +1,136 @@
+//
+//  File: MonteCarloOption.hpp
+//  Project: ExactPricingModels
+//  Objective: Monte Carlo option, inherits Option. Cross-check of the closed forms and path-dependent payoffs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef MonteCarloOption_hpp
+#define MonteCarloOption_hpp
+
+#include <stdio.h>
+#include <cstdint>
+#include "Option.hpp"
+#include "ThreadPool.hpp"
+
+enum MonteCarloPayoff{ EUROPEAN_PAYOFF, ARITHMETIC_ASIAN_PAYOFF, GEOMETRIC_ASIAN_PAYOFF }; // Payoff on S(T), or on the arithmetic or geometric average of S over the monitoring dates
+
+const size_t MONTE_CARLO_BLOCK = 1024; // Paths simulated together by one task. Also the unit of the per-block sums
+
+struct MonteCarloSettings {
+    size_t paths = 1 << 20; // Simulated paths, an antithetic pair counting as two
+    size_t steps = 1; // Monitoring dates T/steps, 2T/steps, ..., T
+    uint64_t seed = 0; // Philox key. The same seed gives the same result on any number of threads
+    enum MonteCarloPayoff payoff = EUROPEAN_PAYOFF;
+    bool antithetic = true; // Pair every path with its mirror image -Z
+    bool control_variate = true; // Regress on a control with a known expectation, see MonteCarloOption
+};
+
+struct MonteCarloResult {
+    double price = 0; // Estimated price
+    double standard_error = 0; // Standard error of price
+    double delta = 0; // Pathwise delta
+    double delta_standard_error = 0; // Standard error of delta
+    double beta = 0; // Control variate coefficient of the price, 0 without control
+    size_t paths = 0; // Simulated paths
+};
+
+class MonteCarloOption : public Option {
+    /*
+     Prices an option by simulating S under the same lognormal model as EuropeanOption, with
+     drift b - s^2/2, on Philox streams (key = seed, counter = path pair and step) turned into
+     normals by the vectorized inverse normal cdf. Paths run in blocks of MONTE_CARLO_BLOCK on the
+     thread pool, and the per-block sums are added in block order, so results are bit-for-bit
+     reproducible whatever the thread count.
+
+     The control variate is the discounted European payoff on S(T), whose exact value is
+     EuropeanOption::Price(), for the Asian payoffs; the European payoff is its own exact price,
+     so it is controlled by the discounted S(T) instead, whose value is S e^((b - r)T). The
+     coefficient is estimated from the same paths. Delta is the pathwise derivative
+     payoff'(A) A / S, controlled the same way with EuropeanOption::Delta() and e^((b - r)T)
+     */
+
+    // Attributes
+    MonteCarloSettings m_settings; // Simulation settings
+    ThreadPool* m_pool = nullptr; // Pool running the path blocks, nullptr for the shared pool
+
+public:
+    /* CANONICAL HEADER START */
+    MonteCarloOption(){} // Default constructor
+
+    MonteCarloOption(const MonteCarloOption& other_option); // Copy constructor
+
+    MonteCarloOption(double underlying_price,
+                     double strike_price,
+                     double time_to_maturity,
+                     double riskfree_rate,
+                     double constant_volatility,
+                     enum CallOrPut call_or_put,
+                     enum UnderlyingType underlying_type,
+                     double dividend_yield = 0,
+                     double foreign_rate = 0,
+                     const MonteCarloSettings& settings = MonteCarloSettings()); // Parameter constructor
+
+    virtual ~MonteCarloOption(){} // Destructor
+
+    MonteCarloOption& operator = (const MonteCarloOption& other_option); // Assignment operator overload
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    const MonteCarloSettings& Settings() const {
+        return m_settings;
+    }
+
+    ThreadPool& Pool() const {
+        return m_pool ? *m_pool : ThreadPool::Instance();
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Settings(const MonteCarloSettings& settings) {
+        this->m_settings = settings;
+    }
+
+    void Pool(ThreadPool* pool) {
+        this->m_pool = pool;
+    }
+
+    /* SETTERS END */
+
+    MonteCarloResult Simulate() const; // Price and delta with their standard errors
+
+    double Price() const; // Price the option, Simulate().price
+
+    vector<double> Price(double price) const; // Price the option using put-call parity
+
+    ParityResult Parity(double price) const; // Price the option using put-call parity, without allocating
+
+    vector<double> Price(const vector<double>& parameter_mesh, enum Parameter parameter) const; // Price the option using an array of parameters
+
+    void Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const; // Price the option using an array of parameters into a caller-provided array. Every point uses the same paths
+
+    double Delta() const; // Compute delta, Simulate().delta
+
+    double Gamma() const; // Compute gamma, central difference of pathwise deltas on the same paths
+
+    vector<double> Delta(const vector<double>& price_mesh) const; // Compute delta using array of underlying prices
+
+    vector<double> Gamma(const vector<double>& price_mesh) const; // Compute gamma using array of underlying prices
+
+    void Delta(span<const double> price_mesh, span<double> deltas) const; // Compute delta using array of underlying prices into a caller-provided array
+
+    void Gamma(span<const double> price_mesh, span<double> gammas) const; // Compute gamma using array of underlying prices into a caller-provided array
+
+    double Forward() const; // Expected value of the payoff's underlying (S(T) or the average) under the pricing measure
+
+    // Helper functions
+private:
+    MonteCarloOption WithParameter(enum Parameter parameter, double value) const; // Copy with one parameter replaced, as in the EuropeanOption meshes
+
+};
+
+#endif /* MonteCarloOption_hpp */
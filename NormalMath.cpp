@@ -0,0 +1,375 @@
+//
+//  File: NormalMath.cpp
+//  Project: ExactPricingModels
+//  Objective: Normal distribution, exp and log kernels used by the pricers
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "NormalMath.hpp"
+#include "NormalMathKernels.hpp"
+#include "cmath"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <boost/math/distributions/normal.hpp>
+
+namespace {
+
+struct Scalar {
+    /*
+     One lane adapter. Portable fallback and scalar entry points
+     */
+    typedef double Real;
+    typedef double V;
+    typedef bool M;
+    static const size_t WIDTH = 1;
+
+    static V Set(double x) { return x; }
+    static V Load(const double* x) { return *x; }
+    static void Store(double* out, V x) { *out = x; }
+
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Fma(V a, V b, V c) { return a * b + c; }
+    static V Min(V a, V b) { return a < b ? a : b; }
+    static V Max(V a, V b) { return a > b ? a : b; }
+    static V Abs(V x) { return std::fabs(x); }
+    static V Sqrt(V x) { return std::sqrt(x); }
+    static V Round(V x) { return std::nearbyint(x); }
+
+    static M Less(V a, V b) { return a < b; }
+    static M Greater(V a, V b) { return a > b; }
+    static M IsNan(V x) { return x != x; }
+    static V Select(M m, V a, V b) { return m ? a : b; }
+
+    static V Pow2(V k) {
+        uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(k) + 1023) << 52;
+        double result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    static V Split(V x, V& mantissa) {
+        uint64_t bits;
+        memcpy(&bits, &x, sizeof(bits));
+        uint64_t mantissa_bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+        memcpy(&mantissa, &mantissa_bits, sizeof(mantissa));
+        return static_cast<double>(static_cast<int64_t>((bits >> 52) & 0x7FF) - 1023);
+    }
+};
+
+struct ScalarFloat {
+    /*
+     One lane single precision adapter
+     */
+    typedef float Real;
+    typedef float V;
+    typedef bool M;
+    static const size_t WIDTH = 1;
+
+    static V Set(double x) { return static_cast<float>(x); }
+    static V Load(const float* x) { return *x; }
+    static void Store(float* out, V x) { *out = x; }
+
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    static V Div(V a, V b) { return a / b; }
+    static V Fma(V a, V b, V c) { return a * b + c; }
+    static V Min(V a, V b) { return a < b ? a : b; }
+    static V Max(V a, V b) { return a > b ? a : b; }
+    static V Abs(V x) { return std::fabs(x); }
+    static V Round(V x) { return std::nearbyint(x); }
+
+    static M Less(V a, V b) { return a < b; }
+    static M Greater(V a, V b) { return a > b; }
+    static M IsNan(V x) { return x != x; }
+    static V Select(M m, V a, V b) { return m ? a : b; }
+
+    static V Pow2(V k) {
+        uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(k) + 127) << 23;
+        float result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+};
+
+}
+
+DEFINE_MATH_KERNEL_TABLE(Scalar, Scalar, ScalarFloat)
+
+static std::atomic<int> math_backend(NATIVE_MATH); // Selected backend
+static std::atomic<int> simd_level(-1); // Selected instruction set, -1 until first use
+
+static void BoostNormalCdf(const double* x, double* out, size_t n) {
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t index = 0; index < n; index++) out[index] = boost::math::cdf(normal, x[index]);
+}
+
+static void BoostNormalPdf(const double* x, double* out, size_t n) {
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t index = 0; index < n; index++) out[index] = boost::math::pdf(normal, x[index]);
+}
+
+static void StdExp(const double* x, double* out, size_t n) {
+    for (size_t index = 0; index < n; index++) out[index] = std::exp(x[index]);
+}
+
+static void StdLog(const double* x, double* out, size_t n) {
+    for (size_t index = 0; index < n; index++) out[index] = std::log(x[index]);
+}
+
+static void BoostNormalQuantile(const double* p, double* out, size_t n) {
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t i = 0; i < n; i++) out[i] = boost::math::quantile(normal, p[i]);
+}
+
+// Reference single precision kernels evaluate in double and round once
+static void BoostNormalCdfFloat(const float* x, float* out, size_t n) {
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t index = 0; index < n; index++) out[index] = static_cast<float>(boost::math::cdf(normal, x[index]));
+}
+
+static void BoostNormalPdfFloat(const float* x, float* out, size_t n) {
+    boost::math::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t index = 0; index < n; index++) out[index] = static_cast<float>(boost::math::pdf(normal, x[index]));
+}
+
+// The lattice step has no special functions, so the reference backend shares the scalar one
+static const MathKernelTable reference_kernels = { BoostNormalCdf, BoostNormalPdf, StdExp, StdLog, BoostNormalQuantile, ScalarLatticeStep,
+                                                   BoostNormalCdfFloat, BoostNormalPdfFloat };
+
+static const MathKernelTable* NativeKernels(enum SimdLevel level) {
+    /*
+     Kernel table compiled for an instruction set, falling back to narrower ones
+     */
+    const MathKernelTable* table = nullptr;
+
+    switch (level) {
+        case SIMD_AVX512:
+            table = Avx512MathKernels();
+            if (table) break;
+            // fall through
+        case SIMD_AVX2:
+            table = Avx2MathKernels();
+            if (table) break;
+            // fall through
+        case SIMD_SSE2:
+            table = Sse2MathKernels();
+            if (table) break;
+            // fall through
+        default:
+            table = ScalarMathKernels();
+            break;
+    }
+
+    return table;
+}
+
+static const MathKernelTable* ActiveKernels() {
+    /*
+     Kernel table for the current backend and instruction set
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) return &reference_kernels;
+
+    return NativeKernels(ActiveSimdLevel());
+}
+
+/* BACKEND START */
+
+void SetMathBackend(enum MathBackend backend) {
+    math_backend.store(backend, std::memory_order_relaxed);
+}
+
+enum MathBackend GetMathBackend() {
+    return static_cast<enum MathBackend>(math_backend.load(std::memory_order_relaxed));
+}
+
+enum SimdLevel DetectedSimdLevel() {
+    /*
+     Widest instruction set supported by the CPU and the operating system
+     */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const enum SimdLevel detected = __builtin_cpu_supports("avx512f") ? SIMD_AVX512 :
+        (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? SIMD_AVX2 :
+        __builtin_cpu_supports("sse2") ? SIMD_SSE2 : SIMD_NONE;
+    return detected;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+enum SimdLevel ActiveSimdLevel() {
+    int level = simd_level.load(std::memory_order_relaxed);
+
+    if (level < 0) {
+        level = DetectedSimdLevel();
+        simd_level.store(level, std::memory_order_relaxed);
+    }
+
+    return static_cast<enum SimdLevel>(level);
+}
+
+void SetSimdLevel(enum SimdLevel level) {
+    simd_level.store(level < DetectedSimdLevel() ? level : DetectedSimdLevel(), std::memory_order_relaxed);
+}
+
+/* BACKEND END */
+
+/* SCALAR KERNELS START */
+
+double NormalCdf(double x) {
+    /*
+     Standard normal cumulative distribution. Same approximation as the array kernels, with
+     the region selected by a branch instead of a blend
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) {
+        return boost::math::cdf(boost::math::normal_distribution<double>(0.0, 1.0), x);
+    }
+
+    double y = std::fabs(x);
+    double num, den;
+
+    if (y <= CODY_SPLIT_1) {
+        double xsq = x * x;
+        num = CODY_A[4] * xsq;
+        den = xsq;
+        for (int i = 0; i < 3; i++) {
+            num = (num + CODY_A[i]) * xsq;
+            den = (den + CODY_B[i]) * xsq;
+        }
+        return 0.5 + x * (num + CODY_A[3]) / (den + CODY_B[3]);
+    }
+
+    double ratio;
+
+    if (y <= CODY_SPLIT_2) {
+        num = CODY_C[8] * y;
+        den = y;
+        for (int i = 0; i < 7; i++) {
+            num = (num + CODY_C[i]) * y;
+            den = (den + CODY_D[i]) * y;
+        }
+        ratio = (num + CODY_C[7]) / (den + CODY_D[7]);
+    } else {
+        double inv = 1.0 / (y * y);
+        num = CODY_P[5] * inv;
+        den = inv;
+        for (int i = 0; i < 4; i++) {
+            num = (num + CODY_P[i]) * inv;
+            den = (den + CODY_Q[i]) * inv;
+        }
+        ratio = (INV_SQRT_2PI - inv * (num + CODY_P[4]) / (den + CODY_Q[4])) / y;
+    }
+
+    double lower = GaussianTailKernel<Scalar>(y, ratio);
+
+    return x > 0 ? 1.0 - lower : lower;
+}
+
+double NormalPdf(double x) {
+    /*
+     Standard normal density
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) {
+        return boost::math::pdf(boost::math::normal_distribution<double>(0.0, 1.0), x);
+    }
+
+    return NormalPdfKernel<Scalar>(x);
+}
+
+double Exp(double x) {
+    /*
+     Exponential
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) return std::exp(x);
+
+    return ExpKernel<Scalar>(x);
+}
+
+double Log(double x) {
+    /*
+     Natural logarithm
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) return std::log(x);
+
+    return LogKernel<Scalar>(x);
+}
+
+double NormalQuantile(double p) {
+    /*
+     Inverse standard normal cumulative distribution, p in (0, 1)
+     */
+    if (math_backend.load(std::memory_order_relaxed) == BOOST_MATH) {
+        return boost::math::quantile(boost::math::normal_distribution<double>(0.0, 1.0), p);
+    }
+
+    return NormalQuantileKernel<Scalar>(p);
+}
+
+/* SCALAR KERNELS END */
+
+/* ARRAY KERNELS START */
+
+void NormalCdf(const double* x, double* out, size_t n) {
+    ActiveKernels()->normal_cdf(x, out, n);
+}
+
+void NormalPdf(const double* x, double* out, size_t n) {
+    ActiveKernels()->normal_pdf(x, out, n);
+}
+
+void Exp(const double* x, double* out, size_t n) {
+    ActiveKernels()->exp(x, out, n);
+}
+
+void Log(const double* x, double* out, size_t n) {
+    ActiveKernels()->log(x, out, n);
+}
+
+void NormalQuantile(const double* p, double* out, size_t n) {
+    ActiveKernels()->normal_quantile(p, out, n);
+}
+
+void LatticeStep(const double* next, const double* spot, const double* weights, size_t branches,
+                 double strike, double sign, bool american, double* out, size_t n) {
+    ActiveKernels()->lattice_step(next, spot, weights, branches, strike, sign, american, out, n);
+}
+
+void NormalCdf(const float* x, float* out, size_t n) {
+    ActiveKernels()->normal_cdf_float(x, out, n);
+}
+
+void NormalPdf(const float* x, float* out, size_t n) {
+    ActiveKernels()->normal_pdf_float(x, out, n);
+}
+
+static void ApplyInFloat(void (*kernel)(const float*, float*, size_t), const double* x, double* out, size_t n) {
+    /*
+     Round a double array to float in stack blocks, apply a single precision kernel and widen back
+     */
+    const size_t block = 256;
+    float lanes[block];
+
+    for (size_t start = 0; start < n; start += block) {
+        size_t count = n - start < block ? n - start : block;
+        for (size_t index = 0; index < count; index++) lanes[index] = static_cast<float>(x[start + index]);
+        kernel(lanes, lanes, count);
+        for (size_t index = 0; index < count; index++) out[start + index] = lanes[index];
+    }
+}
+
+void NormalCdfMixed(const double* x, double* out, size_t n) {
+    ApplyInFloat(ActiveKernels()->normal_cdf_float, x, out, n);
+}
+
+void NormalPdfMixed(const double* x, double* out, size_t n) {
+    ApplyInFloat(ActiveKernels()->normal_pdf_float, x, out, n);
+}
+
+/* ARRAY KERNELS END */
@@ -0,0 +1,72 @@
+//
+//  File: NormalMath.hpp
+//  Project: ExactPricingModels
+//  Objective: Normal distribution, exp, log and lattice kernels used by the pricers
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef NormalMath_hpp
+#define NormalMath_hpp
+
+#include <stdio.h>
+#include <stddef.h>
+
+enum MathBackend{ NATIVE_MATH, BOOST_MATH }; // Native kernels (default) or boost::math reference
+
+enum SimdLevel{ SIMD_NONE, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 }; // Instruction set used by the array kernels
+
+/* BACKEND START */
+
+void SetMathBackend(enum MathBackend backend); // Select the backend for every kernel below
+
+enum MathBackend GetMathBackend(); // Current backend
+
+enum SimdLevel DetectedSimdLevel(); // Widest instruction set supported by this CPU
+
+enum SimdLevel ActiveSimdLevel(); // Instruction set used by the array kernels
+
+void SetSimdLevel(enum SimdLevel level); // Cap the array kernels at a given instruction set (never above the detected one)
+
+/* BACKEND END */
+
+/* SCALAR KERNELS START */
+
+double NormalCdf(double x); // Standard normal cumulative distribution N(x). Relative error below 1e-15 down to N(x) of about 2e-308 (x = -37.5), about 1e-12 just beyond, then absolute
+
+double NormalPdf(double x); // Standard normal density n(x), same accuracy as NormalCdf. 0 for huge or infinite |x|, NaN for NaN
+
+double Exp(double x); // Exponential. exp(NaN) is NaN
+
+double Log(double x); // Natural logarithm. -inf at 0, NaN below 0 and for NaN
+
+double NormalQuantile(double p); // Inverse of N, p in (0, 1)
+
+/* SCALAR KERNELS END */
+
+/* ARRAY KERNELS START */
+
+void NormalCdf(const double* x, double* out, size_t n); // out[i] = N(x[i])
+
+void NormalPdf(const double* x, double* out, size_t n); // out[i] = n(x[i])
+
+void Exp(const double* x, double* out, size_t n); // out[i] = exp(x[i])
+
+void Log(const double* x, double* out, size_t n); // out[i] = log(x[i])
+
+void NormalQuantile(const double* p, double* out, size_t n); // out[i] = N^-1(p[i])
+
+void LatticeStep(const double* next, const double* spot, const double* weights, size_t branches,
+                 double strike, double sign, bool american, double* out, size_t n); // out[i] = weights . next[i .. i + branches), floored by sign * (spot[i] - strike) when american. Binomial: weights {down, 0, up}. out may be next
+
+void NormalCdf(const float* x, float* out, size_t n); // Single precision N, twice the lanes of the double kernel. Absolute error below 1e-7, relative below 5e-7
+
+void NormalPdf(const float* x, float* out, size_t n); // Single precision n, relative error below 3e-7
+
+void NormalCdfMixed(const double* x, double* out, size_t n); // N evaluated by the single precision kernel, double in and out (see MIXED_PRECISION). out may be x
+
+void NormalPdfMixed(const double* x, double* out, size_t n); // n evaluated by the single precision kernel, double in and out. out may be x
+
+/* ARRAY KERNELS END */
+
+#endif /* NormalMath_hpp */
@@ -0,0 +1,125 @@
+//
+//  File: NormalMathAvx2.cpp
+//  Project: ExactPricingModels
+//  Objective: AVX2/FMA instantiation of the normal distribution kernels
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NORMAL_MATH_AVX2
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+#include <immintrin.h>
+#endif
+
+// Included after the target pragma so every kernel instantiation is compiled for this instruction set
+#include "NormalMathKernels.hpp"
+
+#if defined(NORMAL_MATH_AVX2)
+
+namespace {
+
+struct Avx2 {
+    /*
+     Four lane adapter
+     */
+    typedef double Real;
+    typedef __m256d V;
+    typedef __m256d M;
+    static const size_t WIDTH = 4;
+
+    static V Set(double x) { return _mm256_set1_pd(x); }
+    static V Load(const double* x) { return _mm256_loadu_pd(x); }
+    static void Store(double* out, V x) { _mm256_storeu_pd(out, x); }
+
+    static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V Div(V a, V b) { return _mm256_div_pd(a, b); }
+    static V Fma(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+    static V Min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V Max(V a, V b) { return _mm256_max_pd(a, b); }
+    static V Abs(V x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+    static V Sqrt(V x) { return _mm256_sqrt_pd(x); }
+    static V Round(V x) { return _mm256_round_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static M Less(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static M Greater(V a, V b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static M IsNan(V x) { return _mm256_cmp_pd(x, x, _CMP_UNORD_Q); }
+    static V Select(M m, V a, V b) { return _mm256_blendv_pd(b, a, m); }
+
+    static V Pow2(V k) {
+        V shifter = _mm256_set1_pd(6755399441055744.0);
+        __m256i bits = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(k, shifter)), _mm256_castpd_si256(shifter));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(bits, _mm256_set1_epi64x(1023)), 52));
+    }
+
+    static V Split(V x, V& mantissa) {
+        __m256i bits = _mm256_castpd_si256(x);
+        __m256i two52 = _mm256_set1_epi64x(0x4330000000000000LL);
+        V biased = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), two52)), _mm256_castsi256_pd(two52));
+        mantissa = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                       _mm256_set1_epi64x(0x3FF0000000000000LL)));
+        return _mm256_sub_pd(biased, _mm256_set1_pd(1023.0));
+    }
+};
+
+struct Avx2Float {
+    /*
+     Eight lane single precision adapter
+     */
+    typedef float Real;
+    typedef __m256 V;
+    typedef __m256 M;
+    static const size_t WIDTH = 8;
+
+    static V Set(double x) { return _mm256_set1_ps(static_cast<float>(x)); }
+    static V Load(const float* x) { return _mm256_loadu_ps(x); }
+    static void Store(float* out, V x) { _mm256_storeu_ps(out, x); }
+
+    static V Add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V Fma(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V Min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V Max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V Abs(V x) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x); }
+    static V Round(V x) { return _mm256_round_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static M Less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M Greater(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static M IsNan(V x) { return _mm256_cmp_ps(x, x, _CMP_UNORD_Q); }
+    static V Select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+
+    static V Pow2(V k) {
+        V shifter = _mm256_set1_ps(12582912.0f);
+        __m256i bits = _mm256_sub_epi32(_mm256_castps_si256(_mm256_add_ps(k, shifter)), _mm256_castps_si256(shifter));
+        return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(bits, _mm256_set1_epi32(127)), 23));
+    }
+};
+
+}
+
+DEFINE_MATH_KERNEL_TABLE(Avx2, Avx2, Avx2Float)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+
+const MathKernelTable* Avx2MathKernels() {
+    return nullptr;
+}
+
+#endif
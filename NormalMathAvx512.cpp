@@ -0,0 +1,123 @@
+//
+//  File: NormalMathAvx512.cpp
+//  Project: ExactPricingModels
+//  Objective: AVX-512 instantiation of the normal distribution kernels
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NORMAL_MATH_AVX512
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#pragma GCC diagnostic ignored "-Wuninitialized" // False positive on _mm512_undefined_* inside GCC's own headers
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+#endif
+
+// Included after the target pragma so every kernel instantiation is compiled for this instruction set
+#include "NormalMathKernels.hpp"
+
+#if defined(NORMAL_MATH_AVX512)
+
+namespace {
+
+struct Avx512 {
+    /*
+     Eight lane adapter. Comparisons produce mask registers
+     */
+    typedef double Real;
+    typedef __m512d V;
+    typedef __mmask8 M;
+    static const size_t WIDTH = 8;
+
+    static V Set(double x) { return _mm512_set1_pd(x); }
+    static V Load(const double* x) { return _mm512_loadu_pd(x); }
+    static void Store(double* out, V x) { _mm512_storeu_pd(out, x); }
+
+    static V Add(V a, V b) { return _mm512_add_pd(a, b); }
+    static V Sub(V a, V b) { return _mm512_sub_pd(a, b); }
+    static V Mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static V Div(V a, V b) { return _mm512_div_pd(a, b); }
+    static V Fma(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+    static V Min(V a, V b) { return _mm512_min_pd(a, b); }
+    static V Max(V a, V b) { return _mm512_max_pd(a, b); }
+    static V Abs(V x) { return _mm512_abs_pd(x); }
+    static V Sqrt(V x) { return _mm512_sqrt_pd(x); }
+    static V Round(V x) { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static M Less(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static M Greater(V a, V b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    static M IsNan(V x) { return _mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q); }
+    static V Select(M m, V a, V b) { return _mm512_mask_blend_pd(m, b, a); }
+
+    static V Pow2(V k) {
+        V shifter = _mm512_set1_pd(6755399441055744.0);
+        __m512i bits = _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(k, shifter)), _mm512_castpd_si512(shifter));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_add_epi64(bits, _mm512_set1_epi64(1023)), 52));
+    }
+
+    static V Split(V x, V& mantissa) {
+        mantissa = _mm512_getmant_pd(x, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+        return _mm512_getexp_pd(x);
+    }
+};
+
+struct Avx512Float {
+    /*
+     Sixteen lane single precision adapter
+     */
+    typedef float Real;
+    typedef __m512 V;
+    typedef __mmask16 M;
+    static const size_t WIDTH = 16;
+
+    static V Set(double x) { return _mm512_set1_ps(static_cast<float>(x)); }
+    static V Load(const float* x) { return _mm512_loadu_ps(x); }
+    static void Store(float* out, V x) { _mm512_storeu_ps(out, x); }
+
+    static V Add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V Fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    static V Min(V a, V b) { return _mm512_min_ps(a, b); }
+    static V Max(V a, V b) { return _mm512_max_ps(a, b); }
+    static V Abs(V x) { return _mm512_abs_ps(x); }
+    static V Round(V x) { return _mm512_roundscale_ps(x, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+
+    static M Less(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static M Greater(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static M IsNan(V x) { return _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q); }
+    static V Select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+
+    static V Pow2(V k) {
+        V shifter = _mm512_set1_ps(12582912.0f);
+        __m512i bits = _mm512_sub_epi32(_mm512_castps_si512(_mm512_add_ps(k, shifter)), _mm512_castps_si512(shifter));
+        return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(bits, _mm512_set1_epi32(127)), 23));
+    }
+};
+
+}
+
+DEFINE_MATH_KERNEL_TABLE(Avx512, Avx512, Avx512Float)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+
+const MathKernelTable* Avx512MathKernels() {
+    return nullptr;
+}
+
+#endif
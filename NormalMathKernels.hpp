@@ -0,0 +1,433 @@
+//
+//  File: NormalMathKernels.hpp
+//  Project: ExactPricingModels
+//  Objective: Instruction-set independent exp, log, normal distribution and lattice kernels
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef NormalMathKernels_hpp
+#define NormalMathKernels_hpp
+
+#include <stddef.h>
+
+struct MathKernelTable {
+    /*
+     Array kernels compiled for one instruction set
+     */
+    void (*normal_cdf)(const double* x, double* out, size_t n);
+    void (*normal_pdf)(const double* x, double* out, size_t n);
+    void (*exp)(const double* x, double* out, size_t n);
+    void (*log)(const double* x, double* out, size_t n);
+    void (*normal_quantile)(const double* p, double* out, size_t n);
+    void (*lattice_step)(const double* next, const double* spot, const double* weights, size_t branches,
+                         double strike, double sign, bool american, double* out, size_t n);
+    void (*normal_cdf_float)(const float* x, float* out, size_t n); // Single precision, twice the lanes
+    void (*normal_pdf_float)(const float* x, float* out, size_t n);
+};
+
+const MathKernelTable* ScalarMathKernels(); // Portable one lane kernels
+const MathKernelTable* Sse2MathKernels(); // nullptr when not compiled for x86
+const MathKernelTable* Avx2MathKernels(); // nullptr when not compiled for x86
+const MathKernelTable* Avx512MathKernels(); // nullptr when not compiled for x86
+
+/*
+ The kernels below are written once against an instruction set adapter `Isa` exposing
+    Real                                lane type, double or float
+    V                                   vector of Real
+    M                                   lane mask
+    WIDTH                               lanes per vector
+    Set, Load, Store                    broadcast / memory access
+    Add, Sub, Mul, Div, Fma, Min, Max   arithmetic (Fma(a, b, c) = a*b + c). Min and Max return b when a or b is NaN
+    Abs, Round, Sqrt                    absolute value, round to nearest integer, square root
+    Less, Greater, IsNan                lane comparisons, IsNan(x) is x != x
+    Select(m, a, b)                     a where m is set, b elsewhere
+    Pow2(k)                             2^k for integral k in [-1022, 1023]
+    Split(x, m)                         exponent of x (as a double), m = mantissa in [1, 2)
+ Every translation unit that includes this file defines its own adapter inside an anonymous
+ namespace, so each instantiation is private to the instruction set it was compiled for.
+ Float adapters only instantiate exp, the normal cdf and the normal pdf, and need neither Sqrt
+ nor Split.
+ The functions are branch free: every lane evaluates every region and the result is selected.
+ */
+
+// Cody (1969) rational approximations for the normal cdf, as used in R's pnorm
+static const double CODY_A[5] = {
+    2.2352520354606839287, 161.02823106855587881, 1067.6894854603709582,
+    18154.981253343561249, 0.065682337918207449113 };
+static const double CODY_B[4] = {
+    47.20258190468824187, 976.09855173777669322, 10260.932208618978205,
+    45507.789335026729956 };
+static const double CODY_C[9] = {
+    0.39894151208813466764, 8.8831497943883759412, 93.506656132177855979,
+    597.27027639480026226, 2494.5375852903726711, 6848.1904505362823326,
+    11602.651437647350124, 9842.7148383839780218, 1.0765576773720192317e-8 };
+static const double CODY_D[8] = {
+    22.266688044328115691, 235.38790178262499861, 1519.377599407554805,
+    6485.558298266760755, 18615.571640885098091, 34900.952721145977266,
+    38912.003286093271411, 19685.429676859990727 };
+static const double CODY_P[6] = {
+    0.21589853405795699, 0.1274011611602473639, 0.022235277870649807,
+    0.001421619193227893466, 2.9112874951168792e-5, 0.02307344176494017303 };
+static const double CODY_Q[5] = {
+    1.28426009614491121, 0.468238212480865118, 0.0659881378689285515,
+    0.00378239633202758244, 7.29751555083966205e-5 };
+
+// Wichura (1988) AS241 rational approximations for the normal quantile, in ascending powers
+static const double WICHURA_A[8] = {
+    3.387132872796366608, 133.14166789178437745, 1971.5909503065514427, 13731.693765509461125,
+    45921.953931549871457, 67265.770927008700853, 33430.575583588128105, 2509.0809287301226727 };
+static const double WICHURA_B[8] = {
+    1.0, 42.313330701600911252, 687.1870074920579083, 5394.1960214247511077,
+    21213.794301586595867, 39307.89580009271061, 28729.085735721942674, 5226.495278852545925 };
+static const double WICHURA_C[8] = {
+    1.42343711074968357734, 4.6303378461565452959, 5.7694972214606914055, 3.64784832476320460504,
+    1.27045825245236838258, 0.24178072517745061177, 0.0227238449892691845833, 7.7454501427834140764e-4 };
+static const double WICHURA_D[8] = {
+    1.0, 2.05319162663775882187, 1.6763848301838038494, 0.68976733498510000455,
+    0.14810397642748007459, 0.0151986665636164571966, 5.475938084995344946e-4, 1.05075007164441684324e-9 };
+static const double WICHURA_E[8] = {
+    6.6579046435011037772, 5.4637849111641143699, 1.7848265399172913358, 0.29656057182850489123,
+    0.026532189526576123093, 0.0012426609473880784386, 2.71155556874348757815e-5, 2.01033439929228813265e-7 };
+static const double WICHURA_F[8] = {
+    1.0, 0.59983220655588793769, 0.13692988092273580531, 0.0148753612908506148525,
+    7.868691311456132591e-4, 1.8463183175100546818e-5, 1.4215117583164458887e-7, 2.04426310338993978564e-15 };
+
+static const double CODY_SPLIT_1 = 0.67448975; // Upper bound of the central region
+static const double CODY_SPLIT_2 = 5.656854249492380195206754896838; // sqrt(32), upper bound of the middle region
+
+static const double LOG2E = 1.4426950408889634073599;
+static const double LN2_HI = 6.93147180369123816490e-01; // High part of ln(2), exact for |k| < 2^21
+static const double LN2_LO = 1.90821492927058770002e-10; // Low part of ln(2)
+static const double LN2_HI_FLOAT = 0.693359375; // Single precision split of ln(2) (Cody and Waite), k * LN2_HI_FLOAT exact for |k| < 2^15
+static const double LN2_LO_FLOAT = -2.12194440e-4;
+static const double INV_SQRT_2PI = 0.398942280401432677939946059934;
+static const double SQRT_HALF = 0.707106781186547524400844362105;
+
+template <class Isa>
+inline typename Isa::V ExpKernel(typename Isa::V x) {
+    /*
+     exp(x) = 2^k * e^r with k = round(x / ln2) and |r| <= ln2 / 2. e^r is a degree 13 Taylor
+     polynomial (truncation error below 1e-17), degree 7 in single precision. 2^k is applied in
+     two halves so results down to the subnormal range stay exact. x is the second operand of
+     the clamp, so NaN passes through it and the result is NaN
+     */
+    typedef typename Isa::V V;
+
+    if constexpr (sizeof(typename Isa::Real) == sizeof(float)) {
+        // Single precision: float exponent range, float split of ln(2), degree 7 (truncation error below 1e-8)
+        x = Isa::Min(Isa::Set(89.0), Isa::Max(Isa::Set(-104.0), x));
+
+        V k = Isa::Round(Isa::Mul(x, Isa::Set(LOG2E)));
+
+        V r = Isa::Fma(k, Isa::Set(-LN2_HI_FLOAT), x);
+        r = Isa::Fma(k, Isa::Set(-LN2_LO_FLOAT), r);
+
+        V p = Isa::Set(1.0 / 5040.0);
+        p = Isa::Fma(p, r, Isa::Set(1.0 / 720.0));
+        p = Isa::Fma(p, r, Isa::Set(1.0 / 120.0));
+        p = Isa::Fma(p, r, Isa::Set(1.0 / 24.0));
+        p = Isa::Fma(p, r, Isa::Set(1.0 / 6.0));
+        p = Isa::Fma(p, r, Isa::Set(0.5));
+        p = Isa::Fma(p, r, Isa::Set(1.0));
+        p = Isa::Fma(p, r, Isa::Set(1.0));
+
+        V k1 = Isa::Round(Isa::Mul(k, Isa::Set(0.5)));
+        V k2 = Isa::Sub(k, k1);
+
+        return Isa::Mul(Isa::Mul(p, Isa::Pow2(k1)), Isa::Pow2(k2));
+    }
+
+    x = Isa::Min(Isa::Set(710.0), Isa::Max(Isa::Set(-746.0), x));
+
+    V k = Isa::Round(Isa::Mul(x, Isa::Set(LOG2E)));
+
+    V r = Isa::Fma(k, Isa::Set(-LN2_HI), x);
+    r = Isa::Fma(k, Isa::Set(-LN2_LO), r);
+
+    V p = Isa::Set(1.0 / 6227020800.0);
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 479001600.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 39916800.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 3628800.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 362880.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 40320.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 5040.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 720.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 120.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 24.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0 / 6.0));
+    p = Isa::Fma(p, r, Isa::Set(0.5));
+    p = Isa::Fma(p, r, Isa::Set(1.0));
+    p = Isa::Fma(p, r, Isa::Set(1.0));
+
+    V k1 = Isa::Round(Isa::Mul(k, Isa::Set(0.5)));
+    V k2 = Isa::Sub(k, k1);
+
+    return Isa::Mul(Isa::Mul(p, Isa::Pow2(k1)), Isa::Pow2(k2));
+}
+
+template <class Isa>
+inline typename Isa::V LogKernel(typename Isa::V x) {
+    /*
+     log(x) = e*ln2 + log(m) with m in [sqrt(1/2), sqrt(2)). log(m) = 2*atanh(f), f = (m-1)/(m+1),
+     evaluated with the odd series up to f^21 (truncation error below 1e-18)
+     */
+    typedef typename Isa::V V;
+    typedef typename Isa::M M;
+
+    M subnormal = Isa::Less(x, Isa::Set(2.2250738585072014e-308));
+    V scaled = Isa::Select(subnormal, Isa::Mul(x, Isa::Set(18014398509481984.0)), x); // 2^54
+
+    V m;
+    V e = Isa::Split(scaled, m);
+    e = Isa::Select(subnormal, Isa::Sub(e, Isa::Set(54.0)), e);
+
+    M high = Isa::Greater(m, Isa::Set(1.0 / SQRT_HALF));
+    m = Isa::Select(high, Isa::Mul(m, Isa::Set(0.5)), m);
+    e = Isa::Select(high, Isa::Add(e, Isa::Set(1.0)), e);
+
+    V f = Isa::Div(Isa::Sub(m, Isa::Set(1.0)), Isa::Add(m, Isa::Set(1.0)));
+    V s = Isa::Mul(f, f);
+
+    V p = Isa::Set(1.0 / 21.0);
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 19.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 17.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 15.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 13.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 11.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 9.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 7.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 5.0));
+    p = Isa::Fma(p, s, Isa::Set(1.0 / 3.0));
+
+    V two_f = Isa::Add(f, f);
+    V log_m = Isa::Fma(Isa::Mul(two_f, s), p, two_f);
+
+    V result = Isa::Fma(e, Isa::Set(LN2_HI), Isa::Fma(e, Isa::Set(LN2_LO), log_m));
+
+    // Special values: log(0) = -inf, log(x < 0) = nan, log(inf) = inf, log(nan) = nan
+    result = Isa::Select(Isa::Greater(x, Isa::Set(1.7976931348623157e308)), x, result);
+    result = Isa::Select(Isa::Less(x, Isa::Set(0.0)), Isa::Set(__builtin_nan("")), result);
+    result = Isa::Select(Isa::Less(Isa::Abs(x), Isa::Set(4.9406564584124654e-324)), Isa::Set(-__builtin_inf()), result);
+    result = Isa::Select(Isa::IsNan(x), x, result);
+
+    return result;
+}
+
+template <class Isa>
+inline typename Isa::V GaussianTailKernel(typename Isa::V y, typename Isa::V ratio) {
+    /*
+     exp(-y^2 / 2) * ratio, with y^2 split as yh^2 + (y - yh)(y + yh) so the tail keeps its
+     relative accuracy for large |y| (yh has four fractional bits, yh^2 is exact): below 1e-15
+     while the result is a normal double (|y| up to about 37.5), about 1e-13 to 1e-12 at the
+     start of the subnormal range, then only an absolute 5e-324. y is clamped at 40, where the
+     result has underflowed to 0 in double and float alike, so huge and infinite y give 0
+     instead of overflowing y * 16 into inf * 0
+     */
+    typedef typename Isa::V V;
+
+    y = Isa::Min(Isa::Set(40.0), y);
+
+    V yh = Isa::Mul(Isa::Round(Isa::Mul(y, Isa::Set(16.0))), Isa::Set(1.0 / 16.0));
+    V del = Isa::Mul(Isa::Sub(y, yh), Isa::Add(y, yh));
+
+    V e1 = ExpKernel<Isa>(Isa::Mul(Isa::Mul(yh, yh), Isa::Set(-0.5)));
+    V e2 = ExpKernel<Isa>(Isa::Mul(del, Isa::Set(-0.5)));
+
+    return Isa::Mul(Isa::Mul(e1, e2), ratio);
+}
+
+template <class Isa>
+inline typename Isa::V NormalPdfKernel(typename Isa::V x) {
+    /*
+     Standard normal density
+     */
+    return GaussianTailKernel<Isa>(Isa::Abs(x), Isa::Set(INV_SQRT_2PI));
+}
+
+template <class Isa>
+inline typename Isa::V NormalCdfKernel(typename Isa::V x) {
+    /*
+     Standard normal cumulative distribution, Cody's three region rational approximation
+     */
+    typedef typename Isa::V V;
+
+    V y = Isa::Abs(x);
+
+    // Central region |x| <= 0.67448975
+    V xsq = Isa::Mul(x, x);
+    V num = Isa::Mul(Isa::Set(CODY_A[4]), xsq);
+    V den = xsq;
+    for (int i = 0; i < 3; i++) {
+        num = Isa::Mul(Isa::Add(num, Isa::Set(CODY_A[i])), xsq);
+        den = Isa::Mul(Isa::Add(den, Isa::Set(CODY_B[i])), xsq);
+    }
+    V central = Isa::Add(Isa::Set(0.5),
+                         Isa::Div(Isa::Mul(x, Isa::Add(num, Isa::Set(CODY_A[3]))),
+                                  Isa::Add(den, Isa::Set(CODY_B[3]))));
+
+    // Middle region |x| <= sqrt(32)
+    num = Isa::Mul(Isa::Set(CODY_C[8]), y);
+    den = y;
+    for (int i = 0; i < 7; i++) {
+        num = Isa::Mul(Isa::Add(num, Isa::Set(CODY_C[i])), y);
+        den = Isa::Mul(Isa::Add(den, Isa::Set(CODY_D[i])), y);
+    }
+    V middle = Isa::Div(Isa::Add(num, Isa::Set(CODY_C[7])), Isa::Add(den, Isa::Set(CODY_D[7])));
+
+    // Tail region |x| > sqrt(32)
+    V inv = Isa::Div(Isa::Set(1.0), Isa::Mul(y, y));
+    num = Isa::Mul(Isa::Set(CODY_P[5]), inv);
+    den = inv;
+    for (int i = 0; i < 4; i++) {
+        num = Isa::Mul(Isa::Add(num, Isa::Set(CODY_P[i])), inv);
+        den = Isa::Mul(Isa::Add(den, Isa::Set(CODY_Q[i])), inv);
+    }
+    V tail = Isa::Div(Isa::Mul(inv, Isa::Add(num, Isa::Set(CODY_P[4]))), Isa::Add(den, Isa::Set(CODY_Q[4])));
+    tail = Isa::Div(Isa::Sub(Isa::Set(INV_SQRT_2PI), tail), y);
+
+    V ratio = Isa::Select(Isa::Greater(y, Isa::Set(CODY_SPLIT_2)), tail, middle);
+    V lower = GaussianTailKernel<Isa>(y, ratio); // N(-|x|)
+    V outer = Isa::Select(Isa::Greater(x, Isa::Set(0.0)), Isa::Sub(Isa::Set(1.0), lower), lower);
+
+    return Isa::Select(Isa::Greater(y, Isa::Set(CODY_SPLIT_1)), outer, central);
+}
+
+template <class Isa>
+inline void WichuraPolynomials(typename Isa::V x, const double* num, const double* den, typename Isa::V& p, typename Isa::V& q) {
+    /*
+     Numerator and denominator of a degree 7 rational function of x, both in ascending powers
+     */
+    p = Isa::Set(num[7]);
+    q = Isa::Set(den[7]);
+    for (int i = 6; i >= 0; i--) {
+        p = Isa::Fma(p, x, Isa::Set(num[i]));
+        q = Isa::Fma(q, x, Isa::Set(den[i]));
+    }
+}
+
+template <class Isa>
+inline typename Isa::V NormalQuantileKernel(typename Isa::V p) {
+    /*
+     Inverse of the standard normal cumulative distribution, Wichura's AS241 (relative error
+     about 1e-16). Central region |p - 1/2| <= 0.425, then two tail regions in r = sqrt(-log(min(p, 1 - p))).
+     The numerator and denominator are selected before the one division
+     */
+    typedef typename Isa::V V;
+
+    V q = Isa::Sub(p, Isa::Set(0.5));
+
+    V central_num, central_den;
+    WichuraPolynomials<Isa>(Isa::Sub(Isa::Set(0.180625), Isa::Mul(q, q)), WICHURA_A, WICHURA_B, central_num, central_den);
+    central_num = Isa::Mul(q, central_num);
+
+    V tail_p = Isa::Min(p, Isa::Sub(Isa::Set(1.0), p));
+    V r = Isa::Sqrt(Isa::Sub(Isa::Set(0.0), LogKernel<Isa>(Isa::Max(tail_p, Isa::Set(4.9406564584124654e-324)))));
+
+    V near_num, near_den, far_num, far_den;
+    WichuraPolynomials<Isa>(Isa::Sub(r, Isa::Set(1.6)), WICHURA_C, WICHURA_D, near_num, near_den);
+    WichuraPolynomials<Isa>(Isa::Sub(r, Isa::Set(5.0)), WICHURA_E, WICHURA_F, far_num, far_den);
+
+    typename Isa::M far = Isa::Greater(r, Isa::Set(5.0));
+    V tail_num = Isa::Select(far, far_num, near_num);
+    V tail_den = Isa::Select(far, far_den, near_den);
+    tail_num = Isa::Select(Isa::Less(q, Isa::Set(0.0)), Isa::Sub(Isa::Set(0.0), tail_num), tail_num);
+
+    typename Isa::M tail = Isa::Greater(Isa::Abs(q), Isa::Set(0.425));
+
+    return Isa::Div(Isa::Select(tail, tail_num, central_num), Isa::Select(tail, tail_den, central_den));
+}
+
+template <class Isa, typename Isa::V (*Kernel)(typename Isa::V)>
+inline void ApplyKernel(const typename Isa::Real* x, typename Isa::Real* out, size_t n) {
+    /*
+     Apply a kernel over an array. The tail shorter than one vector goes through a padded buffer
+     */
+    size_t index = 0;
+
+    for (; index + Isa::WIDTH <= n; index += Isa::WIDTH) {
+        Isa::Store(out + index, Kernel(Isa::Load(x + index)));
+    }
+
+    if (index < n) {
+        typename Isa::Real buffer[Isa::WIDTH];
+        for (size_t lane = 0; lane < Isa::WIDTH; lane++) buffer[lane] = index + lane < n ? x[index + lane] : 0.0;
+        Isa::Store(buffer, Kernel(Isa::Load(buffer)));
+        for (size_t lane = 0; index + lane < n; lane++) out[index + lane] = buffer[lane];
+    }
+}
+
+template <class Isa, size_t branches, bool american>
+inline typename Isa::V LatticeNodes(const double* next, const double* spot, const double* weights, double strike, double sign) {
+    /*
+     WIDTH consecutive nodes of one backward step: discounted expectation over the next step's
+     nodes i, ..., i + branches - 1 (weights down, middle, up), floored by the exercise value
+     sign * (spot - strike) when american
+     */
+    typedef typename Isa::V V;
+
+    V value = Isa::Mul(Isa::Set(weights[0]), Isa::Load(next));
+    if (branches == 3) value = Isa::Fma(Isa::Set(weights[1]), Isa::Load(next + 1), value);
+    value = Isa::Fma(Isa::Set(weights[2]), Isa::Load(next + branches - 1), value);
+
+    if (american) value = Isa::Max(value, Isa::Mul(Isa::Set(sign), Isa::Sub(Isa::Load(spot), Isa::Set(strike))));
+
+    return value;
+}
+
+template <class Isa, size_t branches, bool american>
+inline void ApplyLatticeStep(const double* next, const double* spot, const double* weights, double strike, double sign, double* out, size_t n) {
+    /*
+     Nodes [0, n) of a backward step. out may be next itself: every vector is loaded before the
+     store that overwrites it, so the step can run in place. The tail shorter than one vector
+     goes through padded buffers
+     */
+    size_t index = 0;
+
+    for (; index + Isa::WIDTH <= n; index += Isa::WIDTH) {
+        Isa::Store(out + index, LatticeNodes<Isa, branches, american>(next + index, spot + index, weights, strike, sign));
+    }
+
+    if (index < n) {
+        double next_buffer[Isa::WIDTH + 2] = {}, spot_buffer[Isa::WIDTH] = {}, buffer[Isa::WIDTH];
+        for (size_t lane = 0; index + lane < n + branches - 1; lane++) next_buffer[lane] = next[index + lane];
+        for (size_t lane = 0; index + lane < n; lane++) spot_buffer[lane] = spot[index + lane];
+        Isa::Store(buffer, LatticeNodes<Isa, branches, american>(next_buffer, spot_buffer, weights, strike, sign));
+        for (size_t lane = 0; index + lane < n; lane++) out[index + lane] = buffer[lane];
+    }
+}
+
+template <class Isa>
+inline void LatticeStepKernel(const double* next, const double* spot, const double* weights, size_t branches,
+                              double strike, double sign, bool american, double* out, size_t n) {
+    /*
+     Binomial (2 branches) or trinomial (3 branches) backward step, with or without early exercise
+     */
+    if (branches == 2) {
+        if (american) ApplyLatticeStep<Isa, 2, true>(next, spot, weights, strike, sign, out, n);
+        else ApplyLatticeStep<Isa, 2, false>(next, spot, weights, strike, sign, out, n);
+    } else {
+        if (american) ApplyLatticeStep<Isa, 3, true>(next, spot, weights, strike, sign, out, n);
+        else ApplyLatticeStep<Isa, 3, false>(next, spot, weights, strike, sign, out, n);
+    }
+}
+
+#define DEFINE_MATH_KERNEL_TABLE(name, Isa, FloatIsa) \
+    static void name##NormalCdf(const double* x, double* out, size_t n) { ApplyKernel<Isa, NormalCdfKernel<Isa> >(x, out, n); } \
+    static void name##NormalPdf(const double* x, double* out, size_t n) { ApplyKernel<Isa, NormalPdfKernel<Isa> >(x, out, n); } \
+    static void name##Exp(const double* x, double* out, size_t n) { ApplyKernel<Isa, ExpKernel<Isa> >(x, out, n); } \
+    static void name##Log(const double* x, double* out, size_t n) { ApplyKernel<Isa, LogKernel<Isa> >(x, out, n); } \
+    static void name##NormalQuantile(const double* p, double* out, size_t n) { ApplyKernel<Isa, NormalQuantileKernel<Isa> >(p, out, n); } \
+    static void name##LatticeStep(const double* next, const double* spot, const double* weights, size_t branches, \
+                                  double strike, double sign, bool american, double* out, size_t n) { \
+        LatticeStepKernel<Isa>(next, spot, weights, branches, strike, sign, american, out, n); \
+    } \
+    static void name##NormalCdfFloat(const float* x, float* out, size_t n) { ApplyKernel<FloatIsa, NormalCdfKernel<FloatIsa> >(x, out, n); } \
+    static void name##NormalPdfFloat(const float* x, float* out, size_t n) { ApplyKernel<FloatIsa, NormalPdfKernel<FloatIsa> >(x, out, n); } \
+    const MathKernelTable* name##MathKernels() { \
+        static const MathKernelTable table = { name##NormalCdf, name##NormalPdf, name##Exp, name##Log, name##NormalQuantile, name##LatticeStep, \
+                                               name##NormalCdfFloat, name##NormalPdfFloat }; \
+        return &table; \
+    }
+
+#endif /* NormalMathKernels_hpp */
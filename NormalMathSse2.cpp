@@ -0,0 +1,136 @@
+//
+//  File: NormalMathSse2.cpp
+//  Project: ExactPricingModels
+//  Objective: SSE2 instantiation of the normal distribution kernels
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NORMAL_MATH_SSE2
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#include <immintrin.h>
+#endif
+
+// Included after the target pragma so every kernel instantiation is compiled for this instruction set
+#include "NormalMathKernels.hpp"
+
+#if defined(NORMAL_MATH_SSE2)
+
+namespace {
+
+struct Sse2 {
+    /*
+     Two lane adapter. SSE2 has no fused multiply-add or rounding instruction,
+     rounding uses the 1.5 * 2^52 shifter
+     */
+    typedef double Real;
+    typedef __m128d V;
+    typedef __m128d M;
+    static const size_t WIDTH = 2;
+
+    static V Set(double x) { return _mm_set1_pd(x); }
+    static V Load(const double* x) { return _mm_loadu_pd(x); }
+    static void Store(double* out, V x) { _mm_storeu_pd(out, x); }
+
+    static V Add(V a, V b) { return _mm_add_pd(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V Div(V a, V b) { return _mm_div_pd(a, b); }
+    static V Fma(V a, V b, V c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static V Min(V a, V b) { return _mm_min_pd(a, b); }
+    static V Max(V a, V b) { return _mm_max_pd(a, b); }
+    static V Abs(V x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+    static V Sqrt(V x) { return _mm_sqrt_pd(x); }
+
+    static M Less(V a, V b) { return _mm_cmplt_pd(a, b); }
+    static M Greater(V a, V b) { return _mm_cmpgt_pd(a, b); }
+    static M IsNan(V x) { return _mm_cmpunord_pd(x, x); }
+    static V Select(M m, V a, V b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+
+    static V Round(V x) {
+        V shifter = _mm_set1_pd(6755399441055744.0);
+        V rounded = _mm_sub_pd(_mm_add_pd(x, shifter), shifter);
+        return Select(Less(Abs(x), _mm_set1_pd(2251799813685248.0)), rounded, x);
+    }
+
+    static V Pow2(V k) {
+        V shifter = _mm_set1_pd(6755399441055744.0);
+        __m128i bits = _mm_sub_epi64(_mm_castpd_si128(_mm_add_pd(k, shifter)), _mm_castpd_si128(shifter));
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_add_epi64(bits, _mm_set1_epi64x(1023)), 52));
+    }
+
+    static V Split(V x, V& mantissa) {
+        __m128i bits = _mm_castpd_si128(x);
+        __m128i two52 = _mm_set1_epi64x(0x4330000000000000LL);
+        V biased = _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52), two52)), _mm_castsi128_pd(two52));
+        mantissa = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                 _mm_set1_epi64x(0x3FF0000000000000LL)));
+        return _mm_sub_pd(biased, _mm_set1_pd(1023.0));
+    }
+};
+
+struct Sse2Float {
+    /*
+     Four lane single precision adapter, rounding uses the 1.5 * 2^23 shifter
+     */
+    typedef float Real;
+    typedef __m128 V;
+    typedef __m128 M;
+    static const size_t WIDTH = 4;
+
+    static V Set(double x) { return _mm_set1_ps(static_cast<float>(x)); }
+    static V Load(const float* x) { return _mm_loadu_ps(x); }
+    static void Store(float* out, V x) { _mm_storeu_ps(out, x); }
+
+    static V Add(V a, V b) { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_ps(a, b); }
+    static V Div(V a, V b) { return _mm_div_ps(a, b); }
+    static V Fma(V a, V b, V c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static V Min(V a, V b) { return _mm_min_ps(a, b); }
+    static V Max(V a, V b) { return _mm_max_ps(a, b); }
+    static V Abs(V x) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x); }
+
+    static M Less(V a, V b) { return _mm_cmplt_ps(a, b); }
+    static M Greater(V a, V b) { return _mm_cmpgt_ps(a, b); }
+    static M IsNan(V x) { return _mm_cmpunord_ps(x, x); }
+    static V Select(M m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+    static V Round(V x) {
+        V shifter = _mm_set1_ps(12582912.0f);
+        V rounded = _mm_sub_ps(_mm_add_ps(x, shifter), shifter);
+        return Select(Less(Abs(x), _mm_set1_ps(4194304.0f)), rounded, x);
+    }
+
+    static V Pow2(V k) {
+        V shifter = _mm_set1_ps(12582912.0f);
+        __m128i bits = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(k, shifter)), _mm_castps_si128(shifter));
+        return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(bits, _mm_set1_epi32(127)), 23));
+    }
+};
+
+}
+
+DEFINE_MATH_KERNEL_TABLE(Sse2, Sse2, Sse2Float)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+
+const MathKernelTable* Sse2MathKernels() {
+    return nullptr;
+}
+
+#endif
@@ -8,6 +8,56 @@
 
 #include "Option.hpp"
 
+double CostOfCarry(enum UnderlyingType underlying_type, double r, double q, double R) {
+    /*
+     Carry cost (b) depends on the option's underlying asset class
+     input:
+        underlying asset class, risk-free rate, dividend yield, foreign risk-free rate
+     output:
+        cost of carry
+     */
+    
+    switch (underlying_type) {
+        case STOCK:
+            return r;
+        case DIVIDEND:
+            return r - q;
+        case FUTURES:
+            return 0;
+        case CURRENCY:
+            return r - R;
+        default:
+            return r;
+    }
+}
+
+unsigned DependentTerms(enum Parameter parameter) {
+    /*
+     Cached pricing terms that depend on a parameter, the same marks the setters apply
+     input:
+        parameter
+     output:
+        mask of PricingTerm values
+     */
+    
+    switch (parameter) {
+        case UNDERLYING:
+            return TERM_LOG_S;
+        case STRIKE:
+            return TERM_LOG_K;
+        case TIME:
+            return TERM_VOLATILITY | TERM_DRIFT | TERM_DISCOUNT | TERM_CARRY;
+        case RATE:
+            return TERM_DISCOUNT | TERM_CARRY;
+        case SIGMA:
+            return TERM_VOLATILITY | TERM_DRIFT;
+        case CARRY:
+            return TERM_DRIFT | TERM_CARRY;
+        default:
+            return ALL_TERMS;
+    }
+}
+
 Option::Option(const Option& other_option) :
 m_S(other_option.m_S),
 m_K(other_option.m_K),
@@ -20,7 +70,7 @@ underlying_type(other_option.underlying_type),
 m_q(other_option.m_q),
 m_R(other_option.m_R) {
     /*
-     Copy constructor
+     Copy constructor. Derived classes copy their cached terms
      */
 }
 
@@ -47,22 +97,7 @@ m_R(foreign_rate) {
      Parameter constructor. Carry cost (b) depends on the option's underlying asset class
      */
     
-    switch (underlying_type) {
-        case STOCK:
-            m_b = m_r;
-            break;
-        case DIVIDEND:
-            m_b = m_r - m_q;
-            break;
-        case FUTURES:
-            m_b = 0;
-            break;
-        case CURRENCY:
-            m_b = m_r - m_R;
-            break;
-        default:
-            break;
-    }
+    m_b = CostOfCarry(underlying_type, m_r, m_q, m_R);
     
 }
 
@@ -10,7 +10,9 @@
 #define Option_hpp
 
 #include <stdio.h>
+#include <span>
 #include <vector>
+#include "MeshView.hpp"
 
 using namespace std;
 
@@ -20,6 +22,53 @@ enum UnderlyingType{ STOCK, DIVIDEND, FUTURES, CURRENCY }; // Underlying asset e
 
 enum Parameter{ UNDERLYING, STRIKE, TIME, RATE, SIGMA, CARRY }; // Pricing parameter enumeration. Used for mesh pricing
 
+enum ExerciseStyle{ EUROPEAN_EXERCISE, AMERICAN_EXERCISE }; // Exercise at expiry only, or at any time. Used by the lattice and PDE engines
+
+enum Precision{ DOUBLE_PRECISION, MIXED_PRECISION }; // Arithmetic of the batch and grid Black-Scholes kernels. MIXED_PRECISION evaluates N and n in float at twice the SIMD width, log-moneyness, d1, d2, discounting and the final sums stay in double
+
+enum PricingTerm{
+    TERM_LOG_S = 1 << 0, // log(S)
+    TERM_LOG_K = 1 << 1, // log(K)
+    TERM_VOLATILITY = 1 << 2, // sqrt(T), s*sqrt(T)
+    TERM_DRIFT = 1 << 3, // (b + s*s/2)*T
+    TERM_DISCOUNT = 1 << 4, // e^(-rT)
+    TERM_CARRY = 1 << 5, // e^((b-r)T)
+    ALL_TERMS = (1 << 6) - 1
+}; // Intermediate pricing terms cached between evaluations. Setters mark the terms depending on them as stale
+
+struct GridAxis {
+    /*
+     One axis of a parameter grid. Used for grid pricing. The values are either stored,
+     e.g. {SIGMA, {0.1, 0.2, 0.3}}, or generated on demand, e.g. {SIGMA, MeshView::Linear(0.1, 0.3, 3)}
+     */
+    enum Parameter parameter = UNDERLYING; // Parameter varied along the axis
+    vector<double> mesh; // Values taken by the parameter
+    MeshView view; // Generated values, used when mesh is empty
+    
+    GridAxis(){} // Default constructor
+    
+    GridAxis(enum Parameter axis_parameter, vector<double> values) : parameter(axis_parameter), mesh(std::move(values)) {} // Stored values
+    
+    GridAxis(enum Parameter axis_parameter, const MeshView& values) : parameter(axis_parameter), view(values) {} // Generated values
+    
+    MeshView Mesh() const {
+        // Values of the axis, whichever way they are given
+        return mesh.empty() ? view : MeshView(mesh);
+    }
+};
+
+struct ParityResult {
+    /*
+     Put-call parity. Returned by value, no allocation
+     */
+    double price = 0; // Price of the opposite option type implied by parity
+    double difference = 0; // Difference between both sides of the parity relation
+};
+
+double CostOfCarry(enum UnderlyingType underlying_type, double r, double q, double R); // Carry cost (b) implied by the underlying asset class
+
+unsigned DependentTerms(enum Parameter parameter); // PricingTerm values that change with a parameter
+
 class Option {
     
     // Attributes
@@ -29,8 +78,8 @@ class Option {
     double m_r; // Risk-free rate
     double m_s; // Constant volatility
     double m_b; // Cost of carry
-    CallOrPut call_or_put; // Call or Put
-    UnderlyingType underlying_type; // Underlying asset class
+    enum CallOrPut call_or_put; // Call or Put
+    enum UnderlyingType underlying_type; // Underlying asset class
     double m_q; // Dividend
     double m_R; // Foreign risk-free rate
     
@@ -81,11 +130,11 @@ public:
         return m_b;
     }
     
-    CallOrPut CallOrPut() const {
+    enum CallOrPut CallOrPut() const {
         return call_or_put;
     }
     
-    UnderlyingType UnderlyingType() const {
+    enum UnderlyingType UnderlyingType() const {
         return underlying_type;
     }
     
@@ -103,26 +152,32 @@ public:
     
     void S(double underlying_price) {
         this->m_S = underlying_price;
+        TermsChanged(TERM_LOG_S);
     }
     
     void K(double strike_price) {
         this->m_K = strike_price;
+        TermsChanged(TERM_LOG_K);
     }
     
     void T(double time_to_maturity) {
         this->m_T = time_to_maturity;
+        TermsChanged(TERM_VOLATILITY | TERM_DRIFT | TERM_DISCOUNT | TERM_CARRY);
     }
     
     void r(double riskfree_rate) {
         this->m_r = riskfree_rate;
+        TermsChanged(TERM_DISCOUNT | TERM_CARRY);
     }
     
     void s(double constant_volatility) {
         this->m_s = constant_volatility;
+        TermsChanged(TERM_VOLATILITY | TERM_DRIFT);
     }
     
     void b(double cost_of_carry) {
         this->m_b = cost_of_carry;
+        TermsChanged(TERM_DRIFT | TERM_CARRY);
     }
     
     void CallOrPut(enum CallOrPut call_or_put) {
@@ -142,19 +197,35 @@ public:
     }
     /* SETTERS END */
     
+    // Helper functions
+protected:
+    virtual void TermsChanged(unsigned /* terms */) {
+        // Called by the setters with the PricingTerm values depending on the input set. Derived
+        // classes caching terms recompute them here, so evaluation never writes to the option
+    }
+    
+public:
     virtual double Price() const = 0; // Price the option
     
     virtual vector<double> Price(double price) const = 0; // Price the option using put-call parity
     
-    virtual vector<double> Price(vector<double>& parameter_mesh, enum Parameter parameter) const = 0; // Price the option using an array of parameters
+    virtual ParityResult Parity(double price) const = 0; // Price the option using put-call parity, without allocating
+    
+    virtual vector<double> Price(const vector<double>& parameter_mesh, enum Parameter parameter) const = 0; // Price the option using an array of parameters
+    
+    virtual void Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const = 0; // Price the option using an array of parameters into a caller-provided array
     
     virtual double Delta() const = 0; // Compute delta
     
     virtual double Gamma() const = 0; // Compute gamma
     
-    virtual vector<double> Delta(vector<double>& price_mesh) const = 0; // Compute delta using array of underlying prices
+    virtual vector<double> Delta(const vector<double>& price_mesh) const = 0; // Compute delta using array of underlying prices
+    
+    virtual vector<double> Gamma(const vector<double>& price_mesh) const = 0; // Compute gamma using array of underlying prices
+    
+    virtual void Delta(span<const double> price_mesh, span<double> deltas) const = 0; // Compute delta using array of underlying prices into a caller-provided array
     
-    virtual vector<double> Gamma(vector<double>& price_mesh) const = 0; // Compute gamma using array of underlying prices
+    virtual void Gamma(span<const double> price_mesh, span<double> gammas) const = 0; // Compute gamma using array of underlying prices into a caller-provided array
     
 };
 
@@ -0,0 +1,149 @@
+//
+//  File: OptionBatch.cpp
+//  Project: ExactPricingModels
+//  Objective: Structure-of-arrays container for a book of options
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "OptionBatch.hpp"
+
+OptionBatch::OptionBatch(const vector<EuropeanOption>& options) {
+    /*
+     Adapter constructor. Copies every option into the columns
+     */
+
+    Reserve(options.size());
+
+    for (const EuropeanOption& option: options) Add(option);
+}
+
+void OptionBatch::Add(double underlying_price,
+                      double strike_price,
+                      double time_to_maturity,
+                      double riskfree_rate,
+                      double constant_volatility,
+                      enum CallOrPut call_or_put,
+                      enum UnderlyingType underlying_type,
+                      double dividend_yield,
+                      double foreign_rate) {
+    /*
+     Append a contract. Carry cost (b) depends on the option's underlying asset class
+     */
+
+    m_S.push_back(underlying_price);
+    m_K.push_back(strike_price);
+    m_T.push_back(time_to_maturity);
+    m_r.push_back(riskfree_rate);
+    m_s.push_back(constant_volatility);
+    m_b.push_back(CostOfCarry(underlying_type, riskfree_rate, dividend_yield, foreign_rate));
+    m_call_or_put.push_back(static_cast<unsigned char>(call_or_put));
+    m_underlying_type.push_back(static_cast<unsigned char>(underlying_type));
+    m_q.push_back(dividend_yield);
+    m_R.push_back(foreign_rate);
+}
+
+void OptionBatch::Add(const Option& option) {
+    /*
+     Append a copy of an existing option. The option's carry cost is kept as is
+     */
+
+    m_S.push_back(option.S());
+    m_K.push_back(option.K());
+    m_T.push_back(option.T());
+    m_r.push_back(option.r());
+    m_s.push_back(option.s());
+    m_b.push_back(option.b());
+    m_call_or_put.push_back(static_cast<unsigned char>(option.CallOrPut()));
+    m_underlying_type.push_back(static_cast<unsigned char>(option.UnderlyingType()));
+    m_q.push_back(option.q());
+    m_R.push_back(option.R());
+}
+
+void OptionBatch::Reserve(size_t size) {
+    /*
+     Reserve capacity in every column
+     */
+
+    m_S.reserve(size);
+    m_K.reserve(size);
+    m_T.reserve(size);
+    m_r.reserve(size);
+    m_s.reserve(size);
+    m_b.reserve(size);
+    m_call_or_put.reserve(size);
+    m_underlying_type.reserve(size);
+    m_q.reserve(size);
+    m_R.reserve(size);
+}
+
+void OptionBatch::Resize(size_t size) {
+    /*
+     Resize every column. New contracts are zero initialised
+     */
+
+    m_S.resize(size);
+    m_K.resize(size);
+    m_T.resize(size);
+    m_r.resize(size);
+    m_s.resize(size);
+    m_b.resize(size);
+    m_call_or_put.resize(size);
+    m_underlying_type.resize(size);
+    m_q.resize(size);
+    m_R.resize(size);
+}
+
+void OptionBatch::Clear() {
+    /*
+     Remove all contracts
+     */
+
+    Resize(0);
+}
+
+OptionBatchView OptionBatch::View() const {
+    /*
+     Non-owning view used by the pricers
+     */
+
+    OptionBatchView view;
+
+    view.size = Size();
+    view.S = m_S.data();
+    view.K = m_K.data();
+    view.T = m_T.data();
+    view.r = m_r.data();
+    view.s = m_s.data();
+    view.b = m_b.data();
+    view.call_or_put = m_call_or_put.data();
+    view.underlying_type = m_underlying_type.data();
+    view.q = m_q.data();
+    view.R = m_R.data();
+
+    return view;
+}
+
+EuropeanOption OptionBatch::Contract(size_t index) const {
+    /*
+     Rebuild a single option from the columns
+     input:
+        contract index
+     output:
+        european option
+     */
+
+    EuropeanOption option(m_S[index],
+                          m_K[index],
+                          m_T[index],
+                          m_r[index],
+                          m_s[index],
+                          static_cast<enum CallOrPut>(m_call_or_put[index]),
+                          static_cast<enum UnderlyingType>(m_underlying_type[index]),
+                          m_q[index],
+                          m_R[index]);
+
+    option.b(m_b[index]);
+
+    return option;
+}
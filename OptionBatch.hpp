@@ -0,0 +1,129 @@
+//
+//  File: OptionBatch.hpp
+//  Project: ExactPricingModels
+//  Objective: Structure-of-arrays container for a book of options
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef OptionBatch_hpp
+#define OptionBatch_hpp
+
+#include <stdio.h>
+#include "AlignedAllocator.hpp"
+#include "EuropeanOption.hpp"
+
+struct OptionBatchView {
+    /*
+     Non-owning view over contiguous option columns. Every pointer addresses `size` elements
+     */
+    size_t size = 0; // Number of contracts
+    const double* S = nullptr; // Underlying asset prices
+    const double* K = nullptr; // Strike prices
+    const double* T = nullptr; // Times to maturity
+    const double* r = nullptr; // Risk-free rates
+    const double* s = nullptr; // Constant volatilities
+    const double* b = nullptr; // Costs of carry
+    const unsigned char* call_or_put = nullptr; // CALL (0) or PUT (1)
+    const unsigned char* underlying_type = nullptr; // Underlying asset classes, optional: nullptr reads as STOCK
+    const double* q = nullptr; // Dividends
+    const double* R = nullptr; // Foreign risk-free rates
+
+    OptionBatchView Slice(size_t begin, size_t end) const {
+        /*
+         View over contracts [begin, end)
+         */
+        OptionBatchView slice = *this;
+        slice.size = end - begin;
+        slice.S += begin;
+        slice.K += begin;
+        slice.T += begin;
+        slice.r += begin;
+        slice.s += begin;
+        slice.b += begin;
+        slice.call_or_put += begin;
+        if (slice.underlying_type) slice.underlying_type += begin;
+        if (slice.q) slice.q += begin;
+        if (slice.R) slice.R += begin;
+        return slice;
+    }
+};
+
+class OptionBatch {
+
+    // Attributes
+    AlignedVector<double> m_S; // Underlying asset prices
+    AlignedVector<double> m_K; // Strike prices
+    AlignedVector<double> m_T; // Times to maturity
+    AlignedVector<double> m_r; // Risk-free rates
+    AlignedVector<double> m_s; // Constant volatilities
+    AlignedVector<double> m_b; // Costs of carry
+    AlignedVector<unsigned char> m_call_or_put; // Calls or Puts
+    AlignedVector<unsigned char> m_underlying_type; // Underlying asset classes
+    AlignedVector<double> m_q; // Dividends
+    AlignedVector<double> m_R; // Foreign risk-free rates
+
+public:
+    /* CANONICAL HEADER START */
+    OptionBatch(){} // Default constructor
+
+    OptionBatch(const vector<EuropeanOption>& options); // Adapter from existing options
+
+    virtual ~OptionBatch(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    void Add(double underlying_price,
+             double strike_price,
+             double time_to_maturity,
+             double riskfree_rate,
+             double constant_volatility,
+             enum CallOrPut call_or_put,
+             enum UnderlyingType underlying_type,
+             double dividend_yield = 0,
+             double foreign_rate = 0); // Append a contract. Carry cost follows the underlying asset class
+
+    void Add(const Option& option); // Append a copy of an existing option
+
+    void Reserve(size_t size); // Reserve capacity in every column
+
+    void Resize(size_t size); // Resize every column
+
+    void Clear(); // Remove all contracts
+
+    size_t Size() const {
+        return m_S.size();
+    }
+
+    OptionBatchView View() const; // Non-owning view used by the pricers
+
+    EuropeanOption Contract(size_t index) const; // Rebuild a single option
+
+    /* COLUMNS START */
+
+    double* S() { return m_S.data(); }
+    double* K() { return m_K.data(); }
+    double* T() { return m_T.data(); }
+    double* r() { return m_r.data(); }
+    double* s() { return m_s.data(); }
+    double* b() { return m_b.data(); }
+    unsigned char* CallOrPut() { return m_call_or_put.data(); }
+    unsigned char* UnderlyingType() { return m_underlying_type.data(); }
+    double* q() { return m_q.data(); }
+    double* R() { return m_R.data(); }
+
+    const double* S() const { return m_S.data(); }
+    const double* K() const { return m_K.data(); }
+    const double* T() const { return m_T.data(); }
+    const double* r() const { return m_r.data(); }
+    const double* s() const { return m_s.data(); }
+    const double* b() const { return m_b.data(); }
+    const unsigned char* CallOrPut() const { return m_call_or_put.data(); }
+    const unsigned char* UnderlyingType() const { return m_underlying_type.data(); }
+    const double* q() const { return m_q.data(); }
+    const double* R() const { return m_R.data(); }
+
+    /* COLUMNS END */
+
+};
+
+#endif /* OptionBatch_hpp */
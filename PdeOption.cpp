@@ -0,0 +1,708 @@
+//
+//  File: PdeOption.cpp
+//  Project: ExactPricingModels
+//  Objective: Finite difference option, inherits Option. Crank-Nicolson with Rannacher start, American exercise
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "PdeOption.hpp"
+#include "EuropeanOption.hpp"
+#include "Metrics.hpp"
+#include "NormalMath.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+struct PdeGrid {
+    /*
+     Everything the contracts solved together share
+     */
+    PdeSettings settings;
+    size_t nodes = 0; // space_steps + 1
+    double T = 0, r = 0, b = 0; // Expiry, rate and carry cost of the boundaries
+    double log_spot_low = 0, log_spot_step = 0; // x_0 and h
+    vector<double> spot; // e^(x_j)
+    double lower = 0, diagonal = 0, upper = 0; // Operator L: (L V)_j = lower V_(j-1) + diagonal V_j + upper V_(j+1)
+    double dt = 0; // Full time step
+    double sub = 0, main = 0, super = 0; // Matrix A = I - dt/2 L
+    vector<double> pivot_inverse, factor; // Thomas factorization of A on the interior nodes 1 .. nodes - 2
+};
+
+static PdeGrid BuildGrid(const Option& option, const PdeSettings& settings, double low_spot, double high_spot) {
+    /*
+     Log-spot grid, operator and factorization for a spot range
+     input:
+        option and its settings
+        lowest and highest spot the curve must cover
+     output:
+        grid
+     */
+
+    size_t n = settings.space_steps;
+
+    if (n < 4 || n % 2 != 0) throw std::invalid_argument("PdeOption: space steps must be even and at least 4");
+    if (settings.time_steps < 1 || settings.rannacher_steps > settings.time_steps) {
+        throw std::invalid_argument("PdeOption: at least 1 time step is needed, and no more Rannacher steps than time steps");
+    }
+    if (!(option.T() > 0) || !(option.s() > 0)) throw std::invalid_argument("PdeOption: time to maturity and volatility must be positive");
+    if (!(low_spot > 0) || !(high_spot >= low_spot) || !(settings.width > 0)) {
+        throw std::invalid_argument("PdeOption: spot range and grid width must be positive");
+    }
+    if (settings.exercise == AMERICAN_EXERCISE && settings.method == PSOR_METHOD &&
+        !(settings.relaxation > 0 && settings.relaxation < 2)) {
+        throw std::invalid_argument("PdeOption: PSOR relaxation must be in (0, 2)");
+    }
+
+    PdeGrid grid;
+    grid.settings = settings;
+    grid.nodes = n + 1;
+    grid.T = option.T();
+    grid.r = option.r();
+    grid.b = option.b();
+
+    double extent = settings.width * option.s() * std::sqrt(option.T());
+    grid.log_spot_low = std::log(low_spot) - extent;
+    grid.log_spot_step = (std::log(high_spot) + extent - grid.log_spot_low) / n;
+
+    grid.spot.resize(grid.nodes);
+    for (size_t j = 0; j < grid.nodes; j++) grid.spot[j] = grid.log_spot_low + j * grid.log_spot_step;
+    Exp(grid.spot.data(), grid.spot.data(), grid.nodes);
+
+    double h = grid.log_spot_step;
+    double diffusion = 0.5 * option.s() * option.s() / (h * h);
+    double convection = (option.b() - 0.5 * option.s() * option.s()) / (2 * h);
+    grid.lower = diffusion - convection;
+    grid.diagonal = -2 * diffusion - option.r();
+    grid.upper = diffusion + convection;
+
+    // Implicit half steps of dt/2 and Crank-Nicolson steps of dt both solve with I - dt/2 L
+    grid.dt = option.T() / settings.time_steps;
+    double half = 0.5 * grid.dt;
+    grid.sub = -half * grid.lower;
+    grid.main = 1 - half * grid.diagonal;
+    grid.super = -half * grid.upper;
+
+    grid.pivot_inverse.assign(grid.nodes, 0);
+    grid.factor.assign(grid.nodes, 0);
+
+    double pivot = grid.main;
+    for (size_t j = 1; j + 1 < grid.nodes; j++) {
+        if (j > 1) pivot = grid.main - grid.sub * grid.factor[j - 1];
+        grid.pivot_inverse[j] = 1 / pivot;
+        grid.factor[j] = grid.super * grid.pivot_inverse[j];
+    }
+
+    return grid;
+}
+
+static void SolveFactored(const PdeGrid& grid, vector<double>& rhs, vector<double>& values) {
+    /*
+     Solve A V = rhs on the interior nodes with the shared factorization
+     input:
+        grid
+        rhs, boundary terms included. Overwritten
+     output:
+        interior values
+     */
+
+    size_t last = grid.nodes - 2;
+
+    rhs[1] *= grid.pivot_inverse[1];
+    for (size_t j = 2; j <= last; j++) rhs[j] = (rhs[j] - grid.sub * rhs[j - 1]) * grid.pivot_inverse[j];
+
+    values[last] = rhs[last];
+    for (size_t j = last; j-- > 1; ) values[j] = rhs[j] - grid.factor[j] * values[j + 1];
+}
+
+static size_t SolvePenalty(const PdeGrid& grid, const vector<double>& rhs, const vector<double>& payoff,
+                           vector<double>& values, vector<double>& scratch, vector<unsigned char>& exercised) {
+    /*
+     Penalty iteration (Forsyth and Vetzal, 2002): solve (A + P) V = rhs + P payoff, where P is
+     1/tolerance on the nodes where the previous iterate is below the payoff, until the exercise
+     region stops changing. The penalized diagonal differs per iteration, so each one is a fresh
+     O(nodes) Thomas solve
+     input:
+        grid
+        rhs, boundary terms included
+        payoff
+        values, start from the previous time step's values
+        scratch, 2 x nodes, and exercise flags, nodes
+     output:
+        interior values
+        number of iterations
+     */
+
+    size_t last = grid.nodes - 2;
+    double penalty = 1 / grid.settings.tolerance;
+    double* forward = scratch.data();
+    double* factors = scratch.data() + grid.nodes;
+    std::fill(exercised.begin(), exercised.end(), 0);
+
+    for (size_t iteration = 1; ; iteration++) {
+
+        bool changed = false;
+        for (size_t j = 1; j <= last; j++) {
+            unsigned char exercise = values[j] < payoff[j];
+            changed = changed || exercise != exercised[j];
+            exercised[j] = exercise;
+        }
+
+        if ((!changed && iteration > 1) || iteration > grid.settings.max_iterations) return iteration - 1;
+
+        double factor = 0;
+        for (size_t j = 1; j <= last; j++) {
+            double main = exercised[j] ? grid.main + penalty : grid.main;
+            double right = exercised[j] ? rhs[j] + penalty * payoff[j] : rhs[j];
+            double pivot = j == 1 ? main : main - grid.sub * factor;
+            forward[j] = (j == 1 ? right : right - grid.sub * forward[j - 1]) / pivot;
+            factor = grid.super / pivot;
+            factors[j] = factor;
+        }
+
+        values[last] = forward[last];
+        for (size_t j = last; j-- > 1; ) values[j] = forward[j] - factors[j] * values[j + 1];
+    }
+}
+
+static size_t SolvePsor(const PdeGrid& grid, const vector<double>& rhs, const vector<double>& payoff, vector<double>& values) {
+    /*
+     Projected successive over-relaxation: Gauss-Seidel sweeps on A V = rhs, over-relaxed and
+     projected onto V >= payoff, until the largest change is below tolerance
+     input:
+        grid
+        rhs, boundary terms included
+        payoff
+        values, start from the previous time step's values with both boundaries set
+     output:
+        interior values
+        number of sweeps
+     */
+
+    size_t last = grid.nodes - 2;
+    double omega = grid.settings.relaxation, main_inverse = 1 / grid.main;
+
+    for (size_t j = 1; j <= last; j++) values[j] = std::max(values[j], payoff[j]);
+
+    for (size_t sweep = 1; sweep <= grid.settings.max_iterations; sweep++) {
+        double change = 0;
+        for (size_t j = 1; j <= last; j++) {
+            double gauss_seidel = (rhs[j] - grid.sub * values[j - 1] - grid.super * values[j + 1]) * main_inverse;
+            double value = std::max(payoff[j], values[j] + omega * (gauss_seidel - values[j]));
+            change = std::max(change, std::fabs(value - values[j]) / std::max(1.0, std::fabs(value)));
+            values[j] = value;
+        }
+        if (change <= grid.settings.tolerance) return sweep;
+    }
+
+    return grid.settings.max_iterations;
+}
+
+static double BoundaryValue(const PdeGrid& grid, double spot, double strike, double sign, double tau, bool american) {
+    /*
+     Dirichlet value at a grid end: the discounted forward intrinsic value, floored by immediate
+     exercise for American options
+     */
+
+    double value = std::max(sign * (spot * std::exp((grid.b - grid.r) * tau) - strike * std::exp(-grid.r * tau)), 0.0);
+
+    return american ? std::max(value, sign * (spot - strike)) : value;
+}
+
+static PdeCurve SolveCurve(const PdeGrid& grid, double strike, double sign) {
+    /*
+     March one contract from expiry to tau = T on a shared grid
+     input:
+        grid
+        strike and +1/-1 call/put sign
+     output:
+        price, delta and gamma curve
+     */
+
+    size_t nodes = grid.nodes, last = nodes - 1;
+    bool american = grid.settings.exercise == AMERICAN_EXERCISE;
+    double half = 0.5 * grid.dt;
+
+    vector<double> values(nodes), payoff(nodes), rhs(nodes), scratch(american ? 2 * nodes : 0);
+    vector<unsigned char> exercised(american ? nodes : 0);
+
+    for (size_t j = 0; j < nodes; j++) payoff[j] = std::max(sign * (grid.spot[j] - strike), 0.0);
+    values = payoff;
+
+    // The node whose cell [x_j - h/2, x_j + h/2] holds the strike starts from the cell average of
+    // the payoff, so the error does not oscillate with the strike's position between nodes
+    double h = grid.log_spot_step, log_strike = std::log(strike);
+    double position = (log_strike - grid.log_spot_low) / h;
+    if (position > 0.5 && position < last - 0.5) {
+        size_t j = static_cast<size_t>(std::lround(position));
+        double low = grid.log_spot_low + (j - 0.5) * h, high = low + h;
+        values[j] = sign > 0 ? (std::exp(high) - strike - strike * (high - log_strike)) / h
+                             : (strike * (log_strike - low) - strike + std::exp(low)) / h;
+    }
+
+    double tau = 0;
+
+    auto step = [&](double length, bool crank_nicolson) {
+        tau += length;
+
+        if (crank_nicolson) {
+            for (size_t j = 1; j < last; j++) {
+                rhs[j] = values[j] + half * (grid.lower * values[j - 1] + grid.diagonal * values[j] + grid.upper * values[j + 1]);
+            }
+        } else {
+            for (size_t j = 1; j < last; j++) rhs[j] = values[j];
+        }
+
+        values[0] = BoundaryValue(grid, grid.spot[0], strike, sign, tau, american);
+        values[last] = BoundaryValue(grid, grid.spot[last], strike, sign, tau, american);
+        rhs[1] -= grid.sub * values[0];
+        rhs[last - 1] -= grid.super * values[last];
+
+        if (!american) {
+            SolveFactored(grid, rhs, values);
+        } else if (grid.settings.method == PSOR_METHOD) {
+            SolvePsor(grid, rhs, payoff, values);
+        } else {
+            SolvePenalty(grid, rhs, payoff, values, scratch, exercised);
+        }
+    };
+
+    for (size_t time_step = 0; time_step < grid.settings.time_steps; time_step++) {
+        if (time_step < grid.settings.rannacher_steps) {
+            step(half, false);
+            step(half, false);
+        } else {
+            step(grid.dt, true);
+        }
+    }
+
+    PdeCurve curve;
+    curve.spot = grid.spot;
+    curve.price = values;
+    curve.delta.resize(nodes);
+    curve.gamma.resize(nodes);
+    curve.log_spot_low = grid.log_spot_low;
+    curve.log_spot_step = grid.log_spot_step;
+
+    // dV/dS = V_x / S and d2V/dS2 = (V_xx - V_x) / S^2
+    for (size_t j = 1; j < last; j++) {
+        double first = (values[j + 1] - values[j - 1]) / (2 * h);
+        double second = (values[j + 1] - 2 * values[j] + values[j - 1]) / (h * h);
+        curve.delta[j] = first / grid.spot[j];
+        curve.gamma[j] = (second - first) / (grid.spot[j] * grid.spot[j]);
+    }
+    curve.delta[0] = curve.delta[1];
+    curve.gamma[0] = curve.gamma[1];
+    curve.delta[last] = curve.delta[last - 1];
+    curve.gamma[last] = curve.gamma[last - 1];
+
+    return curve;
+}
+
+PdeResult PdeCurve::At(double underlying_price) const {
+    /*
+     Quadratic Lagrange interpolation in log-spot through the node nearest to the spot and its
+     two neighbours
+     input:
+        spot inside the grid
+     output:
+        price, delta and gamma
+     */
+
+    if (spot.size() < 3 || !(underlying_price >= spot.front() && underlying_price <= spot.back())) {
+        throw std::invalid_argument("PdeCurve::At: spot outside the grid");
+    }
+
+    double position = (std::log(underlying_price) - log_spot_low) / log_spot_step;
+    size_t j = std::clamp<size_t>(static_cast<size_t>(std::lround(position)), 1, spot.size() - 2);
+    double t = position - static_cast<double>(j);
+
+    double w_low = 0.5 * t * (t - 1), w_mid = 1 - t * t, w_high = 0.5 * t * (t + 1);
+
+    PdeResult result;
+    result.price = w_low * price[j - 1] + w_mid * price[j] + w_high * price[j + 1];
+    result.delta = w_low * delta[j - 1] + w_mid * delta[j] + w_high * delta[j + 1];
+    result.gamma = w_low * gamma[j - 1] + w_mid * gamma[j] + w_high * gamma[j + 1];
+
+    return result;
+}
+
+PdeOption::PdeOption(const PdeOption& other_option) :
+Option(other_option),
+m_settings(other_option.m_settings) {
+    /*
+     Copy constructor
+     */
+}
+
+PdeOption::PdeOption(double underlying_price,
+                     double strike_price,
+                     double time_to_maturity,
+                     double riskfree_rate,
+                     double constant_volatility,
+                     enum CallOrPut call_or_put,
+                     enum UnderlyingType underlying_type,
+                     double dividend_yield,
+                     double foreign_rate,
+                     const PdeSettings& settings) :
+Option(underlying_price,
+       strike_price,
+       time_to_maturity,
+       riskfree_rate,
+       constant_volatility,
+       call_or_put,
+       underlying_type,
+       dividend_yield,
+       foreign_rate),
+m_settings(settings) {
+    /*
+     Parameter constructor
+     */
+}
+
+PdeOption& PdeOption::operator = (const PdeOption& other_option){
+    /*
+     Assignment operator overload
+     */
+
+    if(this == &other_option){
+        return *this;
+    }
+
+    Option::operator=(other_option);
+
+    m_settings = other_option.m_settings;
+
+    return *this;
+}
+
+PdeCurve PdeOption::Solve() const {
+    /*
+     Curve on a grid centered on S: with an even number of steps, S is the middle node
+     */
+
+    return Solve(S(), S());
+}
+
+PdeCurve PdeOption::Solve(double low_spot, double high_spot) const {
+    /*
+     Curve on a grid covering [low_spot, high_spot], extended by width standard deviations
+     input:
+        lowest and highest spot
+     output:
+        price, delta and gamma curve
+     */
+
+    METRIC_SCOPE(TIMER_PDE, 1);
+
+    return SolveCurve(BuildGrid(*this, m_settings, low_spot, high_spot), K(), CallOrPut() == CALL ? 1 : -1);
+}
+
+PdeResult PdeOption::Evaluate() const {
+    /*
+     Price, delta and gamma at S
+     */
+
+    return Solve().At(S());
+}
+
+double PdeOption::Price() const {
+    /*
+     Price the option
+     */
+
+    return Evaluate().price;
+}
+
+vector<double> PdeOption::Price(double price) const {
+    /*
+     Price the option using put-call parity
+     input:
+        option price
+     output:
+        vector with option price and parity difference
+     */
+
+    ParityResult parity = Parity(price);
+
+    return {parity.price, parity.difference};
+}
+
+ParityResult PdeOption::Parity(double price) const {
+    /*
+     Put-call parity, the same relation as EuropeanOption. American options only satisfy bounds
+     input:
+        option price
+     output:
+        price of the opposite option type and parity difference
+     */
+
+    if (m_settings.exercise == AMERICAN_EXERCISE) {
+        throw std::invalid_argument("PdeOption::Parity: put-call parity does not hold for American exercise");
+    }
+
+    EuropeanOption european(S(), K(), T(), r(), s(), CallOrPut(), UnderlyingType(), q(), R());
+    european.b(b());
+
+    return european.Parity(price);
+}
+
+vector<double> PdeOption::Price(const vector<double>& parameter_mesh, enum Parameter parameter) const {
+    /*
+     Price the option using an array of parameters
+     input:
+        parameter mesh
+        parameter type
+     output:
+        vector with prices
+     */
+
+    vector<double> prices(parameter_mesh.size());
+
+    Price(parameter_mesh, parameter, prices);
+
+    return prices;
+}
+
+void PdeOption::Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const {
+    /*
+     Price the option using an array of parameters into a caller-provided array. An UNDERLYING
+     mesh is read off one curve; other points go through PdePricer, so a STRIKE mesh shares
+     one grid
+     input:
+        parameter mesh
+        parameter type
+        prices, same size as the mesh
+     */
+
+    if (prices.size() != parameter_mesh.size()) {
+        throw std::invalid_argument("PdeOption::Price: output size differs from mesh size");
+    }
+
+    if (parameter_mesh.empty()) return;
+
+    if (parameter == UNDERLYING) {
+        PdeCurve curve = SolveMesh(parameter_mesh);
+        for (size_t index = 0; index < parameter_mesh.size(); index++) prices[index] = curve.At(parameter_mesh[index]).price;
+        return;
+    }
+
+    vector<PdeOption> points;
+    points.reserve(parameter_mesh.size());
+    for (double value: parameter_mesh) points.push_back(WithParameter(parameter, value));
+
+    vector<double> values = PdePricer().Price(points);
+
+    std::copy(values.begin(), values.end(), prices.begin());
+}
+
+double PdeOption::Delta() const {
+    /*
+     Compute delta
+     */
+
+    return Evaluate().delta;
+}
+
+double PdeOption::Gamma() const {
+    /*
+     Compute gamma
+     */
+
+    return Evaluate().gamma;
+}
+
+vector<double> PdeOption::Delta(const vector<double>& price_mesh) const {
+    /*
+     Compute delta using array of underlying prices
+     */
+
+    vector<double> deltas(price_mesh.size());
+
+    Delta(price_mesh, deltas);
+
+    return deltas;
+}
+
+vector<double> PdeOption::Gamma(const vector<double>& price_mesh) const {
+    /*
+     Compute gamma using array of underlying prices
+     */
+
+    vector<double> gammas(price_mesh.size());
+
+    Gamma(price_mesh, gammas);
+
+    return gammas;
+}
+
+void PdeOption::Delta(span<const double> price_mesh, span<double> deltas) const {
+    /*
+     Compute delta using array of underlying prices into a caller-provided array
+     */
+
+    if (deltas.size() != price_mesh.size()) {
+        throw std::invalid_argument("PdeOption::Delta: output size differs from mesh size");
+    }
+
+    if (price_mesh.empty()) return;
+
+    PdeCurve curve = SolveMesh(price_mesh);
+
+    for (size_t index = 0; index < price_mesh.size(); index++) deltas[index] = curve.At(price_mesh[index]).delta;
+}
+
+void PdeOption::Gamma(span<const double> price_mesh, span<double> gammas) const {
+    /*
+     Compute gamma using array of underlying prices into a caller-provided array
+     */
+
+    if (gammas.size() != price_mesh.size()) {
+        throw std::invalid_argument("PdeOption::Gamma: output size differs from mesh size");
+    }
+
+    if (price_mesh.empty()) return;
+
+    PdeCurve curve = SolveMesh(price_mesh);
+
+    for (size_t index = 0; index < price_mesh.size(); index++) gammas[index] = curve.At(price_mesh[index]).gamma;
+}
+
+double PdeOption::EarlyExercisePremium() const {
+    /*
+     American minus European price, both on the same grid, so the discretization error mostly cancels
+     */
+
+    PdeSettings settings = m_settings;
+
+    PdeOption european(*this);
+    settings.exercise = EUROPEAN_EXERCISE;
+    european.Settings(settings);
+
+    PdeOption american(*this);
+    settings.exercise = AMERICAN_EXERCISE;
+    american.Settings(settings);
+
+    return american.Price() - european.Price();
+}
+
+PdeOption PdeOption::WithParameter(enum Parameter parameter, double value) const {
+    /*
+     Copy of the option with one parameter replaced. A RATE point keeps the carry cost, like the
+     EuropeanOption meshes
+     */
+
+    PdeOption option(*this);
+
+    switch (parameter) {
+        case UNDERLYING: option.S(value); break;
+        case STRIKE: option.K(value); break;
+        case TIME: option.T(value); break;
+        case RATE: option.r(value); break;
+        case SIGMA: option.s(value); break;
+        case CARRY: option.b(value); break;
+        default: break;
+    }
+
+    return option;
+}
+
+PdeCurve PdeOption::SolveMesh(span<const double> price_mesh) const {
+    /*
+     One curve covering every spot of a mesh
+     */
+
+    auto [low, high] = std::minmax_element(price_mesh.begin(), price_mesh.end());
+
+    return Solve(*low, *high);
+}
+
+template <class Output>
+void PdePricer::Run(const vector<PdeOption>& book, Output output) const {
+    /*
+     Group the book by grid, split each group into chunks of PDE_CHUNK contracts and solve the
+     chunks on the thread pool
+     input:
+        book
+        output(index, curve), called once per option from the pool threads
+     */
+
+    METRIC_SCOPE(TIMER_PDE, book.size());
+
+    auto grid_key = [&](size_t index) {
+        const PdeOption& option = book[index];
+        const PdeSettings& settings = option.Settings();
+        return std::make_tuple(option.S(), option.T(), option.r(), option.s(), option.b(),
+                               settings.space_steps, settings.time_steps, settings.rannacher_steps, settings.width,
+                               static_cast<int>(settings.exercise), static_cast<int>(settings.method),
+                               settings.tolerance, settings.max_iterations, settings.relaxation);
+    };
+
+    vector<size_t> order(book.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return grid_key(a) < grid_key(b); });
+
+    // Chunks of contracts sharing a grid: [begin, end) of order
+    vector<std::pair<size_t, size_t>> chunks;
+
+    for (size_t begin = 0; begin < order.size(); ) {
+        size_t end = begin + 1;
+        while (end < order.size() && end - begin < PDE_CHUNK && grid_key(order[end]) == grid_key(order[begin])) end++;
+        chunks.emplace_back(begin, end);
+        begin = end;
+    }
+
+    auto body = [&](size_t first_chunk, size_t last_chunk) {
+        for (size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+            const PdeOption& leader = book[order[chunks[chunk].first]];
+            PdeGrid grid = BuildGrid(leader, leader.Settings(), leader.S(), leader.S());
+            for (size_t position = chunks[chunk].first; position < chunks[chunk].second; position++) {
+                const PdeOption& option = book[order[position]];
+                output(order[position], SolveCurve(grid, option.K(), option.CallOrPut() == CALL ? 1 : -1));
+            }
+        }
+    };
+
+    Pool().ParallelFor(0, chunks.size(), 1, std::cref(body));
+}
+
+vector<PdeCurve> PdePricer::Solve(const vector<PdeOption>& book) const {
+    /*
+     Curve of every option of a book, each on a grid centered on its S
+     */
+
+    vector<PdeCurve> curves(book.size());
+
+    Run(book, [&](size_t index, PdeCurve&& curve) { curves[index] = std::move(curve); });
+
+    return curves;
+}
+
+vector<PdeResult> PdePricer::Evaluate(const vector<PdeOption>& book) const {
+    /*
+     Price, delta and gamma of every option of a book at its S
+     */
+
+    vector<PdeResult> results(book.size());
+
+    Run(book, [&](size_t index, PdeCurve&& curve) { results[index] = curve.At(book[index].S()); });
+
+    return results;
+}
+
+vector<double> PdePricer::Price(const vector<PdeOption>& book) const {
+    /*
+     Price every option of a book
+     */
+
+    vector<PdeResult> results = Evaluate(book);
+
+    vector<double> prices(results.size());
+    for (size_t index = 0; index < results.size(); index++) prices[index] = results[index].price;
+
+    return prices;
+}
@@ -0,0 +1,193 @@
+//
+//  File: PdeOption.hpp
+//  Project: ExactPricingModels
+//  Objective: Finite difference option, inherits Option. Crank-Nicolson with Rannacher start, American exercise
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef PdeOption_hpp
+#define PdeOption_hpp
+
+#include <stdio.h>
+#include "Option.hpp"
+#include "ThreadPool.hpp"
+
+enum AmericanMethod{ PENALTY_METHOD, PSOR_METHOD }; // Early exercise constraint: penalty iteration (Forsyth-Vetzal) or projected SOR
+
+const size_t PDE_CHUNK = 8; // Contracts of a batch group sharing one grid and factorization per pool task
+
+struct PdeSettings {
+    size_t space_steps = 400; // Intervals of the log-spot grid, even and at least 4
+    size_t time_steps = 200; // Time steps, at least 1
+    size_t rannacher_steps = 2; // Leading Crank-Nicolson steps replaced by two implicit half steps each, damping the payoff kink
+    double width = 5; // Grid extent beyond the priced spots, in standard deviations s*sqrt(T)
+    enum ExerciseStyle exercise = AMERICAN_EXERCISE;
+    enum AmericanMethod method = PENALTY_METHOD;
+    double tolerance = 1e-8; // Convergence of the American iterations, relative to max(1, |V|)
+    size_t max_iterations = 1000; // Cap on the American iterations of one time step
+    double relaxation = 1.2; // PSOR over-relaxation factor, in (0, 2)
+};
+
+struct PdeResult {
+    double price = 0; // Price at one spot
+    double delta = 0;
+    double gamma = 0;
+};
+
+struct PdeCurve {
+    /*
+     Solution at expiry T across the whole spot grid. Nodes are uniform in log-spot
+     */
+    vector<double> spot; // Grid nodes e^(x_low + j*h)
+    vector<double> price; // Price at every node
+    vector<double> delta; // Central differences, one-sided copies at both ends
+    vector<double> gamma;
+    double log_spot_low = 0; // x_low
+    double log_spot_step = 0; // h
+
+    PdeResult At(double underlying_price) const; // Quadratic interpolation in log-spot between nodes. Throws outside the grid
+};
+
+class PdeOption : public Option {
+    /*
+     Prices an option by solving the Black-Scholes-Merton equation in x = log(S),
+        V_tau = s^2/2 V_xx + (b - s^2/2) V_x - r V,
+     with the same carry cost b as EuropeanOption, on a uniform x grid around the priced spots.
+     Time steps are Crank-Nicolson, except the first rannacher_steps, which are split into two
+     implicit Euler half steps to damp the oscillations the payoff kink causes. Both use the
+     same matrix I - dt/2 L, so one tridiagonal factorization serves every step. The coefficients
+     do not depend on the strike, so the grid and the factorization are shared by every strike
+     of a spot, expiry, rates and volatility (see PdePricer). Dirichlet boundaries are the
+     discounted forward intrinsic value. One solve yields the whole price, delta and gamma curve
+     */
+
+    // Attributes
+    PdeSettings m_settings; // Grid and solver settings
+
+public:
+    /* CANONICAL HEADER START */
+    PdeOption(){} // Default constructor
+
+    PdeOption(const PdeOption& other_option); // Copy constructor
+
+    PdeOption(double underlying_price,
+              double strike_price,
+              double time_to_maturity,
+              double riskfree_rate,
+              double constant_volatility,
+              enum CallOrPut call_or_put,
+              enum UnderlyingType underlying_type,
+              double dividend_yield = 0,
+              double foreign_rate = 0,
+              const PdeSettings& settings = PdeSettings()); // Parameter constructor
+
+    virtual ~PdeOption(){} // Destructor
+
+    PdeOption& operator = (const PdeOption& other_option); // Assignment operator overload
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    const PdeSettings& Settings() const {
+        return m_settings;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Settings(const PdeSettings& settings) {
+        this->m_settings = settings;
+    }
+
+    /* SETTERS END */
+
+    PdeCurve Solve() const; // Price, delta and gamma curve on a grid centered on S
+
+    PdeCurve Solve(double low_spot, double high_spot) const; // Curve on a grid covering [low_spot, high_spot]
+
+    PdeResult Evaluate() const; // Price, delta and gamma at S from one solve
+
+    double Price() const; // Price the option
+
+    vector<double> Price(double price) const; // Price the option using put-call parity. European exercise only
+
+    ParityResult Parity(double price) const; // Price the option using put-call parity, without allocating. European exercise only
+
+    vector<double> Price(const vector<double>& parameter_mesh, enum Parameter parameter) const; // Price the option using an array of parameters
+
+    void Price(span<const double> parameter_mesh, enum Parameter parameter, span<double> prices) const; // Price the option using an array of parameters into a caller-provided array. An UNDERLYING mesh is one solve
+
+    double Delta() const; // Compute delta
+
+    double Gamma() const; // Compute gamma
+
+    vector<double> Delta(const vector<double>& price_mesh) const; // Compute delta using array of underlying prices
+
+    vector<double> Gamma(const vector<double>& price_mesh) const; // Compute gamma using array of underlying prices
+
+    void Delta(span<const double> price_mesh, span<double> deltas) const; // Compute delta using array of underlying prices into a caller-provided array, from one solve
+
+    void Gamma(span<const double> price_mesh, span<double> gammas) const; // Compute gamma using array of underlying prices into a caller-provided array, from one solve
+
+    double EarlyExercisePremium() const; // American minus European price on the same grid
+
+    // Helper functions
+private:
+    PdeOption WithParameter(enum Parameter parameter, double value) const; // Copy with one parameter replaced, as in the EuropeanOption meshes
+
+    PdeCurve SolveMesh(span<const double> price_mesh) const; // Curve covering every spot of a mesh
+
+};
+
+class PdePricer {
+    /*
+     Prices a book of PDE options. Contracts sharing a grid (same S, T, r, s, b and settings,
+     e.g. every strike of one underlying and expiry) are grouped, so the grid and the tridiagonal
+     factorization are built once per PDE_CHUNK contracts and only the payoff, boundaries and
+     exercise constraint differ between solves
+     */
+
+    // Attributes
+    ThreadPool* m_pool = nullptr; // Pool running the groups, nullptr for the shared pool
+
+public:
+    /* CANONICAL HEADER START */
+    PdePricer(){} // Default constructor
+
+    PdePricer(ThreadPool* pool) : m_pool(pool) {} // Parameter constructor
+
+    virtual ~PdePricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    ThreadPool& Pool() const {
+        return m_pool ? *m_pool : ThreadPool::Instance();
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        this->m_pool = pool;
+    }
+
+    /* SETTERS END */
+
+    vector<PdeCurve> Solve(const vector<PdeOption>& book) const; // Curve of every option, in book order
+
+    vector<PdeResult> Evaluate(const vector<PdeOption>& book) const; // Price, delta and gamma of every option at its S, in book order
+
+    vector<double> Price(const vector<PdeOption>& book) const; // Price of every option, in book order
+
+    // Helper functions
+private:
+    template <class Output>
+    void Run(const vector<PdeOption>& book, Output output) const; // Group, solve on the pool and hand each curve to output(index, curve)
+
+};
+
+#endif /* PdeOption_hpp */
@@ -0,0 +1,130 @@
+//
+//  File: Philox.hpp
+//  Project: ExactPricingModels
+//  Objective: Philox4x32-10 counter-based random numbers
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef Philox_hpp
+#define Philox_hpp
+
+#include <stdio.h>
+#include <stddef.h>
+#include <cstdint>
+
+/*
+ Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011) maps a
+ 128-bit counter and a 64-bit key to 128 random bits. There is no state to advance: draw i of a
+ stream is a pure function of (key, i), so any thread can produce any part of a stream and
+ results do not depend on how work is split
+ */
+
+const uint32_t PHILOX_M0 = 0xD2511F53; // Round multipliers
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9; // Key schedule increments
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+inline void Philox4x32(const uint32_t counter[4], uint64_t key, uint32_t out[4]) {
+    /*
+     Ten rounds of the Philox bijection
+     input:
+        counter
+        key
+     output:
+        four random 32-bit words
+     */
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t product0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+        uint64_t product1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+        uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(product1);
+        c3 = static_cast<uint32_t>(product0);
+        c0 = next0;
+        c2 = next2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+inline double PhiloxUniform(uint32_t high, uint32_t low) {
+    // 53 random bits as a double in the open interval (0, 1), so its normal quantile is finite
+    uint64_t bits = ((static_cast<uint64_t>(high) << 32) | low) >> 11;
+    return (static_cast<double>(bits) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+const size_t PHILOX_LANES = 8; // Counters advanced together by PhiloxUniforms, so their multiply chains overlap or vectorize
+
+inline void PhiloxUniforms(uint64_t key, uint32_t stream, uint32_t step, uint64_t first, size_t n, double* out) {
+    /*
+     Uniforms first, ..., first + n - 1 of one (stream, step) sequence. Uniform i comes from half of
+     the block with counter (i / 2, step, stream). Full groups of PHILOX_LANES counters run the
+     rounds side by side; the ends go through Philox4x32
+     input:
+        key, stream and step
+        index of the first uniform and count
+     output:
+        out[0 .. n)
+     */
+    size_t index = 0;
+
+    auto single = [&](uint64_t draw) {
+        uint64_t pair = draw >> 1;
+        uint32_t counter[4] = {static_cast<uint32_t>(pair), static_cast<uint32_t>(pair >> 32), step, stream};
+        uint32_t words[4];
+        Philox4x32(counter, key, words);
+        return (draw & 1) == 0 ? PhiloxUniform(words[0], words[1]) : PhiloxUniform(words[2], words[3]);
+    };
+
+    if (n > 0 && (first & 1) != 0) out[index++] = single(first);
+
+    while (index + 2 * PHILOX_LANES <= n) {
+
+        uint64_t pair = (first + index) >> 1;
+        uint32_t c0[PHILOX_LANES], c1[PHILOX_LANES], c2[PHILOX_LANES], c3[PHILOX_LANES];
+
+        for (size_t lane = 0; lane < PHILOX_LANES; lane++) {
+            c0[lane] = static_cast<uint32_t>(pair + lane);
+            c1[lane] = static_cast<uint32_t>((pair + lane) >> 32);
+            c2[lane] = step;
+            c3[lane] = stream;
+        }
+
+        uint32_t k0 = static_cast<uint32_t>(key), k1 = static_cast<uint32_t>(key >> 32);
+
+        for (int round = 0; round < 10; round++) {
+            for (size_t lane = 0; lane < PHILOX_LANES; lane++) {
+                uint64_t product0 = static_cast<uint64_t>(PHILOX_M0) * c0[lane];
+                uint64_t product1 = static_cast<uint64_t>(PHILOX_M1) * c2[lane];
+                uint32_t next0 = static_cast<uint32_t>(product1 >> 32) ^ c1[lane] ^ k0;
+                uint32_t next2 = static_cast<uint32_t>(product0 >> 32) ^ c3[lane] ^ k1;
+                c1[lane] = static_cast<uint32_t>(product1);
+                c3[lane] = static_cast<uint32_t>(product0);
+                c0[lane] = next0;
+                c2[lane] = next2;
+            }
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        for (size_t lane = 0; lane < PHILOX_LANES; lane++) {
+            out[index + 2 * lane] = PhiloxUniform(c0[lane], c1[lane]);
+            out[index + 2 * lane + 1] = PhiloxUniform(c2[lane], c3[lane]);
+        }
+
+        index += 2 * PHILOX_LANES;
+    }
+
+    for (; index < n; index++) out[index] = single(first + index);
+}
+
+#endif /* Philox_hpp */
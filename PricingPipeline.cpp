@@ -0,0 +1,620 @@
+//
+//  File: PricingPipeline.cpp
+//  Project: ExactPricingModels
+//  Objective: Streaming parse, price and write stages for large contract files
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "PricingPipeline.hpp"
+#include "BoundedQueue.hpp"
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <charconv>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t CSV_READ_SIZE = 1 << 20; // Bytes read from the input per call
+
+struct PipelineChunk {
+    size_t sequence = 0; // Position of the chunk in the input
+    OptionBatch batch; // Parsed contracts
+    GreeksBatch greeks; // Results, filled by the pricing stage
+};
+
+typedef std::unique_ptr<PipelineChunk> ChunkPointer;
+
+typedef std::function<bool(ChunkPointer)> ChunkSink; // Hands a parsed chunk to the next stage, false once the pipeline is shutting down
+
+static double Seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static const char* const GREEK_NAMES[] = {"price", "delta", "gamma", "vega", "theta", "rho", "carry_rho"}; // Column names in GreekMask bit order
+
+static const char* const CALL_OR_PUT_NAMES[] = {"CALL", "PUT"};
+
+static const char* const UNDERLYING_TYPE_NAMES[] = {"STOCK", "DIVIDEND", "FUTURES", "CURRENCY"};
+
+static bool SameName(const char* begin, const char* end, const char* name) {
+    /*
+     Case-insensitive comparison of [begin, end) with name
+     */
+    for (; begin < end && *name; begin++, name++) {
+        if (toupper(static_cast<unsigned char>(*begin)) != *name) return false;
+    }
+    return begin == end && *name == 0;
+}
+
+[[noreturn]] static void ParseError(size_t line, const char* message) {
+    throw std::invalid_argument("line " + std::to_string(line) + ": " + message);
+}
+
+static void ParseCsvLine(const char* begin, const char* end, size_t line, OptionBatch& batch) {
+    /*
+     Parse one contract line
+        S,K,T,r,sigma,CALL|PUT,STOCK|DIVIDEND|FUTURES|CURRENCY[,q[,R]]
+     C and P are accepted for the option type, names are case-insensitive, spaces around fields are ignored
+     */
+
+    const char* fields[9][2];
+    size_t count = 0;
+
+    for (const char* field = begin; count < 9; count++) {
+
+        const char* comma = static_cast<const char*>(memchr(field, ',', end - field));
+        const char* stop = comma ? comma : end;
+
+        const char* first = field;
+        const char* last = stop;
+        while (first < last && (*first == ' ' || *first == '\t')) first++;
+        while (last > first && (last[-1] == ' ' || last[-1] == '\t')) last--;
+
+        fields[count][0] = first;
+        fields[count][1] = last;
+
+        if (!comma) {
+            count++;
+            break;
+        }
+
+        field = comma + 1;
+
+        if (count == 8) ParseError(line, "too many fields");
+    }
+
+    if (count < 7) ParseError(line, "expected S,K,T,r,sigma,CALL|PUT,STOCK|DIVIDEND|FUTURES|CURRENCY[,q[,R]]");
+
+    double values[7] = {0, 0, 0, 0, 0, 0, 0}; // S, K, T, r, sigma, q, R
+    const size_t numeric[7] = {0, 1, 2, 3, 4, 7, 8}; // Field of each value
+
+    for (size_t value = 0; value < 7; value++) {
+
+        size_t field = numeric[value];
+
+        if (field >= count) break;
+
+        std::from_chars_result parsed = std::from_chars(fields[field][0], fields[field][1], values[value]);
+
+        if (parsed.ec != std::errc() || parsed.ptr != fields[field][1]) ParseError(line, "malformed number");
+    }
+
+    enum CallOrPut call_or_put;
+
+    if (SameName(fields[5][0], fields[5][1], "CALL") || SameName(fields[5][0], fields[5][1], "C")) call_or_put = CALL;
+    else if (SameName(fields[5][0], fields[5][1], "PUT") || SameName(fields[5][0], fields[5][1], "P")) call_or_put = PUT;
+    else ParseError(line, "option type must be CALL or PUT");
+
+    int underlying_type = -1;
+
+    for (int type = STOCK; type <= CURRENCY; type++) {
+        if (SameName(fields[6][0], fields[6][1], UNDERLYING_TYPE_NAMES[type])) underlying_type = type;
+    }
+
+    if (underlying_type < 0) ParseError(line, "underlying must be STOCK, DIVIDEND, FUTURES or CURRENCY");
+
+    batch.Add(values[0], values[1], values[2], values[3], values[4], call_or_put, static_cast<enum UnderlyingType>(underlying_type), values[5], values[6]);
+}
+
+static size_t ParseCsv(std::istream& in, size_t chunk_size, const ChunkSink& emit) {
+    /*
+     Read CSV contracts in large blocks and emit them in chunks of chunk_size.
+     Blank lines, lines starting with # and a header line (first line starting with a letter) are skipped
+     output:
+        bytes read
+     */
+
+    std::vector<char> buffer(CSV_READ_SIZE);
+    size_t pending = 0; // Bytes of an incomplete line kept at the front of the buffer
+    size_t bytes = 0;
+    size_t line = 0;
+    size_t sequence = 0;
+
+    ChunkPointer chunk(new PipelineChunk());
+    chunk->batch.Reserve(chunk_size);
+
+    bool more = true;
+
+    while (more) {
+
+        if (pending == buffer.size()) buffer.resize(2 * buffer.size()); // Line longer than the buffer
+
+        in.read(buffer.data() + pending, buffer.size() - pending);
+
+        size_t read = static_cast<size_t>(in.gcount());
+
+        bytes += read;
+        more = read > 0;
+
+        const char* data = buffer.data();
+        const char* end = data + pending + read;
+        const char* start = data;
+
+        while (start < end) {
+
+            const char* newline = static_cast<const char*>(memchr(start, '\n', end - start));
+
+            if (!newline && more) break; // Incomplete line, finish it after the next read
+
+            const char* stop = newline ? newline : end;
+
+            line++;
+
+            const char* last = stop;
+            if (last > start && last[-1] == '\r') last--;
+
+            const char* first = start;
+            while (first < last && (*first == ' ' || *first == '\t')) first++;
+
+            start = newline ? newline + 1 : end;
+
+            if (first == last || *first == '#') continue;
+
+            if (line == 1 && isalpha(static_cast<unsigned char>(*first))) continue;
+
+            ParseCsvLine(first, last, line, chunk->batch);
+
+            if (chunk->batch.Size() == chunk_size) {
+
+                chunk->sequence = sequence++;
+
+                if (!emit(std::move(chunk))) return bytes;
+
+                chunk.reset(new PipelineChunk());
+                chunk->batch.Reserve(chunk_size);
+            }
+        }
+
+        pending = end - start;
+
+        memmove(buffer.data(), start, pending);
+    }
+
+    if (chunk->batch.Size() > 0) {
+        chunk->sequence = sequence;
+        emit(std::move(chunk));
+    }
+
+    return bytes;
+}
+
+static size_t ParseBinary(std::istream& in, size_t chunk_size, const ChunkSink& emit) {
+    /*
+     Read ContractRecords and emit them in chunks of chunk_size
+     output:
+        bytes read
+     */
+
+    std::vector<ContractRecord> records(chunk_size);
+    size_t bytes = 0;
+    size_t sequence = 0;
+
+    while (true) {
+
+        in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(ContractRecord));
+
+        size_t read = static_cast<size_t>(in.gcount());
+
+        bytes += read;
+
+        if (read % sizeof(ContractRecord) != 0) {
+            throw std::invalid_argument("record " + std::to_string(bytes / sizeof(ContractRecord)) + ": truncated binary record");
+        }
+
+        size_t count = read / sizeof(ContractRecord);
+
+        if (count == 0) return bytes;
+
+        ChunkPointer chunk(new PipelineChunk());
+        chunk->sequence = sequence++;
+        chunk->batch.Reserve(count);
+
+        for (size_t index = 0; index < count; index++) {
+
+            const ContractRecord& record = records[index];
+
+            if (record.call_or_put > PUT || record.underlying_type > CURRENCY) {
+                throw std::invalid_argument("record " + std::to_string((bytes - read) / sizeof(ContractRecord) + index + 1) + ": invalid option or underlying type");
+            }
+
+            chunk->batch.Add(record.S, record.K, record.T, record.r, record.s,
+                             static_cast<enum CallOrPut>(record.call_or_put),
+                             static_cast<enum UnderlyingType>(record.underlying_type),
+                             record.q, record.R);
+        }
+
+        if (!emit(std::move(chunk))) return bytes;
+
+        if (count < chunk_size) return bytes;
+    }
+}
+
+static char* AppendNumber(char* out, double value) {
+    /*
+     Shortest representation that reads back to the same double
+     */
+    return std::to_chars(out, out + 32, value).ptr;
+}
+
+static void FormatCsvHeader(unsigned mask, std::string& text) {
+
+    if (mask == 0) {
+        text += "S,K,T,r,sigma,type,underlying,q,R\n";
+        return;
+    }
+
+    bool first = true;
+
+    for (unsigned bit = 0; bit < 7; bit++) {
+        if (!(mask & (1u << bit))) continue;
+        if (!first) text += ',';
+        text += GREEK_NAMES[bit];
+        first = false;
+    }
+
+    text += '\n';
+}
+
+static void FormatChunk(const PipelineChunk& chunk, unsigned mask, enum RecordFormat format, std::vector<char>& buffer) {
+    /*
+     Encode a priced chunk, one row per contract. Result columns follow the GreekMask bit order.
+     With an empty mask the contracts themselves are written, which converts between formats
+     */
+
+    const OptionBatch& batch = chunk.batch;
+    size_t size = batch.Size();
+
+    if (mask == 0) {
+
+        if (format == BINARY_FORMAT) {
+
+            buffer.resize(size * sizeof(ContractRecord));
+
+            ContractRecord* records = reinterpret_cast<ContractRecord*>(buffer.data());
+
+            for (size_t index = 0; index < size; index++) {
+                ContractRecord record = {batch.S()[index], batch.K()[index], batch.T()[index], batch.r()[index],
+                                         batch.s()[index], batch.q()[index], batch.R()[index],
+                                         batch.CallOrPut()[index], batch.UnderlyingType()[index], {0, 0, 0, 0, 0, 0}};
+                records[index] = record;
+            }
+            return;
+        }
+
+        buffer.resize(size * 256);
+
+        char* out = buffer.data();
+
+        for (size_t index = 0; index < size; index++) {
+            const double values[5] = {batch.S()[index], batch.K()[index], batch.T()[index], batch.r()[index], batch.s()[index]};
+            for (double value: values) {
+                out = AppendNumber(out, value);
+                *out++ = ',';
+            }
+            const char* type = CALL_OR_PUT_NAMES[batch.CallOrPut()[index]];
+            const char* underlying = UNDERLYING_TYPE_NAMES[batch.UnderlyingType()[index]];
+            out = std::copy(type, type + strlen(type), out);
+            *out++ = ',';
+            out = std::copy(underlying, underlying + strlen(underlying), out);
+            *out++ = ',';
+            out = AppendNumber(out, batch.q()[index]);
+            *out++ = ',';
+            out = AppendNumber(out, batch.R()[index]);
+            *out++ = '\n';
+        }
+
+        buffer.resize(out - buffer.data());
+        return;
+    }
+
+    const AlignedVector<double>* columns[7] = {
+        &chunk.greeks.Price(), &chunk.greeks.Delta(), &chunk.greeks.Gamma(), &chunk.greeks.Vega(),
+        &chunk.greeks.Theta(), &chunk.greeks.Rho(), &chunk.greeks.CarryRho()
+    };
+
+    const double* selected[7];
+    size_t width = 0;
+
+    for (unsigned bit = 0; bit < 7; bit++) {
+        if (mask & (1u << bit)) selected[width++] = columns[bit]->data();
+    }
+
+    if (format == BINARY_FORMAT) {
+
+        buffer.resize(size * width * sizeof(double));
+
+        double* out = reinterpret_cast<double*>(buffer.data());
+
+        for (size_t index = 0; index < size; index++) {
+            for (size_t column = 0; column < width; column++) *out++ = selected[column][index];
+        }
+        return;
+    }
+
+    buffer.resize(size * width * 32);
+
+    char* out = buffer.data();
+
+    for (size_t index = 0; index < size; index++) {
+        for (size_t column = 0; column < width; column++) {
+            out = AppendNumber(out, selected[column][index]);
+            *out++ = column + 1 < width ? ',' : '\n';
+        }
+    }
+
+    buffer.resize(out - buffer.data());
+}
+
+PipelineStats PricingPipeline::Run(std::istream& in, std::ostream& out) const {
+    /*
+     Stream contracts through three stages joined by bounded queues:
+        parse: one thread reads the input and cuts it into chunks of ChunkSize() contracts
+        price: PricingThreads() workers run the fused batch kernel on whole chunks
+        write: the calling thread restores the input order and encodes the results
+     At most QueueCapacity() chunks wait between two stages, and at most 2 QueueCapacity() plus
+     one per worker are parsed and not yet written, so memory stays bounded whatever the input
+     size and however the workers overtake each other. The first error of any stage stops the
+     pipeline and is rethrown here
+     input:
+        contract stream, result stream (both opened in binary mode for BINARY_FORMAT)
+     output:
+        throughput and per-stage timings
+     */
+
+    if (m_input_format == COLUMNAR_FORMAT || m_output_format == COLUMNAR_FORMAT) {
+        throw std::invalid_argument("columnar files are mapped, not streamed");
+    }
+
+    Clock::time_point start = Clock::now();
+
+    PipelineStats stats;
+
+    size_t threads = m_pricing_threads;
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    BoundedQueue<ChunkPointer> parsed(m_queue_capacity);
+    BoundedQueue<ChunkPointer> priced(m_queue_capacity);
+
+    // One token per chunk emitted and not yet written: enough for both queues and every worker,
+    // and a bound on the writer's reorder map when one chunk is priced much later than the next ones
+    BoundedQueue<char> window(2 * m_queue_capacity + threads);
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    std::atomic<bool> failed(false);
+
+    auto fail = [&](std::exception_ptr exception) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = exception;
+        }
+        failed = true;
+        window.Close();
+        parsed.Close();
+        priced.Close();
+    };
+
+    std::thread parser([&] {
+
+        Clock::time_point parse_start = Clock::now();
+
+        ChunkSink emit = [&](ChunkPointer chunk) {
+            Clock::time_point wait_start = Clock::now();
+            bool accepted = window.Push(0) && parsed.Push(std::move(chunk));
+            stats.parse.wait_seconds += Seconds(wait_start);
+            return accepted;
+        };
+
+        try {
+            stats.bytes_read = m_input_format == BINARY_FORMAT ? ParseBinary(in, m_chunk_size, emit) : ParseCsv(in, m_chunk_size, emit);
+        } catch (...) {
+            fail(std::current_exception());
+        }
+
+        parsed.Close();
+
+        stats.parse.busy_seconds = Seconds(parse_start) - stats.parse.wait_seconds;
+    });
+
+    std::vector<StageStats> pricing(threads);
+    std::atomic<size_t> pricing_left(threads);
+    std::vector<std::thread> pricers;
+
+    for (size_t worker = 0; worker < threads; worker++) {
+
+        pricers.emplace_back([&, worker] {
+
+            // Whole chunks are priced on this thread, the shared pool is never used
+            BatchPricer pricer(nullptr, m_chunk_size);
+            StageStats& timing = pricing[worker];
+
+            try {
+                while (!failed) {
+
+                    Clock::time_point wait_start = Clock::now();
+
+                    ChunkPointer chunk;
+
+                    if (!parsed.Pop(chunk)) break;
+
+                    timing.wait_seconds += Seconds(wait_start);
+
+                    Clock::time_point busy_start = Clock::now();
+
+                    if (m_mask != 0) {
+                        GreeksColumns columns = chunk->greeks.Allocate(chunk->batch.Size(), m_mask);
+                        pricer.PriceAndGreeks(chunk->batch.View(), m_mask, columns);
+                    }
+
+                    timing.busy_seconds += Seconds(busy_start);
+
+                    wait_start = Clock::now();
+
+                    if (!priced.Push(std::move(chunk))) break;
+
+                    timing.wait_seconds += Seconds(wait_start);
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+
+            if (--pricing_left == 0) priced.Close();
+        });
+    }
+
+    // Writer stage
+    try {
+        std::map<size_t, ChunkPointer> early; // Chunks that overtook an earlier one
+        std::vector<char> buffer;
+        size_t next = 0;
+
+        Clock::time_point write_start = Clock::now();
+
+        if (m_output_format == CSV_FORMAT) {
+            std::string header;
+            FormatCsvHeader(m_mask, header);
+            out.write(header.data(), header.size());
+            stats.bytes_written += header.size();
+        }
+
+        while (true) {
+
+            Clock::time_point wait_start = Clock::now();
+
+            ChunkPointer chunk;
+
+            if (!priced.Pop(chunk)) break;
+
+            stats.write.wait_seconds += Seconds(wait_start);
+
+            early[chunk->sequence] = std::move(chunk);
+
+            for (auto found = early.find(next); found != early.end(); found = early.find(++next)) {
+
+                FormatChunk(*found->second, m_mask, m_output_format, buffer);
+
+                out.write(buffer.data(), buffer.size());
+
+                if (!out) throw std::runtime_error("failed to write results");
+
+                stats.bytes_written += buffer.size();
+                stats.contracts += found->second->batch.Size();
+                stats.chunks++;
+
+                early.erase(found);
+
+                char token;
+                window.Pop(token);
+            }
+        }
+
+        out.flush();
+
+        stats.write.busy_seconds = Seconds(write_start) - stats.write.wait_seconds;
+    } catch (...) {
+        fail(std::current_exception());
+    }
+
+    parser.join();
+    for (std::thread& pricer: pricers) pricer.join();
+
+    for (const StageStats& timing: pricing) {
+        stats.price.busy_seconds += timing.busy_seconds;
+        stats.price.wait_seconds += timing.wait_seconds;
+    }
+
+    if (error) std::rethrow_exception(error);
+
+    stats.seconds = Seconds(start);
+
+    return stats;
+}
+
+OptionBatch PricingPipeline::Load(std::istream& in) const {
+    /*
+     Parse a whole stream into one batch with the pipeline's parsers, e.g. to convert it to a column file
+     */
+
+    if (m_input_format == COLUMNAR_FORMAT) throw std::invalid_argument("columnar files are mapped, not streamed");
+
+    OptionBatch book;
+
+    ChunkSink append = [&book](ChunkPointer chunk) {
+
+        const OptionBatch& batch = chunk->batch;
+        size_t offset = book.Size();
+
+        book.Resize(offset + batch.Size());
+
+        std::copy(batch.S(), batch.S() + batch.Size(), book.S() + offset);
+        std::copy(batch.K(), batch.K() + batch.Size(), book.K() + offset);
+        std::copy(batch.T(), batch.T() + batch.Size(), book.T() + offset);
+        std::copy(batch.r(), batch.r() + batch.Size(), book.r() + offset);
+        std::copy(batch.s(), batch.s() + batch.Size(), book.s() + offset);
+        std::copy(batch.b(), batch.b() + batch.Size(), book.b() + offset);
+        std::copy(batch.CallOrPut(), batch.CallOrPut() + batch.Size(), book.CallOrPut() + offset);
+        std::copy(batch.UnderlyingType(), batch.UnderlyingType() + batch.Size(), book.UnderlyingType() + offset);
+        std::copy(batch.q(), batch.q() + batch.Size(), book.q() + offset);
+        std::copy(batch.R(), batch.R() + batch.Size(), book.R() + offset);
+
+        return true;
+    };
+
+    if (m_input_format == BINARY_FORMAT) ParseBinary(in, m_chunk_size, append);
+    else ParseCsv(in, m_chunk_size, append);
+
+    return book;
+}
+
+void PipelineStats::Print(std::ostream& out) const {
+    /*
+     Throughput and the time each stage spent working and waiting on its queues.
+     Pricing times are summed over the workers
+     */
+
+    double rate = seconds > 0 ? contracts / seconds : 0;
+    double megabytes = seconds > 0 ? bytes_read / seconds / (1 << 20) : 0;
+
+    char text[512];
+
+    snprintf(text, sizeof(text),
+             "contracts: %zu in %zu chunks, %.3f s\n"
+             "throughput: %.0f contracts/s, %.1f MB/s in, %zu bytes out\n"
+             "parse: busy %.3f s, waiting %.3f s\n"
+             "price: busy %.3f s, waiting %.3f s\n"
+             "write: busy %.3f s, waiting %.3f s\n",
+             contracts, chunks, seconds, rate, megabytes, bytes_written,
+             parse.busy_seconds, parse.wait_seconds,
+             price.busy_seconds, price.wait_seconds,
+             write.busy_seconds, write.wait_seconds);
+
+    out << text;
+}
@@ -0,0 +1,135 @@
+//
+//  File: PricingPipeline.hpp
+//  Project: ExactPricingModels
+//  Objective: Streaming parse, price and write stages for large contract files
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef PricingPipeline_hpp
+#define PricingPipeline_hpp
+
+#include <stdio.h>
+#include <cstdint>
+#include <iostream>
+#include "BatchPricer.hpp"
+
+enum RecordFormat{ CSV_FORMAT, BINARY_FORMAT, COLUMNAR_FORMAT }; // Encoding of contract and result streams. COLUMNAR_FORMAT files are mapped, see ColumnFile.hpp
+
+struct ContractRecord {
+    /*
+     Binary contract record, 64 bytes in native byte order. Carry cost is derived from the
+     underlying asset class as in OptionBatch::Add
+     */
+    double S; // Underlying asset price
+    double K; // Strike price
+    double T; // Time to maturity
+    double r; // Risk-free rate
+    double s; // Constant volatility
+    double q; // Dividend yield
+    double R; // Foreign risk-free rate
+    uint8_t call_or_put; // CALL (0) or PUT (1)
+    uint8_t underlying_type; // STOCK, DIVIDEND, FUTURES or CURRENCY
+    uint8_t reserved[6]; // Zero
+};
+
+static_assert(sizeof(ContractRecord) == 64, "ContractRecord must stay 64 bytes");
+
+struct StageStats {
+    double busy_seconds = 0; // Time spent doing the stage's own work, summed over its threads
+    double wait_seconds = 0; // Time blocked on the neighbouring queues, summed over its threads
+};
+
+struct PipelineStats {
+    size_t contracts = 0; // Contracts priced
+    size_t chunks = 0; // Batches that went through the pipeline
+    size_t bytes_read = 0; // Input size
+    size_t bytes_written = 0; // Output size
+    double seconds = 0; // Wall clock time of the whole run
+    StageStats parse; // Reader and parser
+    StageStats price; // Pricing workers
+    StageStats write; // Formatter and writer
+
+    void Print(std::ostream& out) const; // Human readable throughput and stage timings
+};
+
+class PricingPipeline {
+
+    // Attributes
+    enum RecordFormat m_input_format = CSV_FORMAT; // Contract encoding
+    enum RecordFormat m_output_format = CSV_FORMAT; // Result encoding
+    unsigned m_mask = GREEK_PRICE; // Outputs written per contract, GreekMask bits. 0 copies the contracts through unpriced
+    size_t m_chunk_size = BATCH_CHUNK; // Contracts per batch handed between stages
+    size_t m_queue_capacity = 4; // Batches buffered between two stages
+    size_t m_pricing_threads = 0; // Pricing workers, 0 for every hardware thread
+
+public:
+    /* CANONICAL HEADER START */
+    PricingPipeline(){} // Default constructor
+
+    virtual ~PricingPipeline(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    enum RecordFormat InputFormat() const {
+        return m_input_format;
+    }
+
+    enum RecordFormat OutputFormat() const {
+        return m_output_format;
+    }
+
+    unsigned Mask() const {
+        return m_mask;
+    }
+
+    size_t ChunkSize() const {
+        return m_chunk_size;
+    }
+
+    size_t QueueCapacity() const {
+        return m_queue_capacity;
+    }
+
+    size_t PricingThreads() const {
+        return m_pricing_threads;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void InputFormat(enum RecordFormat input_format) {
+        this->m_input_format = input_format;
+    }
+
+    void OutputFormat(enum RecordFormat output_format) {
+        this->m_output_format = output_format;
+    }
+
+    void Mask(unsigned mask) {
+        this->m_mask = mask & ALL_GREEKS;
+    }
+
+    void ChunkSize(size_t chunk_size) {
+        this->m_chunk_size = chunk_size > 0 ? chunk_size : 1;
+    }
+
+    void QueueCapacity(size_t queue_capacity) {
+        this->m_queue_capacity = queue_capacity > 0 ? queue_capacity : 1;
+    }
+
+    void PricingThreads(size_t pricing_threads) {
+        this->m_pricing_threads = pricing_threads;
+    }
+
+    /* SETTERS END */
+
+    PipelineStats Run(std::istream& in, std::ostream& out) const; // Price every contract of the input stream, results in input order
+
+    OptionBatch Load(std::istream& in) const; // Parse a whole CSV or binary stream into one batch, on the calling thread
+
+};
+
+#endif /* PricingPipeline_hpp */
@@ -0,0 +1,544 @@
+//
+//  File: PricingServer.cpp
+//  Project: ExactPricingModels
+//  Objective: Local pricing daemon coalescing concurrent requests into micro-batches
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "PricingServer.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SIGPIPE is disabled per socket with SO_NOSIGPIPE instead
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+const size_t SERVER_READ_SIZE = 65536; // Bytes read from a socket per recv call
+
+const size_t SERVER_OUTPUT_LIMIT = size_t(1) << 22; // Reply bytes pending or owed on a connection above which its requests are no longer read, and input read from it per poll round
+
+const size_t SERVER_OUTPUT_DROP = 4 * SERVER_OUTPUT_LIMIT; // Pending reply bytes above which a connection is dropped
+
+struct PricingServer::Connection {
+    int fd = -1; // Socket, owned by the I/O thread
+    std::vector<char> input; // Received bytes not yet parsed into requests. I/O thread only
+    std::mutex mutex; // Guards output, owed and closed, so replies never reach a closed or reused descriptor
+    std::vector<char> output; // Reply bytes the socket did not accept yet
+    size_t owed = 0; // Reply bytes of the queued requests, not written yet
+    bool closed = false; // The I/O thread closed the socket
+};
+
+struct PricingServer::Request {
+    std::shared_ptr<Connection> connection; // Where the reply goes
+    PricingFrame frame; // Request header
+    std::vector<ContractRecord> contracts; // Request body
+    Clock::time_point arrival; // When the last byte was read
+};
+
+static std::runtime_error SystemError(const std::string& what) {
+    return std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+static void NonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+static unsigned Outputs(unsigned mask) {
+    // Doubles per response row
+    unsigned count = 0;
+    for (unsigned bit = 0; bit < 7; bit++) count += (mask >> bit) & 1;
+    return count;
+}
+
+void ServerStats::Print(std::ostream& out) const {
+    char text[256];
+    snprintf(text, sizeof(text), "connections: %zu, requests: %zu (%zu rejected), contracts: %zu\nbatches: %zu, mean %.1f contracts, largest %zu\n",
+             connections, requests, rejected, contracts, batches, batches ? double(contracts) / batches : 0.0, largest_batch);
+    out << text;
+}
+
+PricingServer::PricingServer() : m_running(false) {
+    /*
+     Default constructor
+     */
+
+    if (pipe(m_wake_fd) != 0) throw SystemError("pipe");
+
+    NonBlocking(m_wake_fd[0]);
+    NonBlocking(m_wake_fd[1]);
+}
+
+PricingServer::~PricingServer() {
+    /*
+     Destructor
+     */
+
+    if (m_listen_fd >= 0) close(m_listen_fd);
+
+    if (!m_unix_path.empty()) unlink(m_unix_path.c_str());
+
+    close(m_wake_fd[0]);
+    close(m_wake_fd[1]);
+}
+
+ServerStats PricingServer::Stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void PricingServer::ListenUnix(const std::string& path) {
+    /*
+     Bind a Unix domain socket. A socket file left by a previous run is removed first; any other file is an error
+     input:
+        socket path
+     */
+
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("PricingServer::ListenUnix: invalid socket path " + path);
+    }
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat status;
+    if (lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) unlink(path.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) throw SystemError("socket");
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::runtime_error error = SystemError("bind " + path);
+        close(fd);
+        throw error;
+    }
+
+    m_unix_path = path;
+
+    Listen(fd);
+}
+
+void PricingServer::ListenTcp(uint16_t port) {
+    /*
+     Bind 127.0.0.1:port. The daemon is local only, quoting systems on other hosts go through their own gateway
+     input:
+        port
+     */
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw SystemError("socket");
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        std::runtime_error error = SystemError("bind 127.0.0.1:" + std::to_string(port));
+        close(fd);
+        throw error;
+    }
+
+    Listen(fd);
+}
+
+void PricingServer::Listen(int fd) {
+
+    if (listen(fd, SOMAXCONN) != 0) {
+        std::runtime_error error = SystemError("listen");
+        close(fd);
+        throw error;
+    }
+
+    NonBlocking(fd);
+
+    if (m_listen_fd >= 0) close(m_listen_fd);
+
+    m_listen_fd = fd;
+    m_running = true;
+}
+
+void PricingServer::Stop() {
+    /*
+     Only an atomic store and a write, so a SIGINT/SIGTERM handler may call it
+     */
+    m_running = false;
+    Wake();
+}
+
+void PricingServer::Wake() {
+    char byte = 0;
+    ssize_t written = write(m_wake_fd[1], &byte, 1);
+    (void)written; // A full pipe already holds a wake-up
+}
+
+void PricingServer::Send(Connection& connection, const char* data, size_t size, bool owed) {
+    /*
+     Write a reply straight to the socket when nothing is pending on it, so a reply normally leaves
+     from the batcher thread without a hop through the I/O thread. The rest is queued for the I/O thread.
+     A client that lets more than SERVER_OUTPUT_DROP bytes pile up is shut down; the I/O thread sees the
+     hang-up and closes the descriptor
+     */
+
+    std::lock_guard<std::mutex> lock(connection.mutex);
+
+    if (owed) connection.owed -= size;
+
+    if (connection.closed) return;
+
+    if (connection.output.empty()) {
+
+        ssize_t sent = send(connection.fd, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (sent < 0) {
+            // A broken connection is noticed and closed by the I/O thread on its next read
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return;
+            sent = 0;
+        }
+
+        data += sent;
+        size -= sent;
+
+        if (size == 0) return;
+    }
+
+    if (connection.output.size() + size > SERVER_OUTPUT_DROP) {
+        shutdown(connection.fd, SHUT_RDWR);
+        connection.closed = true;
+        connection.output.clear();
+        connection.output.shrink_to_fit();
+        return;
+    }
+
+    connection.output.insert(connection.output.end(), data, data + size);
+
+    Wake();
+}
+
+void PricingServer::Reject(Connection& connection, const PricingFrame& request, enum PricingStatus status) {
+
+    PricingFrame reply = {PRICING_MAGIC, request.mask, 0, static_cast<uint32_t>(status), request.id};
+
+    Send(connection, reinterpret_cast<const char*>(&reply), sizeof(reply));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.rejected++;
+}
+
+void PricingServer::Run() {
+    /*
+     I/O loop. Accepts connections, reads and validates requests, queues them for the batcher
+     thread and flushes replies the batcher could not finish. A connection with more than
+     SERVER_OUTPUT_LIMIT reply bytes pending or owed is not read until its client drains them, so the socket
+     buffers push back on a client that sends without reading. Returns after Stop(); requests still
+     queued are dropped and every connection is closed
+     */
+
+    if (m_listen_fd < 0) throw std::logic_error("PricingServer::Run: call ListenUnix or ListenTcp first");
+
+    std::thread batcher(&PricingServer::BatchLoop, this);
+
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> fds;
+    std::vector<char> buffer(SERVER_READ_SIZE);
+    bool tcp = m_unix_path.empty();
+
+    auto close_connection = [](Connection& connection) {
+        std::lock_guard<std::mutex> lock(connection.mutex);
+        close(connection.fd);
+        connection.closed = true;
+        connection.output.clear();
+    };
+
+    while (m_running) {
+
+        fds.clear();
+        fds.push_back({m_wake_fd[0], POLLIN, 0});
+        fds.push_back({m_listen_fd, POLLIN, 0});
+
+        for (const std::shared_ptr<Connection>& connection: connections) {
+            std::lock_guard<std::mutex> lock(connection->mutex);
+            short events = connection->output.size() + connection->owed < SERVER_OUTPUT_LIMIT ? POLLIN : 0;
+            if (!connection->output.empty()) events |= POLLOUT;
+            fds.push_back({connection->fd, events, 0});
+        }
+
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            throw SystemError("poll");
+        }
+
+        if (fds[0].revents & POLLIN) {
+            while (read(m_wake_fd[0], buffer.data(), buffer.size()) > 0) {}
+        }
+
+        if (!m_running) break;
+
+        if (fds[1].revents & POLLIN) {
+
+            int fd;
+
+            while ((fd = accept(m_listen_fd, nullptr, nullptr)) >= 0) {
+
+                NonBlocking(fd);
+
+                int one = 1;
+                if (tcp) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+                setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+                connections.push_back(std::make_shared<Connection>());
+                connections.back()->fd = fd;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stats.connections++;
+            }
+        }
+
+        for (size_t index = 0; index + 2 < fds.size(); index++) {
+
+            Connection& connection = *connections[index];
+            short events = fds[index + 2].revents;
+
+            if (events & POLLOUT) {
+
+                std::lock_guard<std::mutex> lock(connection.mutex);
+
+                ssize_t sent = send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+
+                if (sent > 0) connection.output.erase(connection.output.begin(), connection.output.begin() + sent);
+            }
+
+            if (!(events & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            bool open = true;
+
+            while (open) {
+
+                ssize_t received = recv(connection.fd, buffer.data(), buffer.size(), 0);
+
+                if (received > 0) {
+                    connection.input.insert(connection.input.end(), buffer.data(), buffer.data() + received);
+                    if (static_cast<size_t>(received) < buffer.size() || connection.input.size() >= SERVER_OUTPUT_LIMIT) break;
+                } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                    break;
+                } else {
+                    open = false;
+                }
+            }
+
+            // Cut complete requests out of the input
+            size_t consumed = 0;
+
+            while (open && connection.input.size() - consumed >= sizeof(PricingFrame)) {
+
+                PricingFrame frame;
+                std::memcpy(&frame, connection.input.data() + consumed, sizeof(frame));
+
+                if (frame.magic != PRICING_MAGIC || frame.count > PRICING_MAX_CONTRACTS) {
+                    open = false;
+                    break;
+                }
+
+                size_t size = sizeof(PricingFrame) + size_t(frame.count) * sizeof(ContractRecord);
+
+                if (connection.input.size() - consumed < size) break;
+
+                std::unique_ptr<Request> request(new Request());
+                request->connection = connections[index];
+                request->frame = frame;
+                request->contracts.resize(frame.count);
+                request->arrival = Clock::now();
+
+                std::memcpy(request->contracts.data(), connection.input.data() + consumed + sizeof(PricingFrame), frame.count * sizeof(ContractRecord));
+
+                consumed += size;
+
+                bool valid_types = true;
+
+                for (const ContractRecord& record: request->contracts) {
+                    if (record.call_or_put > PUT || record.underlying_type > CURRENCY) valid_types = false;
+                }
+
+                if (frame.mask == 0 || (frame.mask & ~unsigned(ALL_GREEKS))) {
+                    Reject(connection, frame, PRICING_BAD_MASK);
+                } else if (!valid_types) {
+                    Reject(connection, frame, PRICING_BAD_CONTRACT);
+                } else {
+                    {
+                        std::lock_guard<std::mutex> lock(connection.mutex);
+                        connection.owed += sizeof(PricingFrame) + size_t(frame.count) * Outputs(frame.mask) * sizeof(double);
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_queued_contracts += frame.count;
+                        m_requests.push_back(std::move(request));
+                    }
+                    m_queued.notify_one();
+                }
+            }
+
+            connection.input.erase(connection.input.begin(), connection.input.begin() + consumed);
+
+            if (!open) close_connection(connection);
+        }
+
+        // Forget closed connections. Queued requests keep theirs alive until their batch is done
+        size_t kept = 0;
+
+        for (size_t index = 0; index < connections.size(); index++) {
+            if (!connections[index]->closed) connections[kept++] = connections[index];
+        }
+
+        connections.resize(kept);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+
+    m_queued.notify_all();
+    batcher.join();
+
+    m_requests.clear();
+    m_queued_contracts = 0;
+
+    for (const std::shared_ptr<Connection>& connection: connections) close_connection(*connection);
+}
+
+void PricingServer::BatchLoop() {
+    /*
+     Batcher thread. Waits for a request, then until MaxWait() microseconds after its arrival or until
+     MaxBatch() contracts are queued, and takes whole requests in arrival order up to MaxBatch()
+     contracts (a larger single request is taken alone). The pricing buffers are reused
+     */
+
+    std::deque<std::unique_ptr<Request>> batch;
+    OptionBatch contracts;
+    GreeksBatch greeks;
+
+    while (true) {
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_queued.wait(lock, [this]{ return !m_running || !m_requests.empty(); });
+
+        if (!m_running) return;
+
+        Clock::time_point deadline = m_requests.front()->arrival + std::chrono::microseconds(m_max_wait);
+
+        m_queued.wait_until(lock, deadline, [this]{ return !m_running || m_queued_contracts >= m_max_batch; });
+
+        if (!m_running) return;
+
+        size_t taken = 0;
+
+        while (!m_requests.empty() && (batch.empty() || taken + m_requests.front()->frame.count <= m_max_batch)) {
+            taken += m_requests.front()->frame.count;
+            batch.push_back(std::move(m_requests.front()));
+            m_requests.pop_front();
+        }
+
+        m_queued_contracts -= taken;
+
+        m_stats.batches++;
+        m_stats.requests += batch.size();
+        m_stats.contracts += taken;
+        if (taken > m_stats.largest_batch) m_stats.largest_batch = taken;
+
+        lock.unlock();
+
+        PriceBatch(batch, contracts, greeks);
+
+        batch.clear();
+    }
+}
+
+void PricingServer::PriceBatch(std::deque<std::unique_ptr<Request>>& batch, OptionBatch& contracts, GreeksBatch& greeks) {
+    /*
+     Price the contracts of every request in one kernel call, computing the union of the requested
+     outputs, then send each request the rows and outputs it asked for
+     */
+
+    unsigned mask = 0;
+    size_t size = 0;
+
+    for (const std::unique_ptr<Request>& request: batch) {
+        mask |= request->frame.mask;
+        size += request->frame.count;
+    }
+
+    contracts.Clear();
+    contracts.Reserve(size);
+
+    for (const std::unique_ptr<Request>& request: batch) {
+        for (const ContractRecord& record: request->contracts) {
+            contracts.Add(record.S, record.K, record.T, record.r, record.s,
+                          static_cast<enum CallOrPut>(record.call_or_put),
+                          static_cast<enum UnderlyingType>(record.underlying_type),
+                          record.q, record.R);
+        }
+    }
+
+    GreeksColumns columns = greeks.Allocate(size, mask);
+
+    m_pricer.PriceAndGreeks(contracts.View(), mask, columns);
+
+    const double* outputs[7] = {columns.price, columns.delta, columns.gamma, columns.vega, columns.theta, columns.rho, columns.carry_rho};
+
+    std::vector<char> reply;
+    size_t offset = 0;
+
+    for (const std::unique_ptr<Request>& request: batch) {
+
+        const PricingFrame& frame = request->frame;
+        unsigned width = Outputs(frame.mask);
+
+        reply.resize(sizeof(PricingFrame) + size_t(frame.count) * width * sizeof(double));
+
+        PricingFrame header = {PRICING_MAGIC, frame.mask, frame.count, PRICING_OK, frame.id};
+        std::memcpy(reply.data(), &header, sizeof(header));
+
+        char* out = reply.data() + sizeof(PricingFrame);
+
+        for (size_t index = offset; index < offset + frame.count; index++) {
+            for (unsigned bit = 0; bit < 7; bit++) {
+                if (frame.mask & (1u << bit)) {
+                    std::memcpy(out, outputs[bit] + index, sizeof(double));
+                    out += sizeof(double);
+                }
+            }
+        }
+
+        offset += frame.count;
+
+        Send(*request->connection, reply.data(), reply.size(), true);
+    }
+}
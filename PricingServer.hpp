@@ -0,0 +1,150 @@
+//
+//  File: PricingServer.hpp
+//  Project: ExactPricingModels
+//  Objective: Local pricing daemon coalescing concurrent requests into micro-batches
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef PricingServer_hpp
+#define PricingServer_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "PricingPipeline.hpp"
+
+const uint32_t PRICING_MAGIC = 0x31435250; // "PRC1" in little-endian byte order, first field of every frame
+
+const uint32_t PRICING_MAX_CONTRACTS = 65536; // Contracts per request. Larger requests close the connection
+
+enum PricingStatus{ PRICING_OK, PRICING_BAD_CONTRACT, PRICING_BAD_MASK }; // Status of a response
+
+struct PricingFrame {
+    /*
+     Header of every request and response, 24 bytes in native byte order.
+     A request is followed by `count` ContractRecords; a response to a request with status
+     PRICING_OK by `count` rows of popcount(mask) doubles, outputs in GreekMask bit order
+     (price, delta, gamma, vega, theta, rho, carry_rho), the layout of the pipeline's binary results.
+     Responses echo the request id and may come back in any order
+     */
+    uint32_t magic; // PRICING_MAGIC
+    uint32_t mask; // GreekMask bits requested
+    uint32_t count; // Contracts in the request, rows in the response (0 on error)
+    uint32_t status; // PricingStatus in responses, 0 in requests
+    uint64_t id; // Chosen by the client, echoed in the response
+};
+
+static_assert(sizeof(PricingFrame) == 24, "PricingFrame must stay 24 bytes");
+
+struct ServerStats {
+    size_t connections = 0; // Connections accepted
+    size_t requests = 0; // Requests priced
+    size_t rejected = 0; // Requests answered with an error status
+    size_t contracts = 0; // Contracts priced
+    size_t batches = 0; // Kernel calls
+    size_t largest_batch = 0; // Most contracts priced in one kernel call
+
+    void Print(std::ostream& out) const; // Human readable counters and mean batch size
+};
+
+class PricingServer {
+    /*
+     Listens on a Unix domain socket or on localhost TCP. One I/O thread reads the requests of every
+     connection with poll(); complete requests join a queue. A batcher thread waits for the first
+     queued request, then for up to MaxWait() microseconds or until MaxBatch() contracts are queued,
+     prices every request it took in one BatchPricer call and sends each reply as soon as its batch
+     is done. Replies that do not fit in the socket buffer are finished by the I/O thread. A connection
+     whose client does not read its replies stops being read once about 4 MB are pending, and is
+     dropped at 16 MB
+     */
+
+    struct Connection; // One client socket and its buffers
+    struct Request; // One complete request waiting for a batch
+
+    // Attributes
+    int m_listen_fd = -1; // Listening socket
+    std::string m_unix_path; // Socket file to remove on shutdown, empty for TCP
+    int m_wake_fd[2] = {-1, -1}; // Pipe waking the I/O thread for pending writes and Stop()
+    unsigned m_max_wait = 50; // Microseconds a request may wait for others to join its batch
+    size_t m_max_batch = 4096; // Contracts per kernel call
+    BatchPricer m_pricer; // Thread pool used for large batches
+    std::atomic<bool> m_running; // Cleared by Stop()
+
+    std::mutex m_mutex; // Guards the request queue and the statistics
+    std::condition_variable m_queued; // Signalled when a request is queued or on Stop()
+    std::deque<std::unique_ptr<Request>> m_requests; // Requests waiting for a batch, oldest first
+    size_t m_queued_contracts = 0; // Contracts in m_requests
+    ServerStats m_stats; // Counters
+
+public:
+    /* CANONICAL HEADER START */
+    PricingServer(); // Default constructor
+
+    PricingServer(const PricingServer& other_server) = delete; // Not copyable
+
+    virtual ~PricingServer(); // Destructor. Closes the sockets
+
+    PricingServer& operator = (const PricingServer& other_server) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    unsigned MaxWait() const {
+        return m_max_wait;
+    }
+
+    size_t MaxBatch() const {
+        return m_max_batch;
+    }
+
+    ServerStats Stats(); // Copy of the counters
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void MaxWait(unsigned microseconds) {
+        this->m_max_wait = microseconds;
+    }
+
+    void MaxBatch(size_t contracts) {
+        this->m_max_batch = contracts > 0 ? contracts : 1;
+    }
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    /* SETTERS END */
+
+    void ListenUnix(const std::string& path); // Bind a Unix domain socket, replacing a stale socket file. Throws std::runtime_error
+
+    void ListenTcp(uint16_t port); // Bind 127.0.0.1:port. Throws std::runtime_error
+
+    void Run(); // Serve until Stop(), on the calling thread plus the batcher thread
+
+    void Stop(); // Ask Run() to return. Async-signal-safe
+
+    // Helper functions
+private:
+    void Listen(int fd); // Take ownership of a bound socket and start listening
+
+    void BatchLoop(); // Batcher thread body
+
+    void PriceBatch(std::deque<std::unique_ptr<Request>>& batch, OptionBatch& contracts, GreeksBatch& greeks); // Price taken requests and send their replies
+
+    void Reject(Connection& connection, const PricingFrame& request, enum PricingStatus status); // Reply with an error status
+
+    void Send(Connection& connection, const char* data, size_t size, bool owed = false); // Queue a reply and write what the socket accepts. owed for the reply of a queued request
+
+    void Wake(); // Interrupt the I/O thread's poll()
+
+};
+
+#endif /* PricingServer_hpp */
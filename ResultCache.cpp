@@ -0,0 +1,311 @@
+//
+//  File: ResultCache.cpp
+//  Project: ExactPricingModels
+//  Objective: Bounded, sharded concurrent cache of prices and Greeks keyed on quantized option inputs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ResultCache.hpp"
+#include "Metrics.hpp"
+#include "cmath"
+
+#include <cstring>
+
+static const size_t RESULT_KEY_WORDS = 7; // S, K, T, r, sigma, b, then call or put and underlying class
+
+static const size_t RESULT_VALUE_WORDS = 7; // Fields of Greeks, in declaration order
+
+struct alignas(64) ResultCache::Set {
+    std::atomic<uint64_t> tag[RESULT_CACHE_WAYS]{}; // Hash of each way's key, 0 for an empty way. One cache line, so a lookup reads a single slot
+};
+
+struct ResultCache::Slot {
+    std::atomic<uint64_t> version{0}; // Even when stable, odd while a writer updates the slot
+    std::atomic<uint64_t> key[RESULT_KEY_WORDS]{}; // Quantized inputs
+    std::atomic<uint64_t> mask{0}; // GreekMask of the stored outputs
+    std::atomic<double> value[RESULT_VALUE_WORDS]{}; // Stored outputs
+    std::atomic<unsigned char> referenced{0}; // CLOCK reference bit, set by hits
+};
+
+struct alignas(64) ResultCache::Shard {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT; // Held by writers of the shard's sets
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> insertions{0};
+    std::atomic<uint64_t> evictions{0};
+};
+
+static size_t PowerOfTwo(size_t n) {
+    size_t power = 1;
+    while (power < n) power <<= 1;
+    return power;
+}
+
+static uint64_t Hash(const uint64_t* key) {
+    /*
+     Key words folded pairwise with independent multiplies, then one murmur finalizer, so the
+     dependency chain stays short. Never 0, which marks an empty slot
+     */
+    uint64_t h = (key[0] ^ key[6]) * 0x9E3779B97F4A7C15ULL
+               ^ (key[1] + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL
+               ^ (key[2] + 0x165667B19E3779F9ULL) * 0x94D049BB133111EBULL
+               ^ (key[3] + 0x27D4EB2F165667C5ULL) * 0xBF58476D1CE4E5B9ULL
+               ^ (key[4] + 0x85EBCA77C2B2AE63ULL) * 0xFF51AFD7ED558CCDULL
+               ^ (key[5] + 0xC4CEB9FE1A85EC53ULL) * 0xD6E8FEB86659FD93ULL;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return h | 1;
+}
+
+static void ToValues(const Greeks& greeks, double* values) {
+    values[0] = greeks.price;
+    values[1] = greeks.delta;
+    values[2] = greeks.gamma;
+    values[3] = greeks.vega;
+    values[4] = greeks.theta;
+    values[5] = greeks.rho;
+    values[6] = greeks.carry_rho;
+}
+
+static Greeks FromValues(const double* values, unsigned mask) {
+    // Outputs outside mask are left at zero, as from the fused kernels
+    Greeks greeks;
+    if (mask & GREEK_PRICE) greeks.price = values[0];
+    if (mask & GREEK_DELTA) greeks.delta = values[1];
+    if (mask & GREEK_GAMMA) greeks.gamma = values[2];
+    if (mask & GREEK_VEGA) greeks.vega = values[3];
+    if (mask & GREEK_THETA) greeks.theta = values[4];
+    if (mask & GREEK_RHO) greeks.rho = values[5];
+    if (mask & GREEK_CARRY_RHO) greeks.carry_rho = values[6];
+    return greeks;
+}
+
+ResultCache::ResultCache(size_t capacity, double tolerance, size_t shards) :
+m_tolerance(tolerance) {
+    /*
+     Parameter constructor
+     input:
+        number of entries, relative tolerance of the inputs (0 for exact keys), number of writer shards
+     */
+
+    m_sets = PowerOfTwo((capacity + RESULT_CACHE_WAYS - 1) / RESULT_CACHE_WAYS);
+    m_shard_count = PowerOfTwo(shards ? shards : 1);
+    if (m_shard_count > m_sets) m_shard_count = m_sets;
+
+    m_tags.reset(new Set[m_sets]);
+    m_slots.reset(new Slot[m_sets * RESULT_CACHE_WAYS]);
+    m_shards.reset(new Shard[m_shard_count]);
+    m_hands.reset(new unsigned char[m_sets]());
+
+    // Clearing d low mantissa bits groups inputs within a relative 2^(d - 52)
+    if (tolerance > 0) {
+        double bits = std::floor(52 + std::log2(tolerance));
+        size_t dropped = bits < 0 ? 0 : bits > 52 ? 52 : static_cast<size_t>(bits);
+        m_quantum_mask = dropped ? ~((1ULL << dropped) - 1) : ~0ULL;
+    }
+}
+
+ResultCache::~ResultCache() {
+    /*
+     Destructor
+     */
+}
+
+void ResultCache::Key(const Option& option, uint64_t* key) const {
+    /*
+     Quantized inputs of an option. The last word holds the option type and underlying class
+     */
+    double inputs[6] = { option.S(), option.K(), option.T(), option.r(), option.s(), option.b() };
+
+    for (size_t i = 0; i < 6; i++) {
+        memcpy(&key[i], &inputs[i], sizeof(double));
+        key[i] &= m_quantum_mask;
+    }
+
+    key[6] = static_cast<uint64_t>(option.CallOrPut()) | (static_cast<uint64_t>(option.UnderlyingType()) << 1);
+}
+
+bool ResultCache::Find(const Option& option, unsigned mask, Greeks& greeks) {
+    /*
+     Look an option up without locking. A slot is read between two loads of its version and
+     ignored when a writer was active or finished in between
+     input:
+        option, requested outputs
+        output greeks, written on a hit with the requested outputs only
+     output:
+        true on a hit
+     */
+
+    uint64_t key[RESULT_KEY_WORDS];
+    Key(option, key);
+
+    uint64_t tag = Hash(key);
+    size_t set = (tag >> 1) & (m_sets - 1); // Bit 0 is always set
+    std::atomic<uint64_t>* tags = m_tags[set].tag;
+    Slot* slots = m_slots.get() + set * RESULT_CACHE_WAYS;
+    Shard& shard = m_shards[set & (m_shard_count - 1)];
+
+    for (size_t way = 0; way < RESULT_CACHE_WAYS; way++) {
+
+        if (tags[way].load(std::memory_order_relaxed) != tag) continue;
+
+        Slot& slot = slots[way];
+
+        uint64_t before = slot.version.load(std::memory_order_acquire);
+        if (before & 1) continue;
+
+        bool same = true;
+        for (size_t i = 0; i < RESULT_KEY_WORDS; i++) same &= slot.key[i].load(std::memory_order_relaxed) == key[i];
+
+        uint64_t stored = slot.mask.load(std::memory_order_relaxed);
+
+        double values[RESULT_VALUE_WORDS];
+        for (size_t i = 0; i < RESULT_VALUE_WORDS; i++) values[i] = slot.value[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.version.load(std::memory_order_relaxed) != before || !same) continue;
+
+        if ((stored & mask) != mask) break;
+
+        if (!slot.referenced.load(std::memory_order_relaxed)) slot.referenced.store(1, std::memory_order_relaxed);
+
+        greeks = FromValues(values, mask);
+
+        shard.hits.fetch_add(1, std::memory_order_relaxed);
+        METRIC_COUNT(COUNTER_RESULT_CACHE_HIT);
+        return true;
+    }
+
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    METRIC_COUNT(COUNTER_RESULT_CACHE_MISS);
+    return false;
+}
+
+void ResultCache::Insert(const Option& option, unsigned mask, const Greeks& greeks) {
+    /*
+     Store outputs under the shard lock. An entry already holding the key keeps the outputs the
+     new ones do not cover; otherwise an empty slot of the set is used, or the CLOCK victim
+     input:
+        option, outputs present in greeks, greeks
+     */
+
+    uint64_t key[RESULT_KEY_WORDS];
+    Key(option, key);
+
+    uint64_t tag = Hash(key);
+    size_t set = (tag >> 1) & (m_sets - 1); // Bit 0 is always set
+    std::atomic<uint64_t>* tags = m_tags[set].tag;
+    Slot* slots = m_slots.get() + set * RESULT_CACHE_WAYS;
+    Shard& shard = m_shards[set & (m_shard_count - 1)];
+
+    double values[RESULT_VALUE_WORDS];
+    ToValues(greeks, values);
+
+    while (shard.lock.test_and_set(std::memory_order_acquire)) {
+        while (shard.lock.test(std::memory_order_relaxed)) {}
+    }
+
+    size_t victim = RESULT_CACHE_WAYS;
+
+    for (size_t way = 0; way < RESULT_CACHE_WAYS && victim == RESULT_CACHE_WAYS; way++) {
+        if (tags[way].load(std::memory_order_relaxed) != tag) continue;
+        bool same = true;
+        for (size_t i = 0; i < RESULT_KEY_WORDS; i++) same &= slots[way].key[i].load(std::memory_order_relaxed) == key[i];
+        if (same) victim = way;
+    }
+
+    if (victim < RESULT_CACHE_WAYS) {
+        // Same key: keep the stored outputs the new record lacks
+        uint64_t stored = slots[victim].mask.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < RESULT_VALUE_WORDS; i++) {
+            if ((stored & (1u << i)) && !(mask & (1u << i))) values[i] = slots[victim].value[i].load(std::memory_order_relaxed);
+        }
+        mask |= static_cast<unsigned>(stored);
+    } else {
+        for (size_t way = 0; way < RESULT_CACHE_WAYS && victim == RESULT_CACHE_WAYS; way++) {
+            if (tags[way].load(std::memory_order_relaxed) == 0) victim = way;
+        }
+    }
+
+    if (victim == RESULT_CACHE_WAYS) {
+        size_t hand = m_hands[set];
+        while (slots[hand].referenced.load(std::memory_order_relaxed)) {
+            slots[hand].referenced.store(0, std::memory_order_relaxed);
+            hand = (hand + 1) % RESULT_CACHE_WAYS;
+        }
+        victim = hand;
+        m_hands[set] = static_cast<unsigned char>((hand + 1) % RESULT_CACHE_WAYS);
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Slot& slot = slots[victim];
+
+    uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < RESULT_KEY_WORDS; i++) slot.key[i].store(key[i], std::memory_order_relaxed);
+    slot.mask.store(mask, std::memory_order_relaxed);
+    for (size_t i = 0; i < RESULT_VALUE_WORDS; i++) slot.value[i].store(values[i], std::memory_order_relaxed);
+
+    slot.version.store(version + 2, std::memory_order_release);
+
+    // The tag only filters; readers still compare the key under the version
+    tags[victim].store(tag, std::memory_order_relaxed);
+
+    shard.insertions.fetch_add(1, std::memory_order_relaxed);
+
+    shard.lock.clear(std::memory_order_release);
+}
+
+void ResultCache::Clear() {
+    /*
+     Drop every entry. Safe while other threads look up or insert
+     */
+
+    for (size_t set = 0; set < m_sets; set++) {
+
+        Shard& shard = m_shards[set & (m_shard_count - 1)];
+
+        while (shard.lock.test_and_set(std::memory_order_acquire)) {
+            while (shard.lock.test(std::memory_order_relaxed)) {}
+        }
+
+        for (size_t way = 0; way < RESULT_CACHE_WAYS; way++) {
+            if (m_tags[set].tag[way].load(std::memory_order_relaxed) == 0) continue;
+            Slot& slot = m_slots[set * RESULT_CACHE_WAYS + way];
+            uint64_t version = slot.version.load(std::memory_order_relaxed);
+            slot.version.store(version + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_tags[set].tag[way].store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < RESULT_KEY_WORDS; i++) slot.key[i].store(0, std::memory_order_relaxed);
+            slot.referenced.store(0, std::memory_order_relaxed);
+            slot.version.store(version + 2, std::memory_order_release);
+        }
+
+        shard.lock.clear(std::memory_order_release);
+    }
+}
+
+ResultCacheStats ResultCache::Stats() const {
+    ResultCacheStats stats;
+    for (size_t index = 0; index < m_shard_count; index++) {
+        stats.hits += m_shards[index].hits.load(std::memory_order_relaxed);
+        stats.misses += m_shards[index].misses.load(std::memory_order_relaxed);
+        stats.insertions += m_shards[index].insertions.load(std::memory_order_relaxed);
+        stats.evictions += m_shards[index].evictions.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void ResultCache::ResetStats() {
+    for (size_t index = 0; index < m_shard_count; index++) {
+        m_shards[index].hits.store(0, std::memory_order_relaxed);
+        m_shards[index].misses.store(0, std::memory_order_relaxed);
+        m_shards[index].insertions.store(0, std::memory_order_relaxed);
+        m_shards[index].evictions.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,111 @@
+//
+//  File: ResultCache.hpp
+//  Project: ExactPricingModels
+//  Objective: Bounded, sharded concurrent cache of prices and Greeks keyed on quantized option inputs
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ResultCache_hpp
+#define ResultCache_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "Option.hpp"
+#include "Greeks.hpp"
+
+const size_t RESULT_CACHE_WAYS = 8; // Slots per set; a key can only live in the set its hash selects
+
+const unsigned RESULT_CACHE_MASK = GREEK_PRICE | GREEK_DELTA | GREEK_GAMMA; // Outputs computed on every miss, so later Price, Delta and Gamma calls hit
+
+struct ResultCacheStats {
+    /*
+     Totals since construction or the last ResetStats()
+     */
+    uint64_t hits = 0; // Lookups answered from the cache
+    uint64_t misses = 0; // Lookups that found no entry with the requested outputs
+    uint64_t insertions = 0; // Entries written
+    uint64_t evictions = 0; // Entries replaced by a different key
+
+    double HitRate() const {
+        return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+};
+
+class ResultCache {
+    /*
+     Maps (S, K, T, r, sigma, b, call or put, underlying class) to a Greeks record. Inputs are
+     quantized by clearing the low mantissa bits of each double, so inputs within a relative
+     tolerance share an entry (tolerance 0 keys on exact bits). The key is read from the option
+     at every call, so an Option setter that changes an input moves the option to another entry
+     and results are never stale. One cache should serve one model, e.g. EuropeanOption::Cache.
+
+     The table is set-associative: the key's hash selects a set of RESULT_CACHE_WAYS slots, and a
+     full set evicts with the CLOCK policy (a hit sets a slot's reference bit, the hand clears bits
+     until it finds a slot without one). Lookups take no lock: each slot is a seqlock, read
+     optimistically and discarded if a writer changed it meanwhile. Writers lock only the shard
+     owning the set, so different shards are written concurrently
+     */
+
+    struct Set; // Tags of one set's ways
+
+    struct Slot; // Key, value, version and reference bit of one entry
+
+    struct Shard; // Writer lock and statistics of a group of sets
+
+    // Attributes
+    std::unique_ptr<Set[]> m_tags; // Tag line of each set
+    std::unique_ptr<Slot[]> m_slots; // sets * RESULT_CACHE_WAYS slots, set-major
+    std::unique_ptr<Shard[]> m_shards; // Shards, a power of two
+    std::unique_ptr<unsigned char[]> m_hands; // CLOCK hand of each set, written under the shard lock
+    size_t m_sets = 0; // Number of sets, a power of two
+    size_t m_shard_count = 0; // Number of shards, a power of two no larger than m_sets
+    double m_tolerance = 0; // Requested relative tolerance
+    uint64_t m_quantum_mask = ~0ULL; // Bits of each input kept in the key
+
+public:
+    /* CANONICAL HEADER START */
+    ResultCache(size_t capacity = 65536, double tolerance = 0, size_t shards = 64); // Parameter constructor. Capacity and shards are rounded up to powers of two
+
+    ResultCache(const ResultCache& other_cache) = delete; // Not copyable
+
+    virtual ~ResultCache(); // Destructor
+
+    ResultCache& operator = (const ResultCache& other_cache) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Capacity() const {
+        return m_sets * RESULT_CACHE_WAYS;
+    }
+
+    size_t Shards() const {
+        return m_shard_count;
+    }
+
+    double Tolerance() const {
+        return m_tolerance;
+    }
+
+    ResultCacheStats Stats() const; // Sum of every shard's statistics
+
+    /* GETTERS END */
+
+    bool Find(const Option& option, unsigned mask, Greeks& greeks); // Cached outputs of an option, true when an entry has every output of mask
+
+    void Insert(const Option& option, unsigned mask, const Greeks& greeks); // Store the outputs of mask for an option, replacing its previous entry
+
+    void Clear(); // Drop every entry
+
+    void ResetStats(); // Zero the statistics
+
+    // Helper functions
+private:
+    void Key(const Option& option, uint64_t* key) const; // Quantized inputs
+
+};
+
+#endif /* ResultCache_hpp */
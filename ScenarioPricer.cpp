@@ -0,0 +1,248 @@
+//
+//  File: ScenarioPricer.cpp
+//  Project: ExactPricingModels
+//  Objective: Portfolio value under joint spot, volatility and rate scenarios, with VaR and expected shortfall
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ScenarioPricer.hpp"
+#include "Metrics.hpp"
+#include "cmath"
+
+#include <algorithm>
+#include <stdexcept>
+
+static void AppendShocks(vector<double>& column, const vector<double>& shocks, size_t scenarios, size_t underlyings) {
+    /*
+     Append one scenario to a shock column. A column that was empty so far is filled with zeros
+     for the earlier scenarios, and an omitted shock appends zeros to a column already in use
+     */
+
+    if (shocks.empty()) {
+        if (!column.empty()) column.resize(column.size() + underlyings, 0.0);
+        return;
+    }
+
+    if (shocks.size() != underlyings) {
+        throw std::invalid_argument("ScenarioSet::Add: expected one shock per underlying");
+    }
+
+    if (column.empty()) column.resize(scenarios * underlyings, 0.0);
+
+    column.insert(column.end(), shocks.begin(), shocks.end());
+}
+
+void ScenarioSet::Add(const vector<double>& spot_shocks, const vector<double>& vol_shocks, const vector<double>& rate_shocks) {
+    /*
+     Append one scenario
+     input:
+        spot, volatility and rate shocks, each empty or with one shock per underlying
+     */
+
+    AppendShocks(spot, spot_shocks, scenarios, underlyings);
+    AppendShocks(vol, vol_shocks, scenarios, underlyings);
+    AppendShocks(rate, rate_shocks, scenarios, underlyings);
+
+    scenarios++;
+}
+
+size_t ScenarioPricer::Add(const EuropeanOption& option, size_t underlying, double quantity) {
+    /*
+     Add a position
+     input:
+        contract, index of its underlying, signed quantity
+     output:
+        index of the position
+     */
+
+    m_book.Add(option);
+    m_underlying.push_back(underlying);
+    m_quantity.push_back(quantity);
+
+    if (underlying >= m_underlyings) m_underlyings = underlying + 1;
+
+    return m_book.Size() - 1;
+}
+
+void ScenarioPricer::Clear() {
+    m_book.Clear();
+    m_underlying.clear();
+    m_quantity.clear();
+    m_underlyings = 0;
+}
+
+void ScenarioPricer::Validate(const ScenarioSet& scenarios) const {
+    /*
+     Check the shapes of the shock columns and that no scenario takes a spot or a volatility
+     of the book to zero or below
+     */
+
+    if (Size() > 0 && scenarios.underlyings < m_underlyings) {
+        throw std::invalid_argument("ScenarioPricer::Run: the scenarios do not cover every underlying of the book");
+    }
+
+    size_t cells = scenarios.scenarios * scenarios.underlyings;
+
+    for (const vector<double>* column: {&scenarios.spot, &scenarios.vol, &scenarios.rate}) {
+        if (!column->empty() && column->size() != cells) {
+            throw std::invalid_argument("ScenarioPricer::Run: shock columns must be empty or hold scenarios x underlyings values");
+        }
+    }
+
+    for (double shock: scenarios.spot) {
+        if (!(shock > -1)) throw std::invalid_argument("ScenarioPricer::Run: spot shocks must be above -1");
+    }
+
+    if (scenarios.vol.empty() || Size() == 0) return;
+
+    // Lowest volatility of each underlying, every vol shock must keep it positive
+    vector<double> lowest(m_underlyings, INFINITY);
+
+    for (size_t index = 0; index < Size(); index++) {
+        lowest[m_underlying[index]] = std::min(lowest[m_underlying[index]], m_book.s()[index]);
+    }
+
+    for (size_t scenario = 0; scenario < scenarios.scenarios; scenario++) {
+        const double* shocks = scenarios.vol.data() + scenario * scenarios.underlyings;
+        for (size_t underlying = 0; underlying < m_underlyings; underlying++) {
+            if (!(lowest[underlying] + shocks[underlying] > 0)) {
+                throw std::invalid_argument("ScenarioPricer::Run: shocked volatilities must stay positive");
+            }
+        }
+    }
+}
+
+ScenarioRiskResult ScenarioPricer::Run(const ScenarioSet& scenarios, double confidence) const {
+    /*
+     Value the book under every scenario. Column 0 of the partial sums is the unshocked book, so
+     the base value goes through the same blocks and summation order as the scenarios and a
+     scenario without shocks has exactly zero P&L. Tasks cover one chunk of contracts and one
+     tile of columns; inside a task each block of BATCH_BLOCK contracts is shocked, priced and
+     summed for every column of the tile before the next block is read
+     input:
+        scenario set covering every underlying of the book, confidence level in (0, 1)
+     output:
+        portfolio values, P&L, VaR and expected shortfall
+     */
+
+    if (!(confidence > 0 && confidence < 1)) {
+        throw std::invalid_argument("ScenarioPricer::Run: confidence must be in (0, 1)");
+    }
+
+    Validate(scenarios);
+
+    METRIC_SCOPE(TIMER_SCENARIO, Size() * scenarios.scenarios);
+
+    size_t size = Size();
+    size_t columns = scenarios.scenarios + 1;
+    size_t chunk = m_pricer.ChunkSize();
+    size_t chunks = (size + chunk - 1) / chunk;
+    size_t tiles = (columns + SCENARIO_TILE - 1) / SCENARIO_TILE;
+    size_t underlyings = scenarios.underlyings;
+
+    vector<double> partial(chunks * columns, 0.0);
+
+    OptionBatchView book = m_book.View();
+
+    // Blocks are priced one at a time inside the tasks, never split further
+    BatchPricer block_pricer(nullptr, BATCH_BLOCK, m_pricer.Precision());
+
+    auto body = [&](size_t begin, size_t end) {
+
+        alignas(COLUMN_ALIGNMENT) double S[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double r[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double s[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double b[BATCH_BLOCK];
+        alignas(COLUMN_ALIGNMENT) double prices[BATCH_BLOCK];
+
+        for (size_t task = begin; task < end; task++) {
+
+            size_t first = (task / tiles) * chunk;
+            size_t last = std::min(size, first + chunk);
+            size_t first_column = (task % tiles) * SCENARIO_TILE;
+            size_t last_column = std::min(columns, first_column + SCENARIO_TILE);
+
+            double* sums = partial.data() + (task / tiles) * columns;
+
+            for (size_t start = first; start < last; start += BATCH_BLOCK) {
+
+                size_t count = std::min(BATCH_BLOCK, last - start);
+
+                OptionBatchView block = book.Slice(start, start + count);
+                OptionBatchView shocked = block;
+                shocked.S = S;
+                shocked.r = r;
+                shocked.s = s;
+                shocked.b = b;
+
+                const size_t* underlying = m_underlying.data() + start;
+                const double* quantity = m_quantity.data() + start;
+
+                for (size_t column = first_column; column < last_column; column++) {
+
+                    if (column == 0) {
+                        block_pricer.Price(block, prices);
+                    } else {
+                        size_t offset = (column - 1) * underlyings;
+                        const double* spot = scenarios.spot.empty() ? nullptr : scenarios.spot.data() + offset;
+                        const double* vol = scenarios.vol.empty() ? nullptr : scenarios.vol.data() + offset;
+                        const double* rate = scenarios.rate.empty() ? nullptr : scenarios.rate.data() + offset;
+
+                        for (size_t index = 0; index < count; index++) {
+                            size_t u = underlying[index];
+                            double dr = rate ? rate[u] : 0.0;
+                            S[index] = block.S[index] * (1.0 + (spot ? spot[u] : 0.0));
+                            s[index] = block.s[index] + (vol ? vol[u] : 0.0);
+                            r[index] = block.r[index] + dr;
+                            b[index] = block.b[index] + (block.underlying_type[index] == FUTURES ? 0.0 : dr);
+                        }
+
+                        block_pricer.Price(shocked, prices);
+                    }
+
+                    double sum = 0;
+                    for (size_t index = 0; index < count; index++) sum += quantity[index] * prices[index];
+
+                    sums[column] += sum;
+                }
+            }
+        }
+    };
+
+    m_pricer.Pool().ParallelFor(0, chunks * tiles, 1, std::cref(body));
+
+    // Chunk order, so the result does not depend on which thread ran which task
+    vector<double> value(columns, 0.0);
+
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t column = 0; column < columns; column++) value[column] += partial[c * columns + column];
+    }
+
+    ScenarioRiskResult result;
+    result.base_value = value[0];
+    result.value.assign(value.begin() + 1, value.end());
+    result.pnl.resize(scenarios.scenarios);
+    result.confidence = confidence;
+
+    for (size_t scenario = 0; scenario < scenarios.scenarios; scenario++) {
+        result.pnl[scenario] = result.value[scenario] - result.base_value;
+    }
+
+    if (scenarios.scenarios == 0) return result;
+
+    // Historical simulation: the m worst P&Ls
+    size_t tail = static_cast<size_t>(std::floor(scenarios.scenarios * (1.0 - confidence) + 1e-9));
+    result.tail = std::max<size_t>(tail, 1);
+
+    vector<double> worst(result.pnl);
+    std::partial_sort(worst.begin(), worst.begin() + result.tail, worst.end());
+
+    double loss = 0;
+    for (size_t index = 0; index < result.tail; index++) loss -= worst[index];
+
+    result.var = - worst[result.tail - 1];
+    result.expected_shortfall = loss / result.tail;
+
+    return result;
+}
@@ -0,0 +1,118 @@
+//
+//  File: ScenarioPricer.hpp
+//  Project: ExactPricingModels
+//  Objective: Portfolio value under joint spot, volatility and rate scenarios, with VaR and expected shortfall
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ScenarioPricer_hpp
+#define ScenarioPricer_hpp
+
+#include <stdio.h>
+#include "BatchPricer.hpp"
+
+const size_t SCENARIO_TILE = 64; // Scenarios priced against one cached block of contracts before moving to the next block
+
+struct ScenarioSet {
+    /*
+     Joint market shocks, scenario-major: the shock of underlying u in scenario j is at
+     [j * underlyings + u]. A column left empty is not shocked
+     */
+    size_t scenarios = 0; // Number of scenarios
+    size_t underlyings = 0; // Shocks per scenario
+    vector<double> spot; // Relative spot moves, S * (1 + shock), each above -1
+    vector<double> vol; // Absolute volatility moves, s + shock
+    vector<double> rate; // Absolute rate moves, r + shock. The carry cost moves with the rate as in a RATE bump
+
+    ScenarioSet(){} // Default constructor
+
+    ScenarioSet(size_t underlying_count) : underlyings(underlying_count) {} // Empty set over a number of underlyings
+
+    void Add(const vector<double>& spot_shocks,
+             const vector<double>& vol_shocks = {},
+             const vector<double>& rate_shocks = {}); // Append one scenario, each argument empty or with one shock per underlying
+};
+
+struct ScenarioRiskResult {
+    /*
+     Portfolio values across a scenario set and tail statistics of the P&L. With n scenarios
+     and m = max(1, floor(n * (1 - confidence))) tail scenarios, VaR is the m-th largest loss and
+     expected shortfall the mean of the m largest losses (historical simulation)
+     */
+    double base_value = 0; // Sum of quantity * price without shocks
+    vector<double> value; // Portfolio value in every scenario
+    vector<double> pnl; // value - base_value
+    double confidence = 0; // Confidence level of the statistics
+    size_t tail = 0; // m, scenarios averaged by expected_shortfall
+    double var = 0; // Value at risk, a positive number for a loss
+    double expected_shortfall = 0; // Mean loss over the m worst scenarios
+};
+
+class ScenarioPricer {
+    /*
+     A book of European options on a set of underlyings, revalued under every scenario of a
+     ScenarioSet. The work is tiled: each task takes one chunk of contracts and SCENARIO_TILE
+     scenarios, and prices each block of BATCH_BLOCK contracts under all the tile's scenarios
+     while the block is in cache, reducing straight to per scenario sums. Only the
+     chunks x scenarios partial sums are stored, never a price per contract and scenario. Partial
+     sums are added in chunk order, so results do not depend on the number of threads
+     */
+
+    // Attributes
+    OptionBatch m_book; // Contract terms
+    vector<size_t> m_underlying; // Underlying of each position
+    vector<double> m_quantity; // Signed number of contracts of each position
+    size_t m_underlyings = 0; // One past the largest underlying index
+    BatchPricer m_pricer; // Thread pool, contracts per chunk and precision
+
+public:
+    /* CANONICAL HEADER START */
+    ScenarioPricer(){} // Default constructor
+
+    ScenarioPricer(ThreadPool* pool) : m_pricer(pool) {} // Parameter constructor
+
+    virtual ~ScenarioPricer(){} // Destructor
+    /* CANONICAL HEADER END */
+
+    /* GETTERS START */
+
+    size_t Size() const {
+        return m_book.Size();
+    }
+
+    size_t Underlyings() const {
+        return m_underlyings;
+    }
+
+    /* GETTERS END */
+
+    /* SETTERS START */
+
+    void Pool(ThreadPool* pool) {
+        m_pricer.Pool(pool);
+    }
+
+    void ChunkSize(size_t chunk_size) {
+        m_pricer.ChunkSize(chunk_size);
+    }
+
+    void Precision(enum Precision precision) {
+        m_pricer.Precision(precision);
+    }
+
+    /* SETTERS END */
+
+    size_t Add(const EuropeanOption& option, size_t underlying, double quantity = 1); // Add a position, returns its index
+
+    void Clear(); // Remove every position
+
+    ScenarioRiskResult Run(const ScenarioSet& scenarios, double confidence = 0.99) const; // Value under every scenario, VaR and expected shortfall. Throws std::invalid_argument on malformed shocks
+
+    // Helper functions
+private:
+    void Validate(const ScenarioSet& scenarios) const; // Shapes match the book, shocked spots and volatilities stay positive
+
+};
+
+#endif /* ScenarioPricer_hpp */
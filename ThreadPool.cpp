@@ -0,0 +1,227 @@
+//
+//  File: ThreadPool.cpp
+//  Project: ExactPricingModels
+//  Objective: Work-stealing task scheduler used to spread pricing across cores
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#include "ThreadPool.hpp"
+
+#include <exception>
+
+struct ThreadPool::Job {
+    std::atomic<size_t> remaining; // Tasks not yet finished
+    std::mutex mutex; // Guards completion and error
+    std::condition_variable done; // Signalled when remaining reaches zero
+    std::exception_ptr error; // First exception thrown by a task
+};
+
+static thread_local ThreadPool* current_pool = nullptr; // Pool owning the current worker thread
+static thread_local size_t current_index = 0; // Queue of the current worker thread
+
+static std::mutex shared_mutex; // Guards the shared pool
+static std::unique_ptr<ThreadPool> shared_pool; // Created on first use
+static size_t shared_max_threads = 0; // 0 means every hardware thread
+
+ThreadPool::ThreadPool(size_t threads) : m_queued(0), m_stop(false) {
+    /*
+     Parameter constructor. The calling thread of ParallelFor takes part in the work,
+     so threads - 1 workers are started
+     */
+
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    for (size_t index = 0; index < threads; index++) m_queues.emplace_back(new WorkQueue());
+
+    for (size_t index = 0; index + 1 < threads; index++) {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    /*
+     Destructor. Joins the workers
+     */
+
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker: m_workers) worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t begin, size_t end, size_t chunk, const RangeTask& body) {
+    /*
+     Run body over [begin, end) cut into chunks of `chunk` indices. The chunk boundaries only depend
+     on the arguments, never on the number of threads, so per-chunk results are reproducible.
+     Each thread receives a contiguous share of the chunks; idle threads steal from the others.
+     The calling thread works too and the call returns once every chunk is done. A nested call
+     from inside a task is safe. The first exception thrown by a chunk is rethrown here
+     input:
+        index range, chunk size, body(begin, end)
+     */
+
+    if (end <= begin) return;
+
+    if (chunk == 0) chunk = 1;
+
+    size_t tasks = (end - begin + chunk - 1) / chunk;
+
+    if (m_workers.empty() || tasks == 1) {
+        for (size_t start = begin; start < end; start += chunk) body(start, end - start < chunk ? end : start + chunk);
+        return;
+    }
+
+    Job job;
+    job.remaining = tasks;
+
+    size_t home = current_pool == this ? current_index : m_queues.size() - 1;
+
+    size_t queues = m_queues.size();
+
+    for (size_t queue = 0; queue < queues; queue++) {
+
+        size_t first = queue * tasks / queues;
+        size_t last = (queue + 1) * tasks / queues;
+
+        if (first == last) continue;
+
+        // The home queue gets the first share so the caller starts at the beginning of the range
+        WorkQueue& target = *m_queues[(home + queue) % queues];
+
+        std::lock_guard<std::mutex> lock(target.mutex);
+
+        for (size_t task = last; task-- > first;) {
+            size_t start = begin + task * chunk;
+            target.tasks.push_back({&body, start, end - start < chunk ? end : start + chunk, &job});
+        }
+    }
+
+    m_queued += tasks;
+
+    {
+        std::lock_guard<std::mutex> lock(m_wake_mutex);
+    }
+    m_wake.notify_all();
+
+    while (job.remaining.load() > 0 && RunOne(home)) {}
+
+    std::unique_lock<std::mutex> lock(job.mutex);
+    job.done.wait(lock, [&job]{ return job.remaining.load() == 0; });
+
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+ThreadPool& ThreadPool::Instance() {
+    /*
+     Shared pool, created on first use with the current thread cap
+     */
+
+    std::lock_guard<std::mutex> lock(shared_mutex);
+
+    if (!shared_pool) shared_pool.reset(new ThreadPool(shared_max_threads));
+
+    return *shared_pool;
+}
+
+void ThreadPool::SetMaxThreads(size_t threads) {
+    /*
+     Cap the shared pool, e.g. when sharing the process with other services.
+     The shared pool is rebuilt on its next use
+     */
+
+    std::lock_guard<std::mutex> lock(shared_mutex);
+
+    shared_max_threads = threads;
+    shared_pool.reset();
+}
+
+size_t ThreadPool::MaxThreads() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+
+    return shared_max_threads;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    /*
+     Worker thread body. Runs tasks until none are left, then sleeps until new ones are queued
+     */
+
+    current_pool = this;
+    current_index = index;
+
+    while (true) {
+
+        if (RunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(m_wake_mutex);
+
+        m_wake.wait(lock, [this]{ return m_stop.load() || m_queued.load() > 0; });
+
+        if (m_stop) return;
+    }
+}
+
+bool ThreadPool::RunOne(size_t home) {
+    /*
+     Run one task. The thread's own queue is served last in first out, the other queues are
+     robbed first in first out so thieves take the work farthest from the owner's current position
+     */
+
+    Task task;
+    bool found = false;
+
+    for (size_t offset = 0; offset < m_queues.size() && !found; offset++) {
+
+        WorkQueue& queue = *m_queues[(home + offset) % m_queues.size()];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.tasks.empty()) continue;
+
+        if (offset == 0) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        } else {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+
+        found = true;
+    }
+
+    if (!found) return false;
+
+    m_queued--;
+
+    Execute(task);
+
+    return true;
+}
+
+void ThreadPool::Execute(const Task& task) {
+    /*
+     Run a task and signal its job. The completion is published under the job's mutex so the
+     waiting caller cannot release the job while it is still being signalled
+     */
+
+    std::exception_ptr error;
+
+    try {
+        (*task.body)(task.begin, task.end);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    Job& job = *task.job;
+
+    std::lock_guard<std::mutex> lock(job.mutex);
+
+    if (error && !job.error) job.error = error;
+
+    if (--job.remaining == 0) job.done.notify_all();
+}
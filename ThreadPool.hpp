@@ -0,0 +1,83 @@
+//
+//  File: ThreadPool.hpp
+//  Project: ExactPricingModels
+//  Objective: Work-stealing task scheduler used to spread pricing across cores
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <stdio.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+
+public:
+    typedef std::function<void(size_t begin, size_t end)> RangeTask; // Processes [begin, end)
+
+private:
+    struct Job; // One ParallelFor call
+
+    struct Task {
+        const RangeTask* body; // Shared body of the job
+        size_t begin; // First index
+        size_t end; // One past the last index
+        Job* job; // Owning job
+    };
+
+    struct WorkQueue {
+        std::mutex mutex; // Guards tasks
+        std::deque<Task> tasks; // Owner pops at the back, thieves steal at the front
+    };
+
+    // Attributes
+    std::vector<std::unique_ptr<WorkQueue>> m_queues; // One deque per worker, plus one for external callers
+    std::vector<std::thread> m_workers; // Worker threads
+    std::mutex m_wake_mutex; // Guards the sleep/wake handshake
+    std::condition_variable m_wake; // Signalled when tasks are queued or on shutdown
+    std::atomic<size_t> m_queued; // Tasks queued and not yet taken
+    std::atomic<bool> m_stop; // Set on destruction
+
+public:
+    /* CANONICAL HEADER START */
+    ThreadPool(size_t threads = 0); // Parameter constructor. 0 uses every hardware thread
+
+    ThreadPool(const ThreadPool& other_pool) = delete; // Not copyable
+
+    virtual ~ThreadPool(); // Destructor. Joins the workers
+
+    ThreadPool& operator = (const ThreadPool& other_pool) = delete; // Not assignable
+    /* CANONICAL HEADER END */
+
+    size_t Size() const {
+        // Threads taking part in a ParallelFor, including the calling thread
+        return m_workers.size() + 1;
+    }
+
+    void ParallelFor(size_t begin, size_t end, size_t chunk, const RangeTask& body); // Run body over [begin, end) in chunks, blocks until done
+
+    static ThreadPool& Instance(); // Shared pool
+
+    static void SetMaxThreads(size_t threads); // Cap the shared pool. 0 restores every hardware thread. Not safe while the shared pool is in use
+
+    static size_t MaxThreads(); // Cap of the shared pool
+
+private:
+    void WorkerLoop(size_t index); // Worker thread body
+
+    bool RunOne(size_t home); // Run one task, own queue first then steal. False when every queue is empty
+
+    void Execute(const Task& task); // Run a task and signal its job
+
+};
+
+#endif /* ThreadPool_hpp */
@@ -1,131 +1,262 @@
 //
 //  File: main.cpp
 //  Project: ExactPricingModels
-//  Objective: Test european option
+//  Objective: Command-line pricing of contract files
 //
 //  Created by Aldo Aguilar on 02/10/20.
 //
 
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <string>
 
-#include "EuropeanOption.hpp"
-#include "Helpers.hpp"
+#include "ColumnFile.hpp"
+#include "PricingPipeline.hpp"
 
 using namespace std;
 
-void Pricing(); // Pricing example
-void PutCallParity(); // Pricing using put-call parity example
-void MeshPricing(); // Pricing using mesh example
-void GreeksApproximation(); // Greeks computation example
+void Usage(ostream& out); // Print the command-line options
+bool ParseFormat(const char* text, enum RecordFormat& format); // csv, binary or columnar
+bool ParseMask(const char* text, unsigned& mask); // Comma separated output names
+int RunColumnar(const PricingPipeline& pipeline, const char* input_path, const char* output_path, bool quiet); // Price or convert with mapped column files
 
 int main(int argc, const char * argv[]) {
-    
-    Pricing();
-    PutCallParity();
-    MeshPricing();
-    GreeksApproximation();
-    
-    return  0;
-}
+    /*
+     Stream contracts from a file or stdin, price them and write the results to a file or stdout.
+     Throughput and stage timings go to stderr
+     */
+
+    PricingPipeline pipeline;
+
+    const char* input_path = nullptr;
+    const char* output_path = nullptr;
+    bool quiet = false;
+
+    for (int index = 1; index < argc; index++) {
+
+        const char* option = argv[index];
+        const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+        bool valid = true;
+
+        if (!strcmp(option, "-h") || !strcmp(option, "--help")) {
+            Usage(cout);
+            return 0;
+        } else if (!strcmp(option, "-q") || !strcmp(option, "--quiet")) {
+            quiet = true;
+            continue;
+        } else if (option[0] != '-' || !strcmp(option, "-")) {
+            valid = input_path == nullptr;
+            input_path = option;
+            if (valid) continue;
+        } else if (!value) {
+            valid = false;
+        } else if (!strcmp(option, "-o") || !strcmp(option, "--output")) {
+            output_path = value;
+        } else if (!strcmp(option, "--input-format")) {
+            enum RecordFormat format;
+            valid = ParseFormat(value, format);
+            pipeline.InputFormat(format);
+        } else if (!strcmp(option, "--output-format")) {
+            enum RecordFormat format;
+            valid = ParseFormat(value, format);
+            pipeline.OutputFormat(format);
+        } else if (!strcmp(option, "--outputs")) {
+            unsigned mask = 0;
+            valid = ParseMask(value, mask);
+            pipeline.Mask(mask);
+        } else if (!strcmp(option, "--threads")) {
+            pipeline.PricingThreads(strtoul(value, nullptr, 10));
+        } else if (!strcmp(option, "--chunk")) {
+            pipeline.ChunkSize(strtoul(value, nullptr, 10));
+        } else if (!strcmp(option, "--queue")) {
+            pipeline.QueueCapacity(strtoul(value, nullptr, 10));
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            cerr << "invalid argument: " << option << endl;
+            Usage(cerr);
+            return 2;
+        }
 
-void Pricing(){
-    // Batch 1
-    EuropeanOption c_b1 = EuropeanOption(60.0, 65.0, 0.25, 0.08, 0.30, CALL, STOCK);
-    cout << "Call price: " << c_b1.Price() << endl;
+        index++;
+    }
+
+    ios::sync_with_stdio(false);
 
-    EuropeanOption p_b1 = EuropeanOption(60.0, 65.0, 0.25, 0.08, 0.3, PUT, STOCK);
-    cout << "Put price: " << p_b1.Price() << endl;
+    if (pipeline.InputFormat() == COLUMNAR_FORMAT || pipeline.OutputFormat() == COLUMNAR_FORMAT) {
+        return RunColumnar(pipeline, input_path, output_path, quiet);
+    }
 
-    // Batch 2
-    EuropeanOption c_b2 = EuropeanOption(100.0, 100.0, 1.0, 0.0, 0.2, CALL, STOCK);
-    cout << "Call price: " << c_b2.Price() << endl;
+    ifstream input_file;
+    ofstream output_file;
 
-    EuropeanOption p_b2 = EuropeanOption(100.0, 100.0, 1.0, 0.0, 0.2, PUT, STOCK);
-    cout << "Put price: " << p_b2.Price() << endl;
+    if (input_path && strcmp(input_path, "-")) {
+        input_file.open(input_path, ios::binary);
+        if (!input_file) {
+            cerr << "cannot open " << input_path << endl;
+            return 1;
+        }
+    }
 
-    // Batch 3
-    EuropeanOption c_b3 = EuropeanOption(5.0, 10.0, 1.0, 0.12, 0.5, CALL, STOCK);
-    cout << "Call price: " << c_b3.Price() << endl;
+    if (output_path && strcmp(output_path, "-")) {
+        output_file.open(output_path, ios::binary | ios::trunc);
+        if (!output_file) {
+            cerr << "cannot open " << output_path << endl;
+            return 1;
+        }
+    }
 
-    EuropeanOption p_b3 = EuropeanOption(5.0, 10.0, 1.0, 0.12, 0.5, PUT, STOCK);
-    cout << "Put price: " << p_b3.Price() << endl;
+    istream& in = input_file.is_open() ? static_cast<istream&>(input_file) : cin;
+    ostream& out = output_file.is_open() ? static_cast<ostream&>(output_file) : cout;
 
-    // Batch 4
-    EuropeanOption c_b4 = EuropeanOption(100.0, 100.0, 30.0, 0.08, 0.30, CALL, STOCK);
-    cout << "Call price: " << c_b4.Price() << endl;
+    try {
+        PipelineStats stats = pipeline.Run(in, out);
 
-    EuropeanOption p_b4 = EuropeanOption(100.0, 100.0, 30.0, 0.08, 0.30, PUT, STOCK);
-    cout << "Put price: " << p_b4.Price() << endl;
+        if (!quiet) stats.Print(cerr);
+    } catch (const exception& error) {
+        cerr << "error: " << error.what() << endl;
+        return 1;
+    }
 
+    return  0;
 }
 
-void PutCallParity(){
-    // Batch 1
-    EuropeanOption c_b1 = EuropeanOption(60.0, 65.0, 0.25, 0.08, 0.30, CALL, STOCK);
-    cout << "Call price: " << c_b1.Price() << endl;
+void Usage(ostream& out) {
+    out << "usage: pricer [options] [input]\n"
+           "  input                  contract file, stdin when omitted or -\n"
+           "  -o, --output FILE      result file, stdout when omitted or -\n"
+           "  --input-format F       csv (default), binary or columnar\n"
+           "  --output-format F      csv (default), binary or columnar\n"
+           "  --outputs LIST         price,delta,gamma,vega,theta,rho,carry_rho, all,\n"
+           "                         or contracts to convert the input without pricing (default price)\n"
+           "  --threads N            pricing threads, 0 for every hardware thread (default 0)\n"
+           "  --chunk N              contracts per chunk (default 16384)\n"
+           "  --queue N              chunks buffered between stages (default 4)\n"
+           "  -q, --quiet            do not print throughput and stage timings\n"
+           "\n"
+           "CSV contracts: S,K,T,r,sigma,CALL|PUT,STOCK|DIVIDEND|FUTURES|CURRENCY[,q[,R]]\n"
+           "Binary contracts: 64-byte ContractRecord, see PricingPipeline.hpp\n"
+           "Columnar files are memory mapped, see ColumnFile.hpp. Columnar output needs an output file\n"
+           "and columnar input needs columnar output; '--outputs contracts' converts a book to columnar\n"
+           "Results are written one row per contract, in input order\n";
+}
 
-    EuropeanOption p_b1 = EuropeanOption(60.0, 65.0, 0.25, 0.08, 0.3, PUT, STOCK);
-    cout << "Put price: " << p_b1.Price() << endl;
+bool ParseFormat(const char* text, enum RecordFormat& format) {
+    if (!strcmp(text, "csv")) format = CSV_FORMAT;
+    else if (!strcmp(text, "binary")) format = BINARY_FORMAT;
+    else if (!strcmp(text, "columnar")) format = COLUMNAR_FORMAT;
+    else return false;
+    return true;
+}
+
+bool ParseMask(const char* text, unsigned& mask) {
+    /*
+     Translate a list such as price,delta,vega into GreekMask bits
+     */
+    const char* names[] = {"price", "delta", "gamma", "vega", "theta", "rho", "carry_rho"};
 
-    cout << "Call price using parity: " << p_b1.Price(p_b1.Price())[0] << ", parity difference: " << p_b1.Price(p_b1.Price())[1] << endl;
+    string list(text);
+    size_t start = 0;
 
-    // Batch 2
-    EuropeanOption c_b2 = EuropeanOption(100.0, 100.0, 1.0, 0.0, 0.2, CALL, STOCK);
-    cout << "Call price: " << c_b2.Price() << endl;
+    mask = 0;
 
-    EuropeanOption p_b2 = EuropeanOption(100.0, 100.0, 1.0, 0.0, 0.2, CALL, STOCK);
-    cout << "Put price: " << p_b2.Price() << endl;
+    while (start <= list.size()) {
 
-    cout << "Call price using parity: " << p_b2.Price(p_b2.Price())[0] << ", parity difference: " << p_b2.Price(p_b1.Price())[1] << endl;
+        size_t comma = list.find(',', start);
+        if (comma == string::npos) comma = list.size();
 
-    // Batch 3
-    EuropeanOption c_b3 = EuropeanOption(5.0, 10.0, 1.0, 0.12, 0.5, CALL, STOCK);
-    cout << "Call price: " << c_b3.Price() << endl;
+        string name = list.substr(start, comma - start);
+        bool known = false;
 
-    EuropeanOption p_b3 = EuropeanOption(5.0, 10.0, 1.0, 0.12, 0.5, CALL, STOCK);
-    cout << "Put price: " << p_b3.Price() << endl;
+        if (name == "all") {
+            mask |= ALL_GREEKS;
+            known = true;
+        } else if (name == "contracts") {
+            known = true;
+        }
 
-    cout << "Call price using parity: " << p_b3.Price(p_b3.Price())[0] << ", parity difference: " << p_b3.Price(p_b1.Price())[1] << endl;
+        for (unsigned bit = 0; bit < 7; bit++) {
+            if (name == names[bit]) {
+                mask |= 1u << bit;
+                known = true;
+            }
+        }
 
-    // Batch 4
-    EuropeanOption c_b4 = EuropeanOption(100.0, 100.0, 30.0, 0.08, 0.30, CALL, STOCK);
-    cout << "Call price: " << c_b4.Price() << endl;
+        if (!known) return false;
 
-    EuropeanOption p_b4 = EuropeanOption(100.0, 100.0, 30.0, 0.08, 0.30, PUT, STOCK);
-    cout << "Put price: " << p_b4.Price() << endl;
+        start = comma + 1;
+    }
 
-    cout << "Call price using parity: " << p_b4.Price(p_b4.Price())[0] << ", parity difference: " << p_b4.Price(p_b1.Price())[1] << endl;
+    return true;
 }
 
-void MeshPricing(){
-    
-    EuropeanOption put = EuropeanOption(100.0, 100.0, 30.0, 0.08, 0.30, PUT, STOCK);
-    
-    cout << "Put price: " << put.Price() << endl;
-    
-    // Create mesh
-    vector<double> price_mesh = CreateMesh(99, 101, 1);
-    
-    vector<double> prices = put.Price(price_mesh, UNDERLYING);
-    
-    vector<double> deltas = put.Delta(price_mesh);
-    
-    // Compute price and mesh
-    for (int index = 0; index < prices.size(); index++) {
-        cout << "Price: " << prices[index] << endl;
-        
-        cout << "Delta: " <<deltas[index] << endl;
+int RunColumnar(const PricingPipeline& pipeline, const char* input_path, const char* output_path, bool quiet) {
+    /*
+     Price a mapped book into a mapped result file, or convert a CSV/binary book to the columnar format.
+     Mapped columns are never copied: the batch pricer reads the book pages and writes the result pages in place
+     */
+
+    typedef chrono::steady_clock Clock;
+
+    Clock::time_point start = Clock::now();
+
+    if (!output_path || !strcmp(output_path, "-") || pipeline.OutputFormat() != COLUMNAR_FORMAT) {
+        cerr << "columnar files need a columnar output file (-o FILE --output-format columnar)" << endl;
+        return 2;
+    }
+
+    try {
+        ColumnFile book_file;
+        OptionBatch loaded;
+        OptionBatchView book;
+
+        if (pipeline.InputFormat() == COLUMNAR_FORMAT) {
+            if (!input_path || !strcmp(input_path, "-")) {
+                cerr << "columnar input must be a file" << endl;
+                return 2;
+            }
+            book_file = ColumnFile::Open(input_path);
+            book = BookView(book_file);
+        } else {
+            ifstream input_file;
+            if (input_path && strcmp(input_path, "-")) {
+                input_file.open(input_path, ios::binary);
+                if (!input_file) {
+                    cerr << "cannot open " << input_path << endl;
+                    return 1;
+                }
+            }
+            loaded = pipeline.Load(input_file.is_open() ? static_cast<istream&>(input_file) : cin);
+            book = loaded.View();
+        }
+
+        double open_seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        if (pipeline.Mask() == 0) {
+            WriteBook(output_path, book);
+        } else {
+            ColumnFile results = ColumnFile::Create(output_path, book.size, ResultColumns(pipeline.Mask()));
+
+            BatchPricer pricer;
+            pricer.PriceAndGreeks(book, pipeline.Mask(), ResultView(results, pipeline.Mask()));
+        }
+
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        if (!quiet) {
+            char text[256];
+            snprintf(text, sizeof(text), "contracts: %zu, %.3f s (open %.3f s)\nthroughput: %.0f contracts/s\n",
+                     book.size, seconds, open_seconds, seconds > 0 ? book.size / seconds : 0);
+            cerr << text;
+        }
+    } catch (const exception& error) {
+        cerr << "error: " << error.what() << endl;
+        return 1;
     }
-    
-}
 
-void GreeksApproximation(){
-    EuropeanOption call = EuropeanOption(105, 100, 0.5, 0.1, 0.36, CALL, FUTURES);
-    
-    // Compute delta
-    cout << "Delta: " << call.Delta() << endl;
-    
-    // Compute delta approximation
-    cout << "Delta approx.: " << call.DeltaApproximation(1) << endl;
-    
+    return 0;
 }
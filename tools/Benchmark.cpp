@@ -0,0 +1,893 @@
+//
+//  File: Benchmark.cpp
+//  Project: ExactPricingModels
+//  Objective: Microbenchmarks of every pricing entry point, written as JSON
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+//  Built by the benchmark target of CMakeLists.txt, from the repository root:
+//      cmake -S . -B build && cmake --build build --target benchmark
+//  Configure with -DEXACT_PRICING_METRICS=ON to measure the instrumentation overhead
+//
+
+#include <iostream>
+#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <new>
+#include <numbers>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "EuropeanOption.hpp"
+#include "AdjointPricer.hpp"
+#include "ArbitrageScanner.hpp"
+#include "BatchPricer.hpp"
+#include "BumpPricer.hpp"
+#include "MonteCarloOption.hpp"
+#include "LatticeOption.hpp"
+#include "MarketData.hpp"
+#include "PdeOption.hpp"
+#include "ResultCache.hpp"
+#include "ScenarioPricer.hpp"
+#include "ImpliedVol.hpp"
+#include "IncrementalPricer.hpp"
+#include "NormalMath.hpp"
+#include "ThreadPool.hpp"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+const size_t OBJECT_WORKING_SET = 1 << 16; // Distinct EuropeanOption objects cycled through by the per-object cases
+
+struct BenchmarkCase {
+    string name; // Entry point, e.g. "Price(mesh, SIGMA)"
+    function<void(size_t size)> prepare; // Build the inputs for a size, outside the timed region
+    function<void(size_t size)> run; // Evaluate `size` options once
+    bool allocation_free = false; // Must not touch the heap when run on one thread
+    function<string(size_t size)> check = nullptr; // Optional accuracy check run after the timed runs, returns the failure or an empty string
+    size_t max_size = 0; // Largest size run, 0 for none. Keeps the slow cases to seconds per size
+};
+
+struct BenchmarkResult {
+    string name; // Case name
+    size_t size = 0; // Options per run
+    size_t threads = 0; // Threads of the shared pool
+    size_t repetitions = 0; // Timed runs
+    double ns_per_option = 0; // Mean over the timed runs
+    double min_ns_per_option = 0; // Fastest run
+    double allocations_per_run = 0; // Heap allocations, mean over the timed runs
+    bool allocation_free = false; // Copied from the case
+};
+
+static atomic<double> sink; // Keeps results alive so the compiler cannot drop the work
+
+static atomic<size_t> allocations(0); // Calls to operator new, counted by the replacements below
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* pointer = malloc(size ? size : 1)) return pointer;
+    throw bad_alloc();
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    size_t bytes = (size + static_cast<size_t>(alignment) - 1) / static_cast<size_t>(alignment) * static_cast<size_t>(alignment);
+    if (void* pointer = aligned_alloc(static_cast<size_t>(alignment), bytes ? bytes : static_cast<size_t>(alignment))) return pointer;
+    throw bad_alloc();
+}
+
+// GCC flags free() on memory from operator new once these are inlined; here both sides are replaced
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, align_val_t) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t, align_val_t) noexcept {
+    free(pointer);
+}
+
+#pragma GCC diagnostic pop
+
+static void Keep(double value) {
+    sink.store(value, memory_order_relaxed);
+}
+
+static double Uniform(mt19937_64& generator, double low, double high) {
+    return uniform_real_distribution<double>(low, high)(generator);
+}
+
+static EuropeanOption RandomOption(mt19937_64& generator) {
+    /*
+     Random contract covering every option type and underlying asset class
+     */
+    return EuropeanOption(Uniform(generator, 50, 150),
+                          Uniform(generator, 50, 150),
+                          Uniform(generator, 0.05, 3),
+                          Uniform(generator, 0, 0.1),
+                          Uniform(generator, 0.05, 0.8),
+                          generator() % 2 ? CALL : PUT,
+                          static_cast<enum UnderlyingType>(generator() % 4),
+                          Uniform(generator, 0, 0.05),
+                          Uniform(generator, 0, 0.05));
+}
+
+static vector<double> Mesh(double low, double high, size_t size) {
+    vector<double> mesh(size);
+    for (size_t index = 0; index < size; index++) mesh[index] = size > 1 ? low + (high - low) * index / (size - 1) : low;
+    return mesh;
+}
+
+static string CheckBound(const char* output, size_t index, double value, double reference, double bound) {
+    /*
+     Failure message when a result is further than bound from its reference, e.g. MIXED_PRECISION from DOUBLE_PRECISION
+     */
+
+    if (fabs(value - reference) <= bound) return "";
+
+    char message[200];
+    snprintf(message, sizeof(message), "%s %zu: %.17g, reference %.17g, error %.3g above bound %.3g",
+             output, index, value, reference, fabs(value - reference), bound);
+    return message;
+}
+
+static vector<BenchmarkCase> Cases() {
+    /*
+     One case per entry point. Per-object cases call the method `size` times over a working set of
+     OBJECT_WORKING_SET options, split over the shared pool; mesh and batch cases evaluate one
+     input of `size` elements
+     */
+
+    static vector<EuropeanOption> options;
+    static vector<double> parity_prices;
+    static vector<double> mesh;
+    static vector<double> mesh_output;
+    static OptionBatch batch;
+    static vector<double> batch_prices;
+    static vector<double> math_input;
+    static vector<double> math_output;
+    static GreeksBatch greeks;
+    static vector<unsigned char> status;
+    static vector<LatticeOption> lattice_book;
+    static vector<PdeOption> pde_book;
+    static ScenarioPricer scenario_pricer;
+    static ScenarioSet scenario_set;
+    static OptionChain chain;
+    static ResultCache result_cache;
+    static vector<EuropeanOption> cached_options;
+    static MarketDataStore market_store(64);
+    static MarketBook market_book;
+    static MarketSnapshot market_snapshot;
+    static vector<double> market_prices;
+    static AdjointPricer adjoint_book;
+
+    vector<BenchmarkCase> cases;
+
+    auto prepare_options = [](size_t) {
+        if (!options.empty()) return;
+        mt19937_64 generator(42);
+        for (size_t index = 0; index < OBJECT_WORKING_SET; index++) {
+            options.push_back(RandomOption(generator));
+            parity_prices.push_back(options.back().Price());
+        }
+    };
+
+    auto per_object = [](const function<double(const EuropeanOption&, size_t)>& call) {
+        return [call](size_t size) {
+            ThreadPool::Instance().ParallelFor(0, size, 4096, [&](size_t begin, size_t end) {
+                double total = 0;
+                for (size_t index = begin; index < end; index++) total += call(options[index % OBJECT_WORKING_SET], index % OBJECT_WORKING_SET);
+                Keep(total);
+            });
+        };
+    };
+
+    cases.push_back({"Price()", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.Price();
+    }), true});
+
+    cases.push_back({"Price(double) parity", prepare_options, per_object([](const EuropeanOption& option, size_t index) {
+        return option.Price(parity_prices[index])[0];
+    })});
+
+    cases.push_back({"Parity(double)", prepare_options, per_object([](const EuropeanOption& option, size_t index) {
+        return option.Parity(parity_prices[index]).price;
+    }), true});
+
+    cases.push_back({"Delta()", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.Delta();
+    }), true});
+
+    cases.push_back({"Gamma()", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.Gamma();
+    }), true});
+
+    cases.push_back({"DeltaApproximation(h)", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.DeltaApproximation(0.01);
+    }), true});
+
+    cases.push_back({"GammaApproximation(h)", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.GammaApproximation(0.01);
+    }), true});
+
+    cases.push_back({"PriceAndGreeks(ALL_GREEKS)", prepare_options, per_object([](const EuropeanOption& option, size_t) {
+        return option.PriceAndGreeks().gamma;
+    }), true});
+
+    // 1024 hot quotes through a ResultCache. The warm-up run fills it, so timed runs are all hits
+    cases.push_back({"Price() cached", [prepare_options](size_t size) {
+        prepare_options(size);
+        if (!cached_options.empty()) return;
+        cached_options.assign(options.begin(), options.begin() + 1024);
+        for (EuropeanOption& option: cached_options) option.Cache(&result_cache);
+    }, [](size_t size) {
+        ThreadPool::Instance().ParallelFor(0, size, 4096, [&](size_t begin, size_t end) {
+            double total = 0;
+            for (size_t index = begin; index < end; index++) total += cached_options[index % 1024].Price();
+            Keep(total);
+        });
+    }, true});
+
+    const EuropeanOption reference(100, 100, 1, 0.05, 0.2, PUT, DIVIDEND, 0.02);
+
+    const struct { enum Parameter parameter; const char* name; double low, high; } mesh_axes[] = {
+        {UNDERLYING, "UNDERLYING", 50, 150},
+        {STRIKE, "STRIKE", 50, 150},
+        {TIME, "TIME", 0.05, 3},
+        {RATE, "RATE", 0, 0.1},
+        {SIGMA, "SIGMA", 0.05, 0.8},
+        {CARRY, "CARRY", -0.05, 0.1}
+    };
+
+    for (const auto& axis: mesh_axes) {
+
+        double low = axis.low, high = axis.high;
+        enum Parameter parameter = axis.parameter;
+
+        cases.push_back({string("Price(mesh, ") + axis.name + ")",
+                         [low, high](size_t size) { mesh = Mesh(low, high, size); },
+                         [reference, parameter](size_t) { Keep(reference.Price(mesh, parameter).back()); }});
+
+        cases.push_back({string("Price(span, ") + axis.name + ")",
+                         [low, high](size_t size) { mesh = Mesh(low, high, size); mesh_output.resize(size); },
+                         [reference, parameter](size_t) { reference.Price(mesh, parameter, mesh_output); Keep(mesh_output.back()); },
+                         true});
+    }
+
+    cases.push_back({"Delta(mesh)",
+                     [](size_t size) { mesh = Mesh(50, 150, size); },
+                     [reference](size_t) { Keep(reference.Delta(mesh).back()); }});
+
+    cases.push_back({"Gamma(mesh)",
+                     [](size_t size) { mesh = Mesh(50, 150, size); },
+                     [reference](size_t) { Keep(reference.Gamma(mesh).back()); }});
+
+    cases.push_back({"Delta(span)",
+                     [](size_t size) { mesh = Mesh(50, 150, size); mesh_output.resize(size); },
+                     [reference](size_t) { reference.Delta(mesh, mesh_output); Keep(mesh_output.back()); },
+                     true});
+
+    cases.push_back({"Gamma(span)",
+                     [](size_t size) { mesh = Mesh(50, 150, size); mesh_output.resize(size); },
+                     [reference](size_t) { reference.Gamma(mesh, mesh_output); Keep(mesh_output.back()); },
+                     true});
+
+    cases.push_back({"Price(MeshView linear, UNDERLYING)",
+                     [](size_t size) { mesh_output.resize(size); },
+                     [reference](size_t size) {
+                         reference.Price(MeshView::Linear(50, 150, size), UNDERLYING, mesh_output);
+                         Keep(mesh_output.back());
+                     },
+                     true});
+
+    cases.push_back({"Price(MeshView log, STRIKE) streamed",
+                     [](size_t) {},
+                     [reference](size_t size) {
+                         double total = 0;
+                         reference.Price(MeshView::Logarithmic(50, 150, size), STRIKE, [&total](size_t, const double* prices, size_t count) {
+                             for (size_t index = 0; index < count; index++) total += prices[index];
+                         });
+                         Keep(total);
+                     },
+                     true});
+
+    auto prepare_batch = [](size_t size) {
+        if (batch.Size() == size) return;
+        mt19937_64 generator(7);
+        batch.Clear();
+        batch.Reserve(size);
+        for (size_t index = 0; index < size; index++) batch.Add(RandomOption(generator));
+        batch_prices = BatchPricer().Price(batch);
+    };
+
+    auto prepare_math = [](size_t size) {
+        if (math_input.size() == size) return;
+        mt19937_64 generator(11);
+        math_input.resize(size);
+        math_output.resize(size);
+        for (double& x: math_input) x = Uniform(generator, -37.5, 37.5);
+    };
+
+    // Every instruction set and the scalar entry points against a long double reference, within the
+    // relative error of NormalMath.hpp, and on NaN, infinities and the edges of log's domain
+    auto check_math = [](size_t size) -> string {
+        typedef void (*ArrayKernel)(const double*, double*, size_t);
+        typedef double (*ScalarKernel)(double);
+        struct Kernel { const char* name; ArrayKernel array; ScalarKernel scalar; double scale; };
+        const Kernel kernels[] = {
+            {"NormalCdf", static_cast<ArrayKernel>(NormalCdf), static_cast<ScalarKernel>(NormalCdf), 1},
+            {"NormalPdf", static_cast<ArrayKernel>(NormalPdf), static_cast<ScalarKernel>(NormalPdf), 1},
+            {"Exp", static_cast<ArrayKernel>(Exp), static_cast<ScalarKernel>(Exp), 18.8}, // Arguments up to 705, results normal
+            {"Log", static_cast<ArrayKernel>(Log), static_cast<ScalarKernel>(Log), 18.8} // Of e^705x, so the inputs span the normal range
+        };
+        const double nan = numeric_limits<double>::quiet_NaN(), inf = numeric_limits<double>::infinity();
+        const double special[] = {nan, inf, -inf, 0, -1};
+        const long double inv_sqrt_2pi = numbers::inv_sqrtpi_v<long double> / numbers::sqrt2_v<long double>;
+        const double expected[4][5] = {{nan, 1, 0, 0.5, 0.15865525393145705}, {nan, 0, 0, double(inv_sqrt_2pi), 0.24197072451914337}, {nan, inf, 0, 1, exp(-1.0)}, {nan, inf, nan, -inf, nan}};
+        enum SimdLevel active = ActiveSimdLevel();
+        vector<double> input(size), output(size);
+        string failure;
+
+        for (int level = SIMD_NONE; level <= DetectedSimdLevel() && failure.empty(); level++) {
+            SetSimdLevel(static_cast<enum SimdLevel>(level));
+            for (size_t kernel = 0; kernel < 4 && failure.empty(); kernel++) {
+                const Kernel& k = kernels[kernel];
+                for (size_t index = 0; index < size; index++) input[index] = kernel == 3 ? exp(k.scale * math_input[index]) : k.scale * math_input[index];
+                k.array(input.data(), output.data(), size);
+                for (size_t index = 0; index < size && failure.empty(); index++) {
+                    long double x = input[index];
+                    long double reference = kernel == 0 ? 0.5L * erfcl(-x / sqrtl(2.0L)) : kernel == 1 ? expl(-x * x / 2) * inv_sqrt_2pi : kernel == 2 ? expl(x) : logl(x);
+                    double bound = 1e-15 * (kernel == 3 ? max(1.0, fabs(double(reference))) : fabs(double(reference)));
+                    failure = CheckBound(k.name, index, output[index], double(reference), bound);
+                    if (failure.empty() && level == SIMD_NONE) failure = CheckBound(k.name, index, k.scalar(input[index]), double(reference), bound);
+                }
+                double results[5];
+                k.array(special, results, 5);
+                for (size_t index = 0; index < 5 && failure.empty(); index++) {
+                    double scalar = k.scalar(special[index]);
+                    for (double value: {results[index], scalar}) {
+                        if (isnan(value) == isnan(expected[kernel][index]) && (isnan(value) || value == expected[kernel][index] || fabs(value - expected[kernel][index]) <= 1e-15 * fabs(expected[kernel][index]))) continue;
+                        char message[200];
+                        snprintf(message, sizeof(message), "%s(%g) at SIMD level %d: %.17g, expected %.17g", k.name, special[index], level, value, expected[kernel][index]);
+                        failure = message;
+                        break;
+                    }
+                }
+            }
+        }
+
+        SetSimdLevel(active);
+        return failure;
+    };
+
+    cases.push_back({"NormalCdf(array)", prepare_math, [](size_t size) {
+        NormalCdf(math_input.data(), math_output.data(), size);
+        Keep(math_output.back());
+    }, true, check_math});
+
+    cases.push_back({"BatchPricer::Price", prepare_batch, [](size_t) {
+        Keep(BatchPricer().Price(batch).back());
+    }});
+
+    // MIXED_PRECISION against DOUBLE_PRECISION on the same book, within the bounds of the README:
+    // 2e-7 * (S e^((b-r)T) + K e^(-rT)) on prices, 2e-7 * e^((b-r)T) on deltas, that over S s sqrt(T) on gammas
+    auto check_mixed_batch = [](size_t) -> string {
+        const unsigned mask = GREEK_PRICE | GREEK_DELTA | GREEK_GAMMA;
+        vector<double> prices = BatchPricer(nullptr, BATCH_CHUNK, MIXED_PRECISION).Price(batch);
+        GreeksBatch mixed, exact;
+        BatchPricer(nullptr, BATCH_CHUNK, MIXED_PRECISION).PriceAndGreeks(batch, mask, mixed);
+        BatchPricer().PriceAndGreeks(batch, mask, exact);
+        for (size_t index = 0; index < batch.Size(); index++) {
+            double S = batch.S()[index], K = batch.K()[index], T = batch.T()[index];
+            double r = batch.r()[index], s = batch.s()[index], b = batch.b()[index];
+            double carry = exp((b - r) * T);
+            double price_bound = 2e-7 * (S * carry + K * exp(-r * T));
+            string failure = CheckBound("price", index, prices[index], exact.Price()[index], price_bound);
+            if (failure.empty()) failure = CheckBound("fused price", index, mixed.Price()[index], exact.Price()[index], price_bound);
+            if (failure.empty()) failure = CheckBound("delta", index, mixed.Delta()[index], exact.Delta()[index], 2e-7 * carry);
+            if (failure.empty()) failure = CheckBound("gamma", index, mixed.Gamma()[index], exact.Gamma()[index], 2e-7 * carry / (S * s * sqrt(T)));
+            if (!failure.empty()) return failure;
+        }
+        return "";
+    };
+
+    cases.push_back({"BatchPricer::Price(MIXED_PRECISION)", prepare_batch, [](size_t) {
+        Keep(BatchPricer(nullptr, BATCH_CHUNK, MIXED_PRECISION).Price(batch).back());
+    }, false, check_mixed_batch});
+
+    cases.push_back({"BatchPricer::PriceAndGreeks(ALL_GREEKS)", prepare_batch, [](size_t) {
+        BatchPricer().PriceAndGreeks(batch, ALL_GREEKS, greeks);
+        Keep(greeks.Gamma().back());
+    }});
+
+    cases.push_back({"BatchPricer::PriceAndGreeks(ALL_GREEKS, MIXED_PRECISION)", prepare_batch, [](size_t) {
+        BatchPricer(nullptr, BATCH_CHUNK, MIXED_PRECISION).PriceAndGreeks(batch, ALL_GREEKS, greeks);
+        Keep(greeks.Gamma().back());
+    }, false, check_mixed_batch});
+
+    // size points: up to 8 volatilities by a spot mesh, the prices checked against the double grid point by point
+    auto grid_axes = [](size_t size) {
+        size_t rows = gcd(size, size_t(8));
+        return vector<GridAxis>{GridAxis(SIGMA, MeshView::Linear(0.05, 0.8, rows)), GridAxis(UNDERLYING, MeshView::Linear(50, 150, size / rows))};
+    };
+
+    cases.push_back({"Price(grid SIGMA x UNDERLYING, MIXED_PRECISION)",
+                     [](size_t size) { mesh_output.resize(size); },
+                     [reference, grid_axes](size_t size) {
+                         reference.Price(grid_axes(size), mesh_output.data(), MIXED_PRECISION);
+                         Keep(mesh_output.back());
+                     },
+                     false,
+                     [reference, grid_axes](size_t size) -> string {
+                         vector<GridAxis> axes = grid_axes(size);
+                         vector<double> mixed = reference.Price(axes, MIXED_PRECISION);
+                         vector<double> exact = reference.Price(axes, DOUBLE_PRECISION);
+                         MeshView spots = axes[1].Mesh();
+                         double carry = exp((reference.b() - reference.r()) * reference.T());
+                         double discounted_strike = reference.K() * exp(-reference.r() * reference.T());
+                         for (size_t index = 0; index < size; index++) {
+                             double bound = 2e-7 * (spots[index % spots.Size()] * carry + discounted_strike);
+                             string failure = CheckBound("grid price", index, mixed[index], exact[index], bound);
+                             if (!failure.empty()) return failure;
+                         }
+                         return "";
+                     }});
+
+    cases.push_back({"IncrementalPricer::UpdateSpotAndPrice", prepare_batch, [](size_t) {
+        static IncrementalPricer pricer;
+        static AlignedVector<double> spots;
+        static vector<double> prices;
+        if (pricer.Size() != batch.Size()) {
+            pricer = IncrementalPricer(batch);
+            spots.assign(batch.S(), batch.S() + batch.Size());
+            prices.resize(batch.Size());
+        }
+        pricer.UpdateSpotAndPrice(spots.data(), prices.data());
+        Keep(prices.back());
+    }, true});
+
+    cases.push_back({"ImpliedVolSolver::Solve", prepare_batch, [](size_t) {
+        Keep(ImpliedVolSolver().Solve(batch, batch_prices, status).back());
+    }});
+
+    cases.push_back({"BumpPricer::Compute(Richardson)", prepare_batch, [](size_t) {
+        static BumpPricer pricer(true);
+        static const vector<Bump> bumps{Bump::Central(UNDERLYING, 1e-2, true), Bump::Second(UNDERLYING, 1e-2, true), Bump::Central(SIGMA, 1e-2)};
+        Keep(pricer.Compute(batch, bumps).back());
+    }});
+
+    // The random book on two underlyings and a four-pillar curve, alternating long one and short two contracts
+    auto prepare_adjoint = [prepare_batch](size_t size) {
+        prepare_batch(size);
+        if (adjoint_book.Size() == batch.Size()) return;
+        adjoint_book = AdjointPricer({100, 50}, {0.25, 1, 2, 5}, {0.03, 0.035, 0.04, 0.045});
+        for (size_t index = 0; index < batch.Size(); index++) adjoint_book.Add(batch.Contract(index), index % 2, index % 3 ? 1.0 : -2.0);
+    };
+
+    // Adjoint results against the closed forms of each position repriced at its curve rate, and curve rho
+    // against a central bump-and-reprice of Value(). A delta error bound sums 3e-15 * |quantity| * e^((b-r)T) *
+    // (1 + 1/(s sqrt(T))) over the positions: the adjoint keeps the rounding of the n(d1) and n(d2) terms that
+    // cancel in the closed form. Gamma is a difference of bumped deltas, within 2e-4 of the gross gamma
+    auto check_adjoint = [](size_t) -> string {
+        PortfolioSensitivities sensitivities = adjoint_book.Sensitivities(true);
+        const vector<double>& spots = adjoint_book.Spots();
+        vector<double> delta(spots.size(), 0.0), delta_bound(spots.size(), 0.0), gamma(spots.size(), 0.0), gross_gamma(spots.size(), 0.0);
+        double gross_value = 0;
+        for (size_t index = 0; index < batch.Size(); index++) {
+            EuropeanOption contract = batch.Contract(index);
+            size_t underlying = index % 2;
+            double quantity = index % 3 ? 1.0 : -2.0;
+            double r = adjoint_book.Rate(contract.T());
+            EuropeanOption position(spots[underlying], contract.K(), contract.T(), r, contract.s(),
+                                    contract.CallOrPut(), contract.UnderlyingType(), contract.q(), contract.R());
+            double carry = exp((position.b() - r) * position.T());
+            delta[underlying] += quantity * position.Delta();
+            delta_bound[underlying] += 3e-15 * fabs(quantity) * carry * (1 + 1 / (position.s() * sqrt(position.T())));
+            gamma[underlying] += quantity * position.Gamma();
+            gross_gamma[underlying] += fabs(quantity * position.Gamma());
+            gross_value += fabs(quantity * position.Price());
+        }
+        for (size_t underlying = 0; underlying < spots.size(); underlying++) {
+            string failure = CheckBound("delta", underlying, sensitivities.delta[underlying], delta[underlying], delta_bound[underlying]);
+            if (failure.empty()) failure = CheckBound("gamma", underlying, sensitivities.gamma[underlying], gamma[underlying], 2e-4 * gross_gamma[underlying]);
+            if (!failure.empty()) return failure;
+        }
+        AdjointPricer bumped = adjoint_book;
+        vector<double> rates = adjoint_book.CurveRates();
+        const double h = 1e-6;
+        for (size_t pillar = 0; pillar < rates.size(); pillar++) {
+            vector<double> up(rates), down(rates);
+            up[pillar] += h;
+            down[pillar] -= h;
+            bumped.CurveRates(up);
+            double value_up = bumped.Value();
+            bumped.CurveRates(down);
+            double rho = (value_up - bumped.Value()) / (2 * h);
+            // Truncation of the central difference plus the rounding of the two values over 2h
+            string failure = CheckBound("curve rho", pillar, sensitivities.curve_rho[pillar], rho, 1e-6 * fabs(rho) + 1e-9 * gross_value);
+            if (!failure.empty()) return failure;
+        }
+        return "";
+    };
+
+    cases.push_back({"AdjointPricer::Sensitivities", prepare_adjoint, [](size_t) {
+        Keep(adjoint_book.Sensitivities().value);
+    }, false, check_adjoint});
+
+    cases.push_back({"AdjointPricer::Sensitivities(with gamma)", prepare_adjoint, [](size_t) {
+        Keep(adjoint_book.Sensitivities(true).gamma[0]);
+    }});
+
+    // Size counts simulated paths here, so ns_per_option is the time per path
+    cases.push_back({"MonteCarloOption::Simulate(per path)", [](size_t) {}, [](size_t size) {
+        static MonteCarloOption option(100, 105, 0.75, 0.04, 0.25, CALL, STOCK);
+        MonteCarloSettings settings;
+        settings.paths = size;
+        option.Settings(settings);
+        Keep(option.Simulate().price);
+    }});
+
+    // American puts and calls on 1000 step binomial trees, strikes of four expiries sharing their trees.
+    // About 150 us per option on one core, so sizes stop at 10^4
+    cases.push_back({"LatticePricer::Price(1000 steps)", [](size_t size) {
+        lattice_book.clear();
+        for (size_t index = 0; index < size; index++) {
+            lattice_book.emplace_back(100, 60 + 80.0 * index / size, 0.25 * (1 + index % 4), 0.04, 0.25,
+                                      index % 2 ? CALL : PUT, DIVIDEND, 0.02);
+        }
+    }, [](size_t) {
+        Keep(LatticePricer().Price(lattice_book).back());
+    }, false, nullptr, 10000});
+
+    // The same book on 400 x 200 Crank-Nicolson grids, early exercise by the penalty method.
+    // About 2 ms per option on one core, so sizes stop at 10^3
+    cases.push_back({"PdePricer::Price(400x200)", [](size_t size) {
+        pde_book.clear();
+        for (size_t index = 0; index < size; index++) {
+            pde_book.emplace_back(100, 60 + 80.0 * index / size, 0.25 * (1 + index % 4), 0.04, 0.25,
+                                  index % 2 ? CALL : PUT, DIVIDEND, 0.02);
+        }
+    }, [](size_t) {
+        Keep(PdePricer().Price(pde_book).back());
+    }, false, nullptr, 1000});
+
+    // Random book on 16 underlyings under 1000 joint spot, vol and rate scenarios. ns_per_option covers all of them,
+    // about 28 us per contract on one core, so sizes stop at 10^5
+    cases.push_back({"ScenarioPricer::Run(1000 scenarios)", [](size_t size) {
+        mt19937_64 generator(7);
+        normal_distribution<double> normal(0.0, 1.0);
+        scenario_pricer.Clear();
+        for (size_t index = 0; index < size; index++) scenario_pricer.Add(RandomOption(generator), index % 16, index % 3 ? 1.0 : -2.0);
+        if (scenario_set.scenarios) return;
+        scenario_set = ScenarioSet(16);
+        for (size_t scenario = 0; scenario < 1000; scenario++) {
+            vector<double> spot(16), vol(16), rate(16);
+            for (size_t u = 0; u < 16; u++) {
+                spot[u] = 0.02 * normal(generator);
+                vol[u] = 0.005 * normal(generator);
+                rate[u] = 0.001 * normal(generator);
+            }
+            scenario_set.Add(spot, vol, rate);
+        }
+    }, [](size_t) {
+        Keep(scenario_pricer.Run(scenario_set).var);
+    }, false, nullptr, 100000});
+
+    // Arbitrage-free chains of 100 strikes and 5 expiries per underlying, every check enabled
+    cases.push_back({"ArbitrageScanner::Scan(ALL_CHECKS)", [](size_t size) {
+        chain.Clear();
+        for (size_t row = 0; row < size; row += 100) {
+            double S = 100, T = 0.25 * (1 + (row / 100) % 5);
+            chain.AddExpiry(row / 500, S, T, 0.04, 0.02);
+            for (size_t index = 0; index < 100 && row + index < size; index++) {
+                double K = S * (0.5 + 0.01 * index);
+                chain.AddQuote(K, EuropeanOption(S, K, T, 0.04, 0.25, CALL, DIVIDEND, 0.02).Price(),
+                               EuropeanOption(S, K, T, 0.04, 0.25, PUT, DIVIDEND, 0.02).Price());
+            }
+        }
+    }, [](size_t) {
+        static ArbitrageScanner scanner;
+        static vector<ArbitrageViolation> violations;
+        scanner.Scan(chain, violations);
+        Keep(static_cast<double>(violations.size()));
+    }});
+
+    // Book on 64 underlyings priced against a fresh snapshot of a shared store on every run
+    cases.push_back({"MarketBook::Price(snapshot)", [](size_t size) {
+        mt19937_64 generator(11);
+        uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (size_t u = 0; u < 64; u++) {
+            MarketQuote quote;
+            quote.S = 50 + 100 * uniform(generator);
+            quote.s = 0.1 + 0.4 * uniform(generator);
+            quote.r = 0.04;
+            quote.b = 0.02;
+            market_store.Set(u, quote);
+        }
+        market_store.Publish();
+        market_book.Clear();
+        for (size_t index = 0; index < size; index++) {
+            market_book.Add(50 + 100 * uniform(generator), 0.1 + 2 * uniform(generator), index % 2 ? PUT : CALL, DIVIDEND, index % 64);
+        }
+        market_prices.resize(size);
+    }, [](size_t) {
+        Keep(static_cast<double>(market_book.Price(market_store, market_snapshot, market_prices.data())));
+    }, true});
+
+    return cases;
+}
+
+static BenchmarkResult Measure(const BenchmarkCase& benchmark, size_t size, size_t threads, double min_seconds) {
+    /*
+     Run a case until min_seconds have elapsed (at least twice, the first run only warms up)
+     */
+
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.size = size;
+    result.threads = threads;
+    result.allocation_free = benchmark.allocation_free;
+
+    benchmark.prepare(size);
+    benchmark.run(size);
+
+    double total = 0;
+    double best = 0;
+
+    size_t allocations_before = allocations.load();
+
+    while (total < min_seconds || result.repetitions == 0) {
+
+        Clock::time_point start = Clock::now();
+
+        benchmark.run(size);
+
+        double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+        total += seconds;
+        best = result.repetitions == 0 || seconds < best ? seconds : best;
+        result.repetitions++;
+    }
+
+    result.allocations_per_run = double(allocations.load() - allocations_before) / result.repetitions;
+    result.ns_per_option = 1e9 * total / result.repetitions / size;
+    result.min_ns_per_option = 1e9 * best / size;
+
+    return result;
+}
+
+static string Escape(const string& text) {
+    string escaped;
+    for (char character: text) {
+        if (character == '"' || character == '\\') escaped += '\\';
+        escaped += character;
+    }
+    return escaped;
+}
+
+static void WriteJson(ostream& out, const vector<BenchmarkResult>& results) {
+    /*
+     One result object per line so files diff cleanly and are easy to compare
+     */
+
+    const char* simd[] = {"none", "sse2", "avx2", "avx512"};
+
+    out << "{\n";
+    out << "  \"project\": \"ExactPricingModels\",\n";
+    out << "  \"timestamp\": " << time(nullptr) << ",\n";
+    out << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n";
+    out << "  \"simd\": \"" << simd[ActiveSimdLevel()] << "\",\n";
+    out << "  \"results\": [\n";
+
+    for (size_t index = 0; index < results.size(); index++) {
+
+        const BenchmarkResult& result = results[index];
+
+        char numbers[320];
+        snprintf(numbers, sizeof(numbers),
+                 "\"size\": %zu, \"threads\": %zu, \"repetitions\": %zu, \"ns_per_option\": %.4f, \"min_ns_per_option\": %.4f, \"options_per_second\": %.0f, \"allocations_per_run\": %.2f",
+                 result.size, result.threads, result.repetitions, result.ns_per_option, result.min_ns_per_option,
+                 result.ns_per_option > 0 ? 1e9 / result.ns_per_option : 0, result.allocations_per_run);
+
+        out << "    {\"name\": \"" << Escape(result.name) << "\", " << numbers << "}" << (index + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n}\n";
+}
+
+static string Key(const string& name, size_t size, size_t threads) {
+    return name + "|" + to_string(size) + "|" + to_string(threads);
+}
+
+static map<string, double> ReadBaseline(const string& path) {
+    /*
+     ns_per_option of every result in a file written by WriteJson
+     */
+
+    ifstream in(path);
+
+    if (!in) throw runtime_error("cannot open baseline " + path);
+
+    map<string, double> baseline;
+    string line;
+
+    while (getline(in, line)) {
+
+        size_t name = line.find("{\"name\": \"");
+
+        if (name == string::npos) continue;
+
+        name += 10;
+
+        string unescaped;
+        size_t position = name;
+        for (; position < line.size() && line[position] != '"'; position++) {
+            if (line[position] == '\\') position++;
+            unescaped += line[position];
+        }
+
+        size_t size = 0, threads = 0;
+        double ns = 0;
+
+        if (sscanf(line.c_str() + position, "\", \"size\": %zu, \"threads\": %zu, \"repetitions\": %*u, \"ns_per_option\": %lf", &size, &threads, &ns) == 3) {
+            baseline[Key(unescaped, size, threads)] = ns;
+        }
+    }
+
+    return baseline;
+}
+
+static vector<size_t> ParseList(const char* text) {
+    vector<size_t> values;
+    stringstream list(text);
+    string item;
+    while (getline(list, item, ',')) values.push_back(static_cast<size_t>(stod(item)));
+    return values;
+}
+
+int main(int argc, const char * argv[]) {
+    /*
+     Measure every case over every size and thread count, write JSON, and optionally compare against
+     a previous run: cases more than --tolerance slower than the baseline are reported on stderr and
+     the exit code is 1. Heap allocations are counted for every case; a case marked allocation-free
+     that allocates on one thread also fails the run, and so does a case whose accuracy check fails
+     */
+
+    vector<size_t> sizes = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    vector<size_t> threads = {1};
+    double min_seconds = 0.2;
+    double tolerance = 0.10;
+    string filter;
+    string output_path;
+    string baseline_path;
+
+    if (thread::hardware_concurrency() > 1) threads.push_back(thread::hardware_concurrency());
+
+    for (int index = 1; index < argc; index++) {
+
+        string option = argv[index];
+        const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+        if (option == "-h" || option == "--help") {
+            cout << "usage: benchmark [--sizes 1,10,...] [--threads 1,4,...] [--min-time SECONDS] [--filter TEXT]\n"
+                    "                 [--output FILE] [--baseline FILE] [--tolerance FRACTION]\n";
+            return 0;
+        }
+
+        if (!value) {
+            cerr << "missing value for " << option << endl;
+            return 2;
+        }
+
+        if (option == "--sizes") sizes = ParseList(value);
+        else if (option == "--threads") threads = ParseList(value);
+        else if (option == "--min-time") min_seconds = stod(value);
+        else if (option == "--filter") filter = value;
+        else if (option == "--output") output_path = value;
+        else if (option == "--baseline") baseline_path = value;
+        else if (option == "--tolerance") tolerance = stod(value);
+        else {
+            cerr << "invalid argument: " << option << endl;
+            return 2;
+        }
+
+        index++;
+    }
+
+    vector<BenchmarkCase> cases = Cases();
+    vector<BenchmarkResult> results;
+    int inaccurate = 0; // Runs whose accuracy check failed
+
+    for (size_t thread_count: threads) {
+
+        ThreadPool::SetMaxThreads(thread_count);
+
+        for (const BenchmarkCase& benchmark: cases) {
+
+            if (!filter.empty() && benchmark.name.find(filter) == string::npos) continue;
+
+            for (size_t size: sizes) {
+
+                if (size == 0 || (benchmark.max_size && size > benchmark.max_size)) continue;
+
+                results.push_back(Measure(benchmark, size, thread_count, min_seconds));
+
+                const BenchmarkResult& result = results.back();
+
+                fprintf(stderr, "%-42s size %9zu threads %3zu  %10.2f ns/option\n",
+                        result.name.c_str(), result.size, result.threads, result.ns_per_option);
+
+                string failure = benchmark.check ? benchmark.check(size) : "";
+
+                if (!failure.empty()) {
+                    fprintf(stderr, "ACCURACY %-42s size %9zu threads %3zu  %s\n",
+                            result.name.c_str(), result.size, result.threads, failure.c_str());
+                    inaccurate++;
+                }
+            }
+        }
+    }
+
+    ThreadPool::SetMaxThreads(0);
+
+    if (output_path.empty()) {
+        WriteJson(cout, results);
+    } else {
+        ofstream out(output_path);
+        WriteJson(out, results);
+    }
+
+    // Allocation-free cases are only checked on one thread, where the pool runs every chunk inline
+    int allocating = 0;
+
+    for (const BenchmarkResult& result: results) {
+        if (result.allocation_free && result.threads == 1 && result.allocations_per_run > 0) {
+            fprintf(stderr, "ALLOCATION %-42s size %9zu threads %3zu  %10.2f allocations/run\n",
+                    result.name.c_str(), result.size, result.threads, result.allocations_per_run);
+            allocating++;
+        }
+    }
+
+    if (baseline_path.empty()) return allocating > 0 || inaccurate > 0 ? 1 : 0;
+
+    map<string, double> baseline = ReadBaseline(baseline_path);
+
+    int regressions = 0;
+
+    for (const BenchmarkResult& result: results) {
+
+        auto found = baseline.find(Key(result.name, result.size, result.threads));
+
+        if (found == baseline.end() || found->second <= 0) continue;
+
+        double change = result.ns_per_option / found->second - 1;
+
+        if (change > tolerance) {
+            fprintf(stderr, "REGRESSION %-42s size %9zu threads %3zu  %10.2f -> %10.2f ns/option (%+.1f%%)\n",
+                    result.name.c_str(), result.size, result.threads, found->second, result.ns_per_option, 100 * change);
+            regressions++;
+        }
+    }
+
+    fprintf(stderr, "%d regression(s) against %s\n", regressions, baseline_path.c_str());
+
+    return regressions > 0 || allocating > 0 || inaccurate > 0 ? 1 : 0;
+}
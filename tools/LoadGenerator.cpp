@@ -0,0 +1,359 @@
+//
+//  File: LoadGenerator.cpp
+//  Project: ExactPricingModels
+//  Objective: Latency against throughput of a running PricingServer
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+//  Built by the load_generator target of CMakeLists.txt, from the repository root:
+//      cmake -S . -B build && cmake --build build --target load_generator
+//
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "PricingServer.hpp"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+const size_t SEND_TIMES = 1 << 18; // Send times remembered per client, indexed by request id modulo this size
+
+struct LoadSettings {
+    string socket_path = "/tmp/pricing.sock"; // Unix domain socket
+    long port = -1; // TCP port on 127.0.0.1 instead, when >= 0
+    size_t clients = 4; // Connections, each with a sending and a receiving thread
+    size_t contracts = 8; // Contracts per request
+    unsigned mask = GREEK_PRICE; // Outputs requested
+    double seconds = 2; // Duration of each load level
+};
+
+struct LoadResult {
+    double rate = 0; // Offered requests/s, 0 for closed loop
+    size_t requests = 0; // Replies received
+    size_t errors = 0; // Replies with an error status
+    double seconds = 0; // First send to last reply
+    vector<double> latencies; // Microseconds, from the scheduled send time to the reply
+};
+
+static int Connect(const LoadSettings& settings) {
+    /*
+     Open a blocking connection to the daemon
+     */
+
+    int fd;
+
+    if (settings.port >= 0) {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(settings.port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        int one = 1;
+        if (fd >= 0) setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    } else {
+        sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, settings.socket_path.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    if (fd < 0) throw runtime_error(string("cannot connect: ") + strerror(errno));
+
+    return fd;
+}
+
+static bool SendAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+static bool ReceiveAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t received = recv(fd, data, size, 0);
+        if (received <= 0) return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+static vector<char> RandomRequest(const LoadSettings& settings, size_t seed) {
+    /*
+     One request frame with random contracts, reused for every send of a client
+     */
+
+    mt19937_64 generator(seed);
+    uniform_real_distribution<double> uniform(0, 1);
+
+    vector<char> request(sizeof(PricingFrame) + settings.contracts * sizeof(ContractRecord));
+
+    PricingFrame frame = {PRICING_MAGIC, settings.mask, static_cast<uint32_t>(settings.contracts), 0, 0};
+    memcpy(request.data(), &frame, sizeof(frame));
+
+    for (size_t index = 0; index < settings.contracts; index++) {
+        ContractRecord record = {80 + 40 * uniform(generator), 100, 0.05 + 2 * uniform(generator), 0.05 * uniform(generator),
+                                 0.1 + 0.4 * uniform(generator), 0.02 * uniform(generator), 0.02 * uniform(generator),
+                                 static_cast<uint8_t>(index % 2), static_cast<uint8_t>(index % 4), {0, 0, 0, 0, 0, 0}};
+        memcpy(request.data() + sizeof(PricingFrame) + index * sizeof(ContractRecord), &record, sizeof(record));
+    }
+
+    return request;
+}
+
+static LoadResult RunLevel(const LoadSettings& settings, double rate) {
+    /*
+     Drive the daemon for settings.seconds. With rate > 0 every client sends on a fixed schedule
+     (open loop) and latency is measured from the scheduled time, so a stalled server is charged
+     for the requests it delayed; with rate 0 each client keeps exactly one request in flight
+     */
+
+    LoadResult result;
+    result.rate = rate;
+
+    size_t clients = settings.clients;
+    vector<vector<double>> latencies(clients);
+    vector<size_t> errors(clients, 0);
+    vector<Clock::time_point> last_reply(clients);
+    vector<thread> threads;
+
+    vector<int> fds;
+
+    for (size_t client = 0; client < clients; client++) fds.push_back(Connect(settings));
+
+    Clock::time_point start = Clock::now() + chrono::milliseconds(10);
+    Clock::time_point end = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(settings.seconds));
+
+    for (size_t client = 0; client < clients; client++) {
+
+        threads.emplace_back([&, client] {
+
+            int fd = fds[client];
+
+            vector<char> request = RandomRequest(settings, client + 1);
+            vector<atomic<int64_t>> sent_at(SEND_TIMES);
+            atomic<uint64_t> received(0);
+            atomic<bool> failed(false);
+            counting_semaphore<> in_flight(1);
+            uint64_t sent = 0;
+
+            size_t reply_size = sizeof(PricingFrame) + settings.contracts * __builtin_popcount(settings.mask) * sizeof(double);
+
+            thread receiver([&] {
+
+                vector<char> reply(reply_size);
+
+                while (true) {
+
+                    PricingFrame frame;
+
+                    if (!ReceiveAll(fd, reinterpret_cast<char*>(&frame), sizeof(frame))) break;
+
+                    if (frame.status != PRICING_OK) {
+                        errors[client]++;
+                    } else if (!ReceiveAll(fd, reply.data(), reply_size - sizeof(frame))) {
+                        break;
+                    }
+
+                    Clock::time_point now = Clock::now();
+                    int64_t scheduled = sent_at[frame.id % SEND_TIMES].load(memory_order_acquire);
+
+                    latencies[client].push_back(chrono::duration<double, micro>(now.time_since_epoch()).count() - scheduled / 1e3);
+                    last_reply[client] = now;
+                    received++;
+
+                    if (rate == 0) in_flight.release();
+                }
+
+                // Closed by the sender once every reply arrived, or lost: unblock a waiting sender
+                failed = true;
+                in_flight.release();
+            });
+
+            double interval = rate > 0 ? clients / rate : 0;
+
+            this_thread::sleep_until(start);
+
+            for (uint64_t id = 0; !failed; id++) {
+
+                Clock::time_point scheduled = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(id * interval));
+
+                if (rate > 0) {
+                    this_thread::sleep_until(scheduled);
+                } else {
+                    in_flight.acquire();
+                    scheduled = Clock::now();
+                }
+
+                if (scheduled >= end || failed) break;
+
+                PricingFrame* frame = reinterpret_cast<PricingFrame*>(request.data());
+                frame->id = id;
+
+                sent_at[id % SEND_TIMES].store(chrono::duration_cast<chrono::nanoseconds>(scheduled.time_since_epoch()).count(), memory_order_release);
+                sent++;
+
+                if (!SendAll(fd, request.data(), request.size())) break;
+            }
+
+            // Wait for the replies in flight, then wake the receiver out of recv
+            while (!failed && received < sent) this_thread::sleep_for(chrono::microseconds(100));
+
+            shutdown(fd, SHUT_RDWR);
+            receiver.join();
+            close(fd);
+        });
+    }
+
+    for (thread& client: threads) client.join();
+
+    Clock::time_point finish = start;
+
+    for (size_t client = 0; client < clients; client++) {
+        result.latencies.insert(result.latencies.end(), latencies[client].begin(), latencies[client].end());
+        result.errors += errors[client];
+        finish = max(finish, last_reply[client]);
+    }
+
+    result.requests = result.latencies.size();
+    result.seconds = chrono::duration<double>(finish - start).count();
+
+    sort(result.latencies.begin(), result.latencies.end());
+
+    return result;
+}
+
+static double Percentile(const vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+static vector<double> ParseList(const char* text) {
+    vector<double> values;
+    string list(text);
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == string::npos) comma = list.size();
+        values.push_back(strtod(list.substr(start, comma - start).c_str(), nullptr));
+        start = comma + 1;
+    }
+    return values;
+}
+
+static void Usage(ostream& out) {
+    out << "usage: load_generator [options]\n"
+           "  --socket PATH          daemon Unix domain socket (default /tmp/pricing.sock)\n"
+           "  --port N               daemon on 127.0.0.1:N instead\n"
+           "  --clients N            connections (default 4)\n"
+           "  --contracts N          contracts per request (default 8)\n"
+           "  --rates LIST           offered requests/s over all clients, 0 for closed loop (default 0)\n"
+           "  --duration SECONDS     time per rate (default 2)\n"
+           "  --all-greeks           request every output instead of the price\n";
+}
+
+int main(int argc, const char * argv[]) {
+    /*
+     Measure p50/p99/p99.9 reply latency and achieved throughput at each offered rate
+     */
+
+    LoadSettings settings;
+    vector<double> rates{0};
+
+    for (int index = 1; index < argc; index++) {
+
+        const char* option = argv[index];
+        const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+
+        if (!strcmp(option, "-h") || !strcmp(option, "--help")) {
+            Usage(cout);
+            return 0;
+        } else if (!strcmp(option, "--all-greeks")) {
+            settings.mask = ALL_GREEKS;
+            continue;
+        } else if (!value) {
+            cerr << "invalid argument: " << option << endl;
+            Usage(cerr);
+            return 2;
+        } else if (!strcmp(option, "--socket")) {
+            settings.socket_path = value;
+        } else if (!strcmp(option, "--port")) {
+            settings.port = strtol(value, nullptr, 10);
+        } else if (!strcmp(option, "--clients")) {
+            settings.clients = max<size_t>(1, strtoul(value, nullptr, 10));
+        } else if (!strcmp(option, "--contracts")) {
+            settings.contracts = min<size_t>(max<size_t>(1, strtoul(value, nullptr, 10)), PRICING_MAX_CONTRACTS);
+        } else if (!strcmp(option, "--rates")) {
+            rates = ParseList(value);
+        } else if (!strcmp(option, "--duration")) {
+            settings.seconds = strtod(value, nullptr);
+        } else {
+            cerr << "invalid argument: " << option << endl;
+            Usage(cerr);
+            return 2;
+        }
+
+        index++;
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "%12s %12s %14s %10s %10s %10s %10s %8s\n",
+             "offered/s", "requests/s", "contracts/s", "p50 us", "p99 us", "p99.9 us", "max us", "errors");
+    cout << line;
+
+    try {
+        for (double rate: rates) {
+
+            LoadResult result = RunLevel(settings, rate);
+
+            double throughput = result.seconds > 0 ? result.requests / result.seconds : 0;
+
+            snprintf(line, sizeof(line), "%12s %12.0f %14.0f %10.1f %10.1f %10.1f %10.1f %8zu\n",
+                     rate > 0 ? to_string(static_cast<long>(rate)).c_str() : "closed", throughput, throughput * settings.contracts,
+                     Percentile(result.latencies, 0.5), Percentile(result.latencies, 0.99), Percentile(result.latencies, 0.999),
+                     result.latencies.empty() ? 0 : result.latencies.back(), result.errors);
+            cout << line << flush;
+        }
+    } catch (const exception& error) {
+        cerr << "error: " << error.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+//
+//  File: PricingDaemon.cpp
+//  Project: ExactPricingModels
+//  Objective: Command-line front end of PricingServer
+//
+//  Created by Aldo Aguilar on 15/10/26.
+//
+//  Built by the pricing_daemon target of CMakeLists.txt, with metrics compiled in, from the repository root:
+//      cmake -S . -B build && cmake --build build --target pricing_daemon
+//
+
+#include <iostream>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+
+#include "PricingServer.hpp"
+#include "Metrics.hpp"
+
+using namespace std;
+
+static PricingServer* running_server = nullptr; // Stopped by the signal handler
+
+static void StopServer(int) {
+    if (running_server) running_server->Stop();
+}
+
+static void Usage(ostream& out) {
+    out << "usage: pricing_daemon [options]\n"
+           "  --socket PATH          listen on a Unix domain socket (default /tmp/pricing.sock)\n"
+           "  --port N               listen on 127.0.0.1:N instead\n"
+           "  --max-wait US          microseconds a request waits for others to join its batch (default 50)\n"
+           "  --max-batch N          contracts per kernel call (default 4096)\n"
+           "  --threads N            pricing threads for large batches, 0 for every hardware thread (default 0)\n"
+           "  --metrics PATH         write Prometheus metrics to PATH on SIGUSR1 and on exit\n"
+           "  -q, --quiet            do not print the counters on exit\n"
+           "\n"
+           "Requests and replies are PricingFrame headers followed by ContractRecords or result rows,\n"
+           "see PricingServer.hpp. SIGINT or SIGTERM stops the daemon. --metrics needs a build with\n"
+           "-DEXACT_PRICING_METRICS to report more than the uptime\n";
+}
+
+int main(int argc, const char * argv[]) {
+    /*
+     Serve pricing requests until SIGINT or SIGTERM, then print the batching counters to stderr
+     */
+
+    PricingServer server;
+
+    const char* socket_path = "/tmp/pricing.sock";
+    const char* metrics_path = nullptr;
+    long port = -1;
+    bool quiet = false;
+
+    for (int index = 1; index < argc; index++) {
+
+        const char* option = argv[index];
+        const char* value = index + 1 < argc ? argv[index + 1] : nullptr;
+        bool valid = true;
+
+        if (!strcmp(option, "-h") || !strcmp(option, "--help")) {
+            Usage(cout);
+            return 0;
+        } else if (!strcmp(option, "-q") || !strcmp(option, "--quiet")) {
+            quiet = true;
+            continue;
+        } else if (!value) {
+            valid = false;
+        } else if (!strcmp(option, "--socket")) {
+            socket_path = value;
+        } else if (!strcmp(option, "--port")) {
+            port = strtol(value, nullptr, 10);
+            valid = port >= 0 && port <= 65535;
+        } else if (!strcmp(option, "--max-wait")) {
+            server.MaxWait(static_cast<unsigned>(strtoul(value, nullptr, 10)));
+        } else if (!strcmp(option, "--max-batch")) {
+            server.MaxBatch(strtoul(value, nullptr, 10));
+        } else if (!strcmp(option, "--metrics")) {
+            metrics_path = value;
+        } else if (!strcmp(option, "--threads")) {
+            ThreadPool::SetMaxThreads(strtoul(value, nullptr, 10));
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            cerr << "invalid argument: " << option << endl;
+            Usage(cerr);
+            return 2;
+        }
+
+        index++;
+    }
+
+    try {
+        if (port >= 0) server.ListenTcp(static_cast<uint16_t>(port));
+        else server.ListenUnix(socket_path);
+
+        if (metrics_path) DumpMetricsOnSignal(SIGUSR1, metrics_path, PROMETHEUS_METRICS);
+
+        running_server = &server;
+        signal(SIGINT, StopServer);
+        signal(SIGTERM, StopServer);
+        signal(SIGPIPE, SIG_IGN);
+
+        server.Run();
+
+        running_server = nullptr;
+
+        if (metrics_path) WriteMetrics(metrics_path, PROMETHEUS_METRICS);
+    } catch (const exception& error) {
+        cerr << "error: " << error.what() << endl;
+        return 1;
+    }
+
+    if (!quiet) server.Stats().Print(cerr);
+
+    return 0;
+}